@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+
+// How quickly the player answers each kind of call, per pet, saved with
+// it. Updated only when a call ends, each in O(1): an exponentially
+// weighted mean of the answer time, a histogram of answer times in fixed
+// buckets, lifetime counts, and the last CARE_RECENT outcomes as bits for
+// a rolling miss rate. Plain fixed-width data, so host tools can read it
+// without the firmware headers.
+//
+// A call is missed when it ends without an answer in a way the game
+// holds against the player: hunger and unhappy calls when their care
+// window runs out (exactly the care mistakes), the poop when it makes
+// the pet sick, sickness when the pet dies of it. Discipline and the
+// light have no care window, so they are missed when bedtime, morning,
+// an evolution or death ends them. A hunger or unhappy call that bedtime,
+// an evolution or death takes away is forgiven, as by the game, and is
+// not counted at all.
+constexpr uint8_t CARE_KINDS        = 6;   // AttentionType HUNGRY..SLEEP, in that order
+constexpr uint8_t CARE_BUCKETS      = 8;
+constexpr uint8_t CARE_RECENT       = 16;  // outcomes in the rolling miss rate
+constexpr uint8_t CARE_EWMA_SHIFT   = 3;   // each answer weighs 1/8
+
+// Upper edge of each histogram bucket, seconds; the last bucket is open
+constexpr uint16_t CARE_BUCKET_EDGE_S[CARE_BUCKETS - 1] = {30, 60, 120, 300, 600, 900, 1800};
+
+struct CareKindStats {
+    uint32_t ewmaMs      = 0;  // 0 until the first answer
+    uint16_t hist[CARE_BUCKETS] = {};
+    uint16_t answered    = 0;  // counts saturate
+    uint16_t missed      = 0;
+    uint16_t recent      = 0;  // bit 0 newest; 1 = missed
+    uint8_t  recentCount = 0;
+
+    void answer(uint32_t ms) {
+        ewmaMs = answered == 0 ? ms
+                               : (uint32_t)((int64_t)ewmaMs + ((int64_t)ms - ewmaMs) / (1 << CARE_EWMA_SHIFT));
+        uint8_t b = 0;
+        while (b < CARE_BUCKETS - 1 && ms >= CARE_BUCKET_EDGE_S[b] * 1000UL) b++;
+        bump(hist[b]);
+        bump(answered);
+        push(false);
+    }
+    void miss() {
+        bump(missed);
+        push(true);
+    }
+
+    // Misses among the last recentOutcomes(), Q15 (0 when there are none)
+    uint16_t recentMissQ15() const {
+        if (recentCount == 0) return 0;
+        uint8_t n = 0;
+        for (uint16_t bits = recent; bits; bits &= bits - 1) n++;
+        return (uint16_t)(((uint32_t)n << 15) / recentCount);
+    }
+    uint8_t recentOutcomes() const { return recentCount; }
+
+private:
+    static void bump(uint16_t& n) {
+        if (n != UINT16_MAX) n++;
+    }
+    void push(bool missedIt) {
+        recent = (uint16_t)(recent << 1 | (missedIt ? 1 : 0));
+        if (recentCount < CARE_RECENT) recentCount++;
+    }
+};
+
+struct CareStats {
+    CareKindStats kind[CARE_KINDS];
+    uint8_t       timing = 0;  // bit per kind: a poop or sickness being timed (no pendingAttention)
+};
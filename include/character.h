@@ -44,6 +44,18 @@ struct CharacterDef {
     uint8_t       happyDecayMul;
 };
 
+// What the evolution rules may look at
+struct EvoFacts {
+    uint8_t  careMistakes;       // this stage
+    uint8_t  discipline;         // percent
+    uint16_t totalCareMistakes;
+    uint16_t age;                // hours
+};
+
 const CharacterDef& getCharacterDef(CharacterID id);
-CharacterID resolveEvolution(CharacterID current, uint8_t careMistakes, uint8_t disciplinePct);
-bool isSecretEligible(uint16_t totalCareMistakes, CharacterID currentChar, uint16_t age);
+// Next stage's character, or NONE if this character does not grow further
+CharacterID resolveEvolution(CharacterID current, const EvoFacts& facts);
+// Same-stage secret form the facts qualify for, or NONE
+CharacterID resolveSecretEvolution(CharacterID current, const EvoFacts& facts);
+// The one character that evolves into id, or NONE for the egg
+CharacterID evolutionParent(CharacterID id);
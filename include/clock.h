@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+
+// Source of game time. Everything the pet lives by (timers, day/night)
+// reads this instead of millis()/RTC directly, so a whole life can run
+// faster than real time:
+//   RealClock     millis() + RTC
+//   ScaledClock   another clock sped up by a constant factor (x1000 debug)
+//   VirtualClock  advanced explicitly by the caller (headless / step mode)
+// Hardware and presentation timing (backlight, autosave, frame pacing,
+// animations) stays on millis().
+class Clock {
+public:
+    virtual ~Clock() = default;
+    virtual unsigned long nowMs() = 0;  // monotonic, wraps like millis()
+    virtual uint32_t wallSeconds() = 0; // local time, seconds since 1970; 0 if unknown
+    // Real time it takes for gameMs to pass (for parking the CPU)
+    virtual unsigned long realMs(unsigned long gameMs) const { return gameMs; }
+
+    // Fall back to a noon start when there is no wall time
+    uint8_t hour();
+    uint8_t minute();
+    unsigned long msUntilNextMinute();
+};
+
+class RealClock : public Clock {
+public:
+    unsigned long nowMs() override;
+    uint32_t wallSeconds() override;
+};
+
+class ScaledClock : public Clock {
+public:
+    ScaledClock(Clock& base, uint32_t factor) : _base(base), _factor(factor) {}
+    unsigned long nowMs() override;
+    uint32_t wallSeconds() override;
+    unsigned long realMs(unsigned long gameMs) const override { return gameMs / _factor; }
+
+private:
+    Clock&        _base;
+    uint32_t      _factor;
+    bool          _started   = false;
+    unsigned long _startMs   = 0;  // base time when first read
+    uint32_t      _startWall = 0;
+
+    void start();
+};
+
+class VirtualClock : public Clock {
+public:
+    explicit VirtualClock(uint32_t startWall = 0) : _startWall(startWall) {}
+    unsigned long nowMs() override { return _ms; }
+    uint32_t wallSeconds() override;
+    unsigned long realMs(unsigned long) const override { return 0; }
+
+    void advance(unsigned long ms) { _ms += ms; }
+
+private:
+    unsigned long _ms = 0;
+    uint32_t      _startWall;
+};
+
+// Shared default for modules that are not given a clock
+Clock& realClock();
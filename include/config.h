@@ -9,8 +9,8 @@ constexpr int SCREEN_H = 240;
 constexpr int ICON_ROW_Y   = 4;
 constexpr int ICON_SIZE    = 24;
 constexpr int ICON_GAP     = 16;
-constexpr int ICON_COUNT   = 7;
-constexpr int ICON_START_X = 28;  // (320 - 7*24 - 6*16) / 2
+constexpr int ICON_COUNT   = 8;
+constexpr int ICON_START_X = 8;   // (320 - 8*24 - 7*16) / 2
 constexpr int ICON_STEP    = 40;  // 24 + 16
 
 // Pet viewport
@@ -27,6 +27,15 @@ constexpr int STATUS_BAR_H = 36;
 constexpr int SPRITE_W = 48;
 constexpr int SPRITE_H = 48;
 
+// Decoded sprite cache (foreground runs per row), shared by every pet on screen
+constexpr int SPRITE_CACHE_SLOTS = 6;    // 4 pets + egg/ghost without thrashing
+constexpr int SPRITE_MAX_RUNS    = 128;  // busiest (ghost) has 104; more falls back to bits
+
+// Pet select: 2x2 tiles, one per save slot
+constexpr int TILE_TOP = 26;
+constexpr int TILE_W   = SCREEN_W / 2;
+constexpr int TILE_H   = 100;
+
 // ========== Game Timing (milliseconds) ==========
 constexpr unsigned long EGG_HATCH_MS          = 10UL * 1000;          // 10 sec
 constexpr unsigned long BABY_EVOLVE_MS        = 65UL * 60 * 1000;    // 65 min
@@ -35,6 +44,8 @@ constexpr unsigned long TEEN_EVOLVE_AGE       = 6;
 constexpr unsigned long SECRET_EVOLVE_AGE     = 10;
 constexpr unsigned long CARE_WINDOW_MS        = 15UL * 60 * 1000;    // 15 min
 constexpr unsigned long DISCIPLINE_INTERVAL_MS= 3UL * 60 * 60 * 1000;// ~3 hours
+constexpr uint8_t DISCIPLINE_CALL_ONE_IN      = 3;   // one check in N calls for discipline
+constexpr uint8_t SECRET_EVOLVE_TENTHS        = 2;   // chance per awake age tick, eligible adults
 
 // Stat decay base intervals
 constexpr unsigned long HUNGER_DECAY_MS       = 60UL * 60 * 1000;    // 1 heart/hour
@@ -57,14 +68,72 @@ constexpr uint8_t MEAL_WEIGHT    = 1;
 constexpr uint8_t SNACK_WEIGHT   = 2;
 constexpr uint8_t GAME_WEIGHT    = 1;
 
+// ========== Multi-pet ==========
+constexpr uint8_t MAX_PETS = 4;
+constexpr unsigned long PET_BG_BUDGET_US = 2000;  // per loop for stepping the inactive pets
+
 // ========== Save Data ==========
 constexpr const char* NVS_NAMESPACE = "stagotchi";
 constexpr uint32_t SAVE_MAGIC      = 0x53544147;  // "STAG"
-constexpr uint8_t  SAVE_VERSION    = 1;
+constexpr uint8_t  SAVE_VERSION    = 4;  // v2: PetData.rng, v3: lastForm/diedMs, v4: care stats
+constexpr uint32_t OFFLINE_CATCHUP_MAX_S = 30UL * 24 * 3600;  // old age ends any pet by day 7
+
+// ========== Event Journal ==========
+constexpr const char* JOURNAL_PATH = "/littlefs/journal.bin";  // LittleFS via stdio
+constexpr size_t JOURNAL_RING_BYTES     = 4096;         // RAM buffer between flushes
+constexpr size_t JOURNAL_FLUSH_BYTES    = 1024;         // batch size written to flash
+constexpr size_t JOURNAL_MAX_FILE_BYTES = 256UL * 1024; // then moved to .old and restarted
+
+// ========== Input Tape ==========
+constexpr const char* TAPE_PATH      = "/littlefs/tape.bin";  // device recordings
+constexpr const char* TAPE_NVS_NAMESPACE = "tape";            // "record from next boot" flag
+constexpr size_t TAPE_BUFFER_BYTES   = 512;                   // frames batched per write
+constexpr size_t TAPE_MAX_BYTES      = 512UL * 1024;          // recording stops here
+constexpr uint32_t TAPE_CHECK_FRAMES = 256;                   // state hash every N loops
+
+// ========== Graveyard ==========
+constexpr const char* GRAVEYARD_PATH = "/littlefs/graves.bin";  // index beside it (.idx)
+constexpr uint8_t GRAVE_PAGE_ROWS = 4;  // lives per page on the graveyard screen
+
+// ========== Stat History ==========
+constexpr const char* HISTORY_NVS_NAMESPACE = "history";
+constexpr uint16_t HISTORY_MINUTES = 180;  // per-minute samples (3 hours)
+constexpr uint16_t HISTORY_HOURS   = 168;  // hourly means (7 days)
+constexpr uint16_t HISTORY_DAYS    = 31;   // daily means
+constexpr unsigned long HISTORY_SAVE_INTERVAL_MS = 10UL * 60 * 1000;  // flash wear: real time
+constexpr uint8_t  SPARK_POINTS    = 64;   // LTTB target per sparkline
+
+// ========== Evolution Odds ==========
+// The player the stat screen's odds assume (percent) until this pet has
+// PREDICT_MIN_CALLS recent outcomes of that kind to measure instead
+constexpr uint8_t PREDICT_MISS_CARE_PCT   = 10;  // hunger/unhappy calls left to run out
+constexpr uint8_t PREDICT_ANSWER_DISC_PCT = 80;  // discipline calls answered
+constexpr uint8_t PREDICT_MIN_CALLS       = 4;
 
 // ========== Autosave ==========
 constexpr unsigned long AUTOSAVE_INTERVAL_MS = 60000;  // 60 sec
 
+// ========== Display Power ==========
+constexpr uint8_t DISPLAY_BRIGHTNESS   = 200;
+constexpr uint8_t DIM_BRIGHTNESS       = 60;
+constexpr uint8_t AMBIENT_BRIGHTNESS   = 16;
+constexpr unsigned long DIM_AFTER_MS        = 30UL * 1000;      // idle -> dim backlight
+constexpr unsigned long SCREEN_OFF_AFTER_MS = 2UL * 60 * 1000;  // lights-out ambient -> panel off
+constexpr uint16_t BRIGHTNESS_RAMP_UP   = 800;  // levels per second
+constexpr uint16_t BRIGHTNESS_RAMP_DOWN = 150;
+constexpr unsigned long POWER_LOG_INTERVAL_MS = 60UL * 1000;
+constexpr unsigned long AMBIENT_IDLE_MS = 5UL * 60 * 1000;  // no input -> ambient clock
+constexpr unsigned long AMBIENT_SLEEP_DELAY_MS = 10UL * 1000; // lights off -> ambient clock
+constexpr int TOUCH_INT_PIN            = 39;  // Core2 FT6336U INT, wakes light sleep
+
+// Ambient clock layout: HH:MM centred, small pet glyph below
+constexpr int AMBIENT_DIGIT_W = 40;
+constexpr int AMBIENT_DIGIT_H = 56;
+constexpr int AMBIENT_COLON_W = 20;
+constexpr int AMBIENT_CLOCK_X = (SCREEN_W - 4 * AMBIENT_DIGIT_W - AMBIENT_COLON_W) / 2;
+constexpr int AMBIENT_CLOCK_Y = 64;
+constexpr int AMBIENT_GLYPH_Y = 150;  // 24x24 (sprite at half scale)
+
 // ========== Colors (RGB565) ==========
 constexpr uint16_t COL_BG        = 0xCE59;  // light greenish (Tamagotchi LCD feel)
 constexpr uint16_t COL_PET_BG    = 0xD6BA;  // pet area background
@@ -79,3 +148,4 @@ constexpr uint16_t COL_HEART     = 0xF800;  // red
 constexpr uint16_t COL_HEART_E   = 0x8410;  // empty heart gray
 constexpr uint16_t COL_POOP      = 0x8200;  // brown
 constexpr uint16_t COL_SICK      = 0x780F;  // purple
+constexpr uint16_t COL_AMBIENT   = 0x4208;  // dim gray on black
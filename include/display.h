@@ -1,14 +1,35 @@
 #pragma once
 #include <M5Unified.h>
 #include <M5GFX.h>
+#include "config.h"
 #include "character.h"
 #include "pet.h"
 #include "menu.h"
+#include "clock.h"
+#include "history.h"
+#include "predictor.h"
+#include "graveyard_format.h"
+
+// Observer for every flushed frame (8-bit RGB332 canvas, row-major)
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+    virtual void onFrame(const uint8_t* pixels, int w, int h) = 0;
+};
 
 class DisplayManager {
 public:
+    static constexpr int MAX_FRAME_SINKS = 4;
+
     void init();
+    void setClock(Clock* clock) { _clock = clock; }        // game time (forecast)
+    void setUiClock(Clock* clock) { _uiClock = clock; }    // drives animations
     void flush();  // push canvas to screen
+    void flushRect(int x, int y, int w, int h);  // push only this region
+    bool addFrameSink(FrameSink* sink);
+
+    uint32_t pushCount() const { return _pushCount; }
+    uint32_t pushedPixels() const { return _pushedPixels; }
 
     void drawTitleScreen();
     void drawNewOrContinue(uint8_t selection);
@@ -16,26 +37,78 @@ public:
     void drawGameplay(const PetData& pet, const CharacterDef& charDef, uint8_t menuCursor);
     void drawGameplayNoFlush(const PetData& pet, const CharacterDef& charDef, uint8_t menuCursor);
     void drawFeedMenu(uint8_t subCursor);
-    void drawStatScreen(const PetData& pet, const CharacterDef& charDef);
+    // next: soonest forecast change for a countdown line (nullable);
+    // sparks: one per StatSeries over range (nullable); odds: where
+    // evolution leads, for a line under it (nullable)
+    void drawStatScreen(const PetData& pet, const CharacterDef& charDef, const NeedForecast* next,
+                        const Sparkline* sparks, StatRange range, const EvoOdds* odds);
+    // One row per call type: mean answer time, recent miss rate and a
+    // histogram of answer times
+    void drawCareStats(const CareStats& care);
     void drawEvolution(const char* fromName, const char* toName, float progress);
     void drawSleepScreen(const PetData& pet, const CharacterDef& charDef, bool lightOff);
     void drawDeathScreen(uint8_t cause);
+    // rows newest first, rows[0] being life number newest (0 oldest);
+    // best: the longest life (nullptr when there is none)
+    void drawGraveyard(const GraveIndex& index, const GraveRecord* best,
+                       const GraveRecord* rows, uint8_t rowCount, uint32_t newest);
     void drawMinigame(uint8_t round, uint8_t currentNum, uint8_t wins,
                       uint8_t lastResult, bool showResult);
+    // Redraws only digits/glyph that changed unless full is set
+    void drawAmbient(const PetData& pet, uint8_t hour, uint8_t minute, bool full);
+    // 2x2 tiles, pets[slot] nullptr for an empty slot (MAX_PETS entries).
+    // Repaints only tiles whose pet or selection changed unless full is set.
+    void drawPetSelect(const PetData* const* pets, uint8_t cursor, bool full);
+    // One dot per pet in the status bar (hidden with a single pet)
+    void setRosterBadge(uint8_t activeSlot, uint8_t usedMask, uint8_t callingMask);
 
 private:
+#ifdef STAGOTCHI_HOST
+    M5Canvas _canvas;  // no panel on host; frames reach the sinks only
+#else
     M5Canvas _canvas{&M5.Display};
+#endif
+    FrameSink* _sinks[MAX_FRAME_SINKS] = {};
+    uint8_t    _sinkCount = 0;
+    uint32_t   _pushCount = 0;
+    uint32_t   _pushedPixels = 0;
+    int8_t      _ambientDigits[4] = {-1, -1, -1, -1};
+    CharacterID _ambientGlyph = CharacterID::NONE;
     bool _blinkState = false;
     unsigned long _lastBlinkMs = 0;
+    Clock* _clock = &realClock();
+    Clock* _uiClock = &realClock();
+
+    // A sprite decoded to foreground runs per row, so drawing it is one
+    // fill and a few spans instead of a bit test and pixel per pixel.
+    // Shared by every pet on screen; the least recently used is replaced.
+    struct SpriteRuns {
+        const uint8_t* data = nullptr;  // key: bitmap and scale
+        uint8_t  shift   = 0;           // 0 full size, 1 half (every other pixel)
+        bool     ok      = false;       // false: too many runs, draw from the bits
+        uint32_t lastUse = 0;
+        uint8_t  rowEnd[SPRITE_H];          // runs[] index past each row's last run
+        uint8_t  runs[SPRITE_MAX_RUNS][2];  // x, length
+    };
+    SpriteRuns _sprites[SPRITE_CACHE_SLOTS];
+    uint32_t   _spriteUses = 0;
+
+    uint32_t _tileKeys[MAX_PETS] = {};
+    uint8_t  _badgeActive = 0, _badgeUsed = 0, _badgeCalling = 0;
 
+    const SpriteRuns& decodeSprite(const uint8_t* data, uint8_t shift);
+    void drawSpriteRuns(int x, int y, const SpriteRuns& spr, uint16_t fgColor, uint16_t bgColor);
+    void drawPetTile(uint8_t slot, const PetData* pet, bool selected);
     void drawSprite1bit(int x, int y, int w, int h, const uint8_t* data,
                         uint16_t fgColor, uint16_t bgColor);
     void drawMenuIcons(uint8_t cursor);
     void drawStatusBar(const PetData& pet);
     void drawHearts(int x, int y, uint8_t filled, uint8_t max, uint16_t color);
+    void drawSparkline(int x, int y, int w, int h, const Sparkline& spark);
     void drawPetSprite(int cx, int cy, CharacterID charId, uint16_t bgColor);
     void drawPoops(uint8_t count);
     void drawAttention(AttentionType type);
+    void notifySinks();
 
     // Font helpers
     void setFontSmall();   // ~12px Japanese
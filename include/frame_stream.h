@@ -0,0 +1,54 @@
+#pragma once
+#include "config.h"
+#include "display.h"
+#include <cstdint>
+
+// Streams the canvas over Serial as XOR/RLE row deltas (see tools/fbviewer.py).
+//
+// Wire format, one frame:
+//   A5 5A 'F'|'K' seq:u8 w:u16le h:u16le   ('K' = keyframe: viewer clears first)
+//   { row:u8  tokens... }*   row tokens cover exactly w pixels
+//   FF                       end of frame
+// Row tokens (applied to XOR of row against the previous sent row):
+//   00-7F  skip t+1 unchanged pixels
+//   80-BF  repeat next byte t-0x7F times
+//   C0-FF  t-0xBF literal bytes follow
+//
+// Encoding happens in pump() from the live canvas, a few rows at a time and
+// only while the UART has room, so loop() never blocks on a full TX buffer.
+class FrameStreamer : public FrameSink {
+public:
+    bool start();          // allocates the reference frame, next frame is a keyframe
+    void stop();
+    void requestKeyframe();
+    bool isActive() const { return _ref != nullptr; }
+
+    void onFrame(const uint8_t* pixels, int w, int h) override;
+    void pump();           // call once per loop()
+
+    uint32_t framesSent() const { return _framesSent; }
+    uint32_t bytesSent() const { return _bytesSent; }
+
+private:
+    static constexpr int TX_SIZE       = 1024;
+    static constexpr int MAX_ROW_BYTES = 1 + SCREEN_W * 3 / 2;  // worst case: alternating skip/literal
+
+    uint8_t* _ref    = nullptr;  // frame as last sent (what the viewer holds)
+    const uint8_t* _latest = nullptr;
+    int      _w = 0, _h = 0;
+    bool     _pending = false;
+    bool     _keyNext = false;
+    int      _row = -1;          // row being sent, -1 = between frames
+    uint8_t  _seq = 0;
+
+    uint8_t  _tx[TX_SIZE];
+    int      _txLen = 0;
+
+    uint32_t _framesSent = 0;
+    uint32_t _bytesSent  = 0;
+
+    int  txFree() const { return TX_SIZE - _txLen; }
+    void put(uint8_t b) { _tx[_txLen++] = b; }
+    void drainTx();
+    void encodeRow(int row);
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include "pet.h"
+#include "clock.h"
+#include "journal.h"
 #include <Preferences.h>
 
 enum class GameState : uint8_t {
@@ -13,22 +15,45 @@ enum class GameState : uint8_t {
     SLEEPING,
     STAT_SCREEN,
     DEATH_SCREEN,
+    AMBIENT,        // dim clock; returns to previous() on exit
+    PET_SELECT,     // one tile per save slot: switch pets or lay a new egg
+    GRAVEYARD,      // past lives, from the title screen
+    CARE_STATS,     // how fast calls get answered, after the stat screen
+};
+
+// One slot's save exactly as stored, so another save store can be made
+// to hold the same thing (the input tape carries the save it started from)
+struct RawSave {
+    uint8_t  version  = 0;  // SAVE_VERSION the pet was written with
+    PetData  pet;           // v1: rng as PetData() leaves it
+    uint32_t savedMs  = 0;
+    uint32_t savedRtc = 0;
 };
 
 class StateMachine {
 public:
     void init();
+    void setClock(Clock* clock) { _clock = clock; }
+    void setJournal(Journal* journal) { _journal = journal; }  // offline catch-up events
     void transition(GameState newState);
     GameState current() const { return _current; }
     GameState previous() const { return _previous; }
 
+    // Slot 0 keeps the single-pet keys, so older saves load as pet 1
     bool hasSaveData();
-    void saveGame(const PetData& pet);
-    bool loadGame(PetData& pet);
+    void saveGame(const PetData& pet, uint8_t slot = 0);
+    bool loadGame(PetData& pet, uint8_t slot = 0);
+    void clearSlot(uint8_t slot);
     void clearSave();
+    bool readRaw(uint8_t slot, RawSave& out);  // false: no save in this slot
+    void writeRaw(uint8_t slot, const RawSave& in);
 
 private:
     GameState _current  = GameState::TITLE_SCREEN;
     GameState _previous = GameState::TITLE_SCREEN;
     Preferences _prefs;
+    Clock* _clock = &realClock();  // save stamps share the pet's timebase
+    Journal* _journal = nullptr;
+
+    void resetTimers(PetData& pet, unsigned long now);
 };
@@ -0,0 +1,36 @@
+#pragma once
+#include "graveyard_format.h"
+#include "pet.h"
+
+// Every finished life, kept after the save slot is cleared (format in
+// graveyard_format.h). Records are fixed size, so "the last N" is N
+// seeks; the index keeps the best life and the counts per form and
+// cause, so those cost nothing. Files are opened per call: a burial is
+// one record and one small index write, and the screen reads a page.
+class Graveyard {
+public:
+    // Record log at path through stdio ("/littlefs/..." on the device);
+    // the index is path + ".idx". Brings the index up to date with the log.
+    bool open(const char* path);
+    bool isOpen() const { return _path[0] != '\0'; }
+
+    // Archives a dead pet. nowMs/wallNow: the game clock and RTC now
+    // (wallNow 0: unset), to date a death that happened while away.
+    bool bury(const PetData& pet, unsigned long nowMs, uint32_t wallNow);
+
+    uint32_t count() const { return _index.count; }
+    const GraveIndex& index() const { return _index; }
+    uint32_t countOf(CharacterID form) const { return _index.byForm[static_cast<uint8_t>(form)]; }
+    bool best(GraveRecord& out) const;
+    // Records first.. (0 oldest), up to max; a damaged one reads as a
+    // default record. Returns how many were read.
+    uint8_t read(uint32_t first, GraveRecord* out, uint8_t max) const;
+
+    static GraveRecord recordFor(const PetData& pet, unsigned long nowMs, uint32_t wallNow);
+
+private:
+    char       _path[96] = {};
+    GraveIndex _index;
+
+    bool writeIndex();
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "character.h"
+
+// On-disk format of the lifetime archive (see graveyard.h). Needs only
+// character.h, so host tools can read it without the firmware headers.
+//
+// <path>      fixed GRAVE_RECORD_BYTES records, append only; record n is
+//             at n * GRAVE_RECORD_BYTES, so any one is a single seek
+// <path>.idx  GraveIndex: totals that would otherwise take a scan. It is
+//             rewritten after each record, but the log is the truth: an
+//             index that is missing, damaged or behind is rebuilt from it.
+//
+// Record, little endian:
+//    0  u32  start     RTC seconds when the egg was laid (0: clock not set)
+//    4  u32  end       RTC seconds at death (0: clock not set)
+//    8  u32  minutes   length of the life by the pet's age clock
+//   12  u16  mistakes  care mistakes over the whole life
+//   14  u8x6 path      CharacterID from the egg on, NONE past the last form
+//   20  u8   discipline at death (percent)
+//   21  u8   cause     0 neglect, 1 sickness, 2 old age
+//   22  u8   weight    at death
+//   23  u8   check     CRC-8 of bytes 0..22; a torn write fails it
+constexpr size_t   GRAVE_RECORD_BYTES = 24;
+constexpr uint8_t  GRAVE_PATH_LEN     = 6;  // egg, baby, child, teen, adult, secret
+constexpr uint8_t  GRAVE_CAUSES       = 3;
+constexpr uint8_t  GRAVE_FORMS        = static_cast<uint8_t>(CharacterID::CHARACTER_COUNT);
+constexpr uint32_t GRAVE_NONE         = 0xFFFFFFFF;
+
+struct GraveRecord {
+    uint32_t    startWall    = 0;
+    uint32_t    endWall      = 0;
+    uint32_t    minutes      = 0;
+    uint16_t    careMistakes = 0;
+    CharacterID path[GRAVE_PATH_LEN] = {};
+    uint8_t     discipline   = 0;
+    uint8_t     deathCause   = 0;
+    uint8_t     weight       = 0;
+
+    // What the pet was when it died; NONE if that was not recorded
+    CharacterID finalForm() const {
+        CharacterID last = CharacterID::NONE;
+        for (CharacterID c : path) {
+            if (c == CharacterID::NONE) break;
+            last = c;
+        }
+        return last;
+    }
+};
+
+// CRC-8, polynomial 0x07
+inline uint8_t graveCrc8(const uint8_t* p, size_t n) {
+    uint8_t crc = 0;
+    while (n--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+inline uint8_t* gravePut32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) *p++ = (uint8_t)(v >> (8 * i));
+    return p;
+}
+
+inline uint32_t graveGet32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+inline void graveEncode(const GraveRecord& r, uint8_t* out) {
+    uint8_t* p = out;
+    p = gravePut32(p, r.startWall);
+    p = gravePut32(p, r.endWall);
+    p = gravePut32(p, r.minutes);
+    *p++ = (uint8_t)r.careMistakes;
+    *p++ = (uint8_t)(r.careMistakes >> 8);
+    for (CharacterID c : r.path) *p++ = static_cast<uint8_t>(c);
+    *p++ = r.discipline;
+    *p++ = r.deathCause;
+    *p++ = r.weight;
+    *p = graveCrc8(out, GRAVE_RECORD_BYTES - 1);
+}
+
+// False (and r left default) if the check fails or a form is out of range
+inline bool graveDecode(const uint8_t* in, GraveRecord& r) {
+    r = GraveRecord();
+    if (graveCrc8(in, GRAVE_RECORD_BYTES - 1) != in[GRAVE_RECORD_BYTES - 1]) return false;
+    for (uint8_t i = 0; i < GRAVE_PATH_LEN; i++) {
+        if (in[14 + i] >= GRAVE_FORMS) return false;
+    }
+    r.startWall    = graveGet32(in);
+    r.endWall      = graveGet32(in + 4);
+    r.minutes      = graveGet32(in + 8);
+    r.careMistakes = (uint16_t)(in[12] | in[13] << 8);
+    for (uint8_t i = 0; i < GRAVE_PATH_LEN; i++) r.path[i] = static_cast<CharacterID>(in[14 + i]);
+    r.discipline   = in[20];
+    r.deathCause   = in[21];
+    r.weight       = in[22];
+    return true;
+}
+
+// Totals over records 0..count-1, kept up to date one record at a time.
+// Damaged records hold their place but count nowhere else.
+struct GraveIndex {
+    uint32_t count        = 0;
+    uint32_t damaged      = 0;
+    uint32_t best         = GRAVE_NONE;  // longest life, the first of equals
+    uint32_t bestMinutes  = 0;
+    uint64_t totalMinutes = 0;
+    uint32_t byCause[GRAVE_CAUSES] = {};
+    uint32_t byForm[GRAVE_FORMS]   = {};  // by final form; NONE: not recorded
+
+    void add(const GraveRecord& r) {
+        if (best == GRAVE_NONE || r.minutes > bestMinutes) {
+            best = count;
+            bestMinutes = r.minutes;
+        }
+        totalMinutes += r.minutes;
+        if (r.deathCause < GRAVE_CAUSES) byCause[r.deathCause]++;
+        byForm[static_cast<uint8_t>(r.finalForm())]++;
+        count++;
+    }
+    void addDamaged() {
+        damaged++;
+        count++;
+    }
+};
+
+// Index file: "GIDX", version, GRAVE_FORMS, then the fields above as u32
+// (totalMinutes as two), then a CRC-8 of everything before it
+constexpr uint8_t GRAVE_INDEX_VERSION = 1;
+constexpr size_t  GRAVE_INDEX_BYTES   = 6 + 4 * (6 + GRAVE_CAUSES + GRAVE_FORMS) + 1;
+
+inline void graveIndexEncode(const GraveIndex& ix, uint8_t* out) {
+    uint8_t* p = out;
+    *p++ = 'G';
+    *p++ = 'I';
+    *p++ = 'D';
+    *p++ = 'X';
+    *p++ = GRAVE_INDEX_VERSION;
+    *p++ = GRAVE_FORMS;
+    p = gravePut32(p, ix.count);
+    p = gravePut32(p, ix.damaged);
+    p = gravePut32(p, ix.best);
+    p = gravePut32(p, ix.bestMinutes);
+    p = gravePut32(p, (uint32_t)ix.totalMinutes);
+    p = gravePut32(p, (uint32_t)(ix.totalMinutes >> 32));
+    for (uint32_t n : ix.byCause) p = gravePut32(p, n);
+    for (uint32_t n : ix.byForm) p = gravePut32(p, n);
+    *p = graveCrc8(out, GRAVE_INDEX_BYTES - 1);
+}
+
+inline bool graveIndexDecode(const uint8_t* in, size_t size, GraveIndex& ix) {
+    if (size != GRAVE_INDEX_BYTES || in[0] != 'G' || in[1] != 'I' || in[2] != 'D' || in[3] != 'X' ||
+        in[4] != GRAVE_INDEX_VERSION || in[5] != GRAVE_FORMS ||
+        graveCrc8(in, GRAVE_INDEX_BYTES - 1) != in[GRAVE_INDEX_BYTES - 1]) {
+        return false;
+    }
+    const uint8_t* p = in + 6;
+    auto next = [&p]() {
+        uint32_t v = graveGet32(p);
+        p += 4;
+        return v;
+    };
+    ix.count        = next();
+    ix.damaged      = next();
+    ix.best         = next();
+    ix.bestMinutes  = next();
+    ix.totalMinutes = next();
+    ix.totalMinutes |= (uint64_t)next() << 32;
+    for (uint32_t& n : ix.byCause) n = next();
+    for (uint32_t& n : ix.byForm) n = next();
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include "config.h"
+#include "pet.h"
+
+// Hunger, happiness, discipline and weight over each pet's life, in fixed
+// memory. A sample is taken once per minute of the pet's age (so the
+// timeline survives reboots and needs no RTC) and lands in three rings:
+// the raw minutes, hourly means and daily means. The hour and day being
+// filled are running sums, so a sample costs O(1) whatever the resolution;
+// minutes the device missed repeat the last sample. Slots are saved to
+// NVS as plain blobs.
+enum class StatSeries : uint8_t { HUNGER, HAPPINESS, DISCIPLINE, WEIGHT, COUNT };
+enum class StatRange : uint8_t { MINUTES, HOURS, DAYS, COUNT };
+
+constexpr uint8_t STAT_SERIES = static_cast<uint8_t>(StatSeries::COUNT);
+
+// Hearts as percent, discipline in percent, weight as is
+struct StatSample {
+    uint8_t v[STAT_SERIES];
+};
+
+// A series downsampled for drawing: points[i].i is the sample index
+// (oldest 0) out of span samples
+struct SparkPoint {
+    uint16_t i;
+    uint8_t  v;
+};
+struct Sparkline {
+    SparkPoint points[SPARK_POINTS];
+    uint8_t    count = 0;
+    uint16_t   span  = 0;
+    uint8_t    max   = 100;  // top of the scale
+};
+
+class StatHistory {
+public:
+    void load();  // every slot from NVS
+    void save();  // slots changed since the last save
+    void clear(uint8_t slot);
+
+    // Call every loop for each living pet; returns at once unless a minute
+    // of its age has passed since the last sample
+    void sample(uint8_t slot, const PetData& pet, unsigned long nowMs);
+
+    // Largest-Triangle-Three-Buckets down to SPARK_POINTS, so peaks and
+    // dips survive; the hour/day being filled is the newest point
+    void sparkline(uint8_t slot, StatRange range, StatSeries series, Sparkline& out) const;
+
+private:
+    struct Ring {
+        uint16_t head  = 0;  // next write
+        uint16_t count = 0;
+    };
+    // Plain data: one NVS blob per slot
+    struct Slot {
+        uint32_t   lastMinute = UINT32_MAX;  // age of the newest sample; none yet
+        StatSample last = {};
+        Ring       minuteRing, hourRing, dayRing;
+        StatSample minutes[HISTORY_MINUTES];
+        StatSample hours[HISTORY_HOURS];
+        StatSample days[HISTORY_DAYS];
+        uint16_t   hourSum[STAT_SERIES] = {};  // at most 60 x 100
+        uint32_t   daySum[STAT_SERIES]  = {};
+        uint16_t   hourCount = 0, dayCount = 0;
+    };
+
+    Slot    _slots[MAX_PETS];
+    uint8_t _dirty = 0;  // bit per slot
+
+    void push(Slot& s, const StatSample& v);
+};
@@ -8,10 +8,25 @@ enum class VButton : uint8_t {
     NONE
 };
 
+// Raw button state provider; InputManager reads M5 buttons when none is set
+class ButtonSource {
+public:
+    virtual ~ButtonSource() = default;
+    virtual void read(bool pressed[3], bool held[3]) = 0;
+};
+
+// BtnA/B/C of M5Unified (the Core2's touch zones)
+class M5ButtonSource : public ButtonSource {
+public:
+    void read(bool pressed[3], bool held[3]) override;
+};
+
 class InputManager {
 public:
     void init();
     void update();
+    void setSource(ButtonSource* src) { _source = src; }
+    ButtonSource* source() { return _source ? _source : &_m5; }
 
     bool wasPressed(VButton btn) const;
     bool wasHeld(VButton btn) const;
@@ -20,4 +35,6 @@ public:
 private:
     bool _pressed[3] = {};
     bool _held[3]    = {};
+    ButtonSource* _source = nullptr;
+    M5ButtonSource _m5;
 };
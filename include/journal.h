@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdio>
+#include "config.h"
+#include "clock.h"
+#include "journal_format.h"
+
+// Append-only log of everything that happens to the pets (format in
+// journal_format.h). PetManager appends into a RAM ring; pump() moves it
+// to the file in batches, so flash sees a few large writes instead of one
+// per event. A full ring drops new records (counted) rather than stall
+// the game loop, except while blocking, where it is written out first. Past JOURNAL_MAX_FILE_BYTES the file is renamed to
+// "<path>.old" and a new one started, so at most two files exist.
+class Journal {
+public:
+    ~Journal() { close(); }
+    void setClock(Clock* clock) { _clock = clock; }  // SESSION stamps
+
+    // Appends to path through stdio ("/littlefs/..." on the device)
+    bool open(const char* path);
+    void close();  // writes out whatever is buffered
+    bool isOpen() const { return _file != nullptr; }
+
+    void append(uint8_t slot, unsigned long nowMs, JournalOp op, uint32_t a = 0, uint32_t b = 0);
+    // Writes the ring once JOURNAL_FLUSH_BYTES are waiting, or all of it with force
+    void pump(bool force = false);
+    // Outside the loop (offline catch-up at load) nothing pumps the ring,
+    // and losing records is worse than a slow load
+    void setBlocking(bool on) { _blocking = on; }
+
+    uint32_t records() const { return _records; }
+    uint32_t dropped() const { return _dropped; }
+    uint32_t bytesWritten() const { return _bytesWritten; }
+
+private:
+    FILE*    _file = nullptr;
+    char     _path[96] = {};
+    Clock*   _clock = &realClock();
+
+    uint8_t  _ring[JOURNAL_RING_BYTES];
+    size_t   _head = 0;  // oldest byte not yet written
+    size_t   _used = 0;
+    size_t   _fileBytes = 0;
+    bool     _blocking = false;
+
+    unsigned long _lastMs = 0;
+    uint8_t  _lastSlot = 0;
+    uint32_t _records = 0;
+    uint32_t _dropped = 0;
+    uint32_t _bytesWritten = 0;
+
+    void beginSession();
+    bool push(const uint8_t* data, size_t size);
+    void rotate();
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// On-disk format of the pet event journal (see journal.h). No
+// dependencies, so host tools can read it without the firmware headers.
+//
+// A journal is a plain byte stream of records, append only:
+//   header  varint(zigzag(ms since the previous record) << 5 | op)
+//   args    JOURNAL_ARGS[op] varints
+// SESSION carries an absolute time instead and restarts the deltas, so
+// files from several boots can simply be concatenated. PET switches the
+// slot that the following records belong to (0 after each SESSION).
+enum class JournalOp : uint8_t {
+    SESSION = 0,  // nowMs, wallSec (0: RTC unset); written on open
+    PET,          // slot
+    EGG,          // seed
+    AGE,          // age after the tick
+    HUNGER,       // level after the decay
+    HAPPINESS,    // level after the decay
+    POOP,         // count after
+    SICK,         // doses needed
+    SLEEP,        // 1 fell asleep, 0 woke up
+    ATTENTION,    // AttentionType called for
+    RESOLVED,     // AttentionType answered by the player
+    MISTAKE,      // AttentionType whose care window ran out
+    ACTION,       // JournalAction, 1 if the pet accepted it
+    EVOLVE,       // CharacterID from, to
+    DEATH,        // cause (0 neglect, 1 sickness, 2 old age)
+    COUNT
+};
+
+enum class JournalAction : uint8_t {
+    FEED_MEAL = 0,
+    FEED_SNACK,
+    GAME,        // started a minigame
+    GAME_WIN,
+    GAME_LOSE,
+    DISCIPLINE,
+    MEDICINE,
+    CLEAN,
+    LIGHT,
+    COUNT
+};
+
+constexpr uint8_t JOURNAL_ARGS[] = {2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 1};
+static_assert(sizeof(JOURNAL_ARGS) == static_cast<size_t>(JournalOp::COUNT), "one arg count per op");
+static_assert(static_cast<uint8_t>(JournalOp::COUNT) <= 32, "op lives in 5 header bits");
+
+// Largest encoded record: 37-bit header plus two 32-bit args
+constexpr size_t JOURNAL_MAX_RECORD = 6 + 2 * 5;
+
+inline uint8_t* journalPutVarint(uint8_t* p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// Header values can need up to 37 bits (32-bit delta << 5)
+inline uint8_t* journalPutVarint64(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// nullptr on a truncated or overlong varint
+inline const uint8_t* journalGetVarint(const uint8_t* p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return p;
+    }
+    return nullptr;
+}
+
+inline uint32_t journalZigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t journalUnzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// One decoded record
+struct JournalRecord {
+    uint32_t  ms   = 0;  // millis() timebase of the session it belongs to
+    uint8_t   slot = 0;
+    JournalOp op   = JournalOp::SESSION;
+    uint32_t  a = 0, b = 0;
+};
+
+// Walks a journal in memory. next() is false at the end or on a damaged
+// record (then ok() is false too); PET and SESSION are applied and also
+// returned so callers can see boots and slot switches.
+class JournalCursor {
+public:
+    JournalCursor(const uint8_t* data, size_t size) : _p(data), _end(data + size) {}
+
+    bool next(JournalRecord& r) {
+        if (_p >= _end) return false;
+        uint64_t head;
+        const uint8_t* p = journalGetVarint(_p, _end, head);
+        uint8_t op = (uint8_t)(head & 31);
+        if (!p || op >= static_cast<uint8_t>(JournalOp::COUNT)) return fail();
+        uint64_t args[2] = {0, 0};
+        for (uint8_t i = 0; i < JOURNAL_ARGS[op]; i++) {
+            p = journalGetVarint(p, _end, args[i]);
+            if (!p) return fail();
+        }
+        _p = p;
+
+        r.op = static_cast<JournalOp>(op);
+        r.a = (uint32_t)args[0];
+        r.b = (uint32_t)args[1];
+        if (r.op == JournalOp::SESSION) {
+            _ms = r.a;
+            _slot = 0;
+        } else {
+            _ms += (uint32_t)journalUnzigzag((uint32_t)(head >> 5));
+        }
+        if (r.op == JournalOp::PET) _slot = (uint8_t)r.a;
+        r.ms = _ms;
+        r.slot = _slot;
+        return true;
+    }
+
+    bool ok() const { return _ok; }
+    size_t remaining() const { return (size_t)(_end - _p); }
+
+private:
+    const uint8_t* _p;
+    const uint8_t* _end;
+    uint32_t _ms   = 0;
+    uint8_t  _slot = 0;
+    bool     _ok   = true;
+
+    bool fail() {
+        _ok = false;
+        return false;
+    }
+};
@@ -9,7 +9,8 @@ enum class MenuItem : uint8_t {
     CLEAN,
     STATUS,
     DISCIPLINE,
-    MENU_COUNT  // = 7
+    PETS,       // pet select (multi-pet)
+    MENU_COUNT  // = 8
 };
 
 enum class FeedChoice : uint8_t {
@@ -1,9 +1,12 @@
 #pragma once
 #include <cstdint>
+#include "clock.h"
+#include "rng.h"
 
 class MiniGame {
 public:
-    void start();
+    void setClock(Clock* clock) { _clock = clock; }
+    void start(uint32_t seed);
     void guessHigher();
     void guessLower();
     bool isFinished() const { return _finished; }
@@ -26,6 +29,8 @@ private:
     bool    _showResult = false;
     bool    _finished   = false;
     unsigned long _resultShowMs = 0;
+    Clock*  _clock      = &realClock();
+    Rng     _rng;
 
     void generateNext();
     void advanceRound();
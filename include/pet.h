@@ -1,7 +1,14 @@
 #pragma once
+#include "care_stats.h"
 #include "character.h"
+#include "config.h"
+#include "rng.h"
+#include "rules.h"
+#include "journal_format.h"
 #include <cstdint>
 
+class Journal;
+
 enum class AttentionType : uint8_t {
     NONE = 0,
     HUNGRY,
@@ -11,6 +18,7 @@ enum class AttentionType : uint8_t {
     POOP,
     SLEEP,
 };
+static_assert(CARE_KINDS == static_cast<uint8_t>(AttentionType::SLEEP), "one CareKindStats per call type");
 
 struct PetData {
     CharacterID   characterId   = CharacterID::EGG;
@@ -49,16 +57,89 @@ struct PetData {
     bool     readyToEvolve = false;
     bool     isDead        = false;
     uint8_t  deathCause    = 0;  // 0=neglect, 1=sickness, 2=old age
+
+    Rng      rng;  // all of this pet's chance rolls (added in save v2)
+
+    // Save v3: what died, and when (the pet is a GHOST from then on)
+    CharacterID   lastForm = CharacterID::NONE;
+    unsigned long diedMs   = 0;
+
+    // Save v4: how the player answers calls, and when the oldest poop
+    // still on the floor came
+    unsigned long poopSinceMs = 0;
+    CareStats     care;
+};
+
+// Timed things that can happen to a pet, in the order the original
+// per-frame checks ran (ties at the same instant resolve in this order).
+enum class PetEvent : uint8_t {
+    AGE = 0,
+    HUNGER,
+    HAPPINESS,
+    POOP,
+    SICKNESS,
+    DISCIPLINE,
+    CARE_WINDOW,
+    EVOLUTION,   // hatch, baby timer, child/teen age gates
+    DEATH,
+    COUNT
+};
+
+// One predicted change for an untouched pet (see PetManager::forecast)
+struct NeedForecast {
+    PetEvent      event;  // HUNGER/HAPPINESS/POOP/SICKNESS/CARE_WINDOW/EVOLUTION/DEATH
+    unsigned long atMs;
+    uint8_t       value;  // HUNGER/HAPPINESS/POOP: level after; DEATH: cause; else 0
 };
 
 class PetManager {
 public:
-    void initNewEgg(unsigned long nowMs);
-    void loadFromSave(const PetData& d);
-    PetData& data();
+    void initNewEgg(unsigned long nowMs, uint32_t seed);
+    // lastHour: the hour sleep was already checked for, when resuming a
+    // pet captured mid-hour; 0xFF checks again on the next update()
+    void loadFromSave(const PetData& d, uint8_t lastHour = 0xFF);
+    // Timing to live by; must outlive the manager (default: config.h)
+    void setRules(const GameRules* rules);
+    const GameRules& rules() const { return *_rules; }
+    // Records everything that happens to this pet under slot (nullptr: off).
+    // Player actions are stamped with the time of the last update().
+    void setJournal(Journal* journal, uint8_t slot = 0) { _journal = journal; _journalSlot = slot; }
+
+    PetData& data();  // call reschedule() after changing timers through this
     const PetData& data() const;
 
+    // Returns immediately unless an event is due or the hour changed
     void update(unsigned long nowMs, uint8_t currentHour);
+    // Hour sleep was last checked for (0xFF: on the next update)
+    uint8_t lastHour() const { return _lastHour; }
+
+    // Next-due table, rebuilt from PetData whenever state changes
+    void reschedule();
+    bool hasScheduledEvent() const { return _nextEvent != PetEvent::COUNT; }
+    unsigned long nextEventMs() const { return _nextDue; }
+    PetEvent nextEvent() const { return _nextEvent; }
+    // Due time of one event; false if it is not armed
+    bool dueTime(PetEvent ev, unsigned long& dueMs) const {
+        uint8_t i = static_cast<uint8_t>(ev);
+        if (!(_armed & (1u << i))) return false;
+        dueMs = _due[i];
+        return true;
+    }
+
+    // Advances an unattended pet by elapsedMs starting at fromMs, jumping
+    // between scheduled events and hour boundaries instead of frames.
+    // fromWallSec is the RTC time at fromMs (only its hour of day matters).
+    // Evolutions happen as soon as they are ready, as the game loop does.
+    void simulateOffline(unsigned long fromMs, uint32_t elapsedMs, uint32_t fromWallSec);
+
+    // Next changes within horizonMs if nobody cares for the pet, soonest
+    // first; returns how many were written. Each need is projected on its
+    // own from the PetData timers (no forward simulation), including the
+    // pause while asleep. Chance rolls and attention collisions are not
+    // predicted, and the current character's bedtime is assumed
+    // throughout. nowWallSec 0 means the RTC is unset (noon-start hours).
+    uint8_t forecast(unsigned long nowMs, uint32_t nowWallSec, unsigned long horizonMs,
+                     NeedForecast* out, uint8_t maxCount) const;
 
     // Player actions
     bool feedMeal();
@@ -79,9 +160,34 @@ public:
 
     bool hasAttention() const;
 
+    // Draw from the pet's stream (e.g. to seed a minigame)
+    uint32_t nextRandom() { return _pet.rng.next(); }
+
 private:
-    PetData _pet;
+    static constexpr uint8_t EVENT_COUNT = static_cast<uint8_t>(PetEvent::COUNT);
 
+    PetData _pet;
+    const GameRules* _rules = &defaultRules();
+    Journal*      _journal     = nullptr;
+    uint8_t       _journalSlot = 0;
+    unsigned long _nowMs       = 0;  // last time seen, for journal stamps
+
+    unsigned long _due[EVENT_COUNT] = {};
+    uint16_t      _armed     = 0;  // bit per PetEvent
+    unsigned long _nextDue   = 0;
+    PetEvent      _nextEvent = PetEvent::COUNT;
+    uint8_t       _lastHour  = 0xFF;
+
+    // Decay intervals only change with the character
+    CharacterID   _intervalChar   = CharacterID::NONE;
+    unsigned long _hungerInterval = HUNGER_DECAY_MS;
+    unsigned long _happyInterval  = HAPPY_DECAY_MS;
+
+    void runDueEvents(unsigned long nowMs);
+    void fire(PetEvent ev, unsigned long nowMs);
+    void arm(PetEvent ev, unsigned long dueMs);
+
+    void onAgeTick(unsigned long nowMs);
     void decayHunger(unsigned long nowMs);
     void decayHappiness(unsigned long nowMs);
     void checkPoop(unsigned long nowMs);
@@ -89,9 +195,25 @@ private:
     void checkSleep(uint8_t currentHour);
     void checkDeath(unsigned long nowMs);
     void checkDisciplineCall(unsigned long nowMs);
-    void checkEvolution(unsigned long nowMs);
-    void checkCareWindow(unsigned long nowMs);
+    void checkEvolution();
+    void checkCareWindow();
     void triggerAttention(AttentionType type, unsigned long nowMs);
-    unsigned long effectiveHungerInterval() const;
-    unsigned long effectiveHappyInterval() const;
+    void resolveAttention(AttentionType type);
+    // A call ended with no answer (see care_stats.h)
+    void missCall(AttentionType type);
+    void dropCall(AttentionType type);
+    void startTimed(AttentionType type);
+    void answerTimed(AttentionType type, unsigned long sinceMs);
+    static uint8_t careBit(AttentionType type) { return 1u << (static_cast<uint8_t>(type) - 1); }
+    CareKindStats& careOf(AttentionType type) { return _pet.care.kind[static_cast<uint8_t>(type) - 1]; }
+    void log(JournalOp op, uint32_t a = 0, uint32_t b = 0);
+    bool logAction(JournalAction action, bool ok) {
+        if (_journal) log(JournalOp::ACTION, static_cast<uint32_t>(action), ok);
+        return ok;
+    }
+    void refreshIntervals();
+    unsigned long poopInterval() const;
+    EvoFacts evoFacts() const {
+        return {_pet.careMistakes, _pet.discipline, _pet.totalCareMistakes, _pet.age};
+    }
 };
@@ -0,0 +1,64 @@
+#pragma once
+#include "pet.h"
+
+// Calls f on every PetData field in a fixed order, for encodings and
+// hashes that must not depend on the struct's layout (unsigned long is 4
+// bytes on the device and 8 on the host). Keep in step with PetData;
+// the order is part of the input tape format.
+constexpr uint8_t PET_FIELD_COUNT = 36 + CARE_KINDS * (5 + CARE_BUCKETS) + 1;
+
+template <typename Pet, typename F>
+constexpr void forEachPetField(Pet& p, F&& f) {
+    f(p.characterId);
+    f(p.stage);
+    f(p.hunger);
+    f(p.happiness);
+    f(p.discipline);
+    f(p.weight);
+    f(p.age);
+    f(p.poopCount);
+    f(p.isSick);
+    f(p.sicknessLevel);
+    f(p.medicineGiven);
+    f(p.isAsleep);
+    f(p.lightOff);
+    f(p.careMistakes);
+    f(p.disciplineCalls);
+    f(p.totalCareMistakes);
+    f(p.totalAge);
+    f(p.pendingAttention);
+    f(p.attentionStartMs);
+    f(p.lastHungerDecayMs);
+    f(p.lastHappyDecayMs);
+    f(p.lastPoopMs);
+    f(p.lastAgeTickMs);
+    f(p.lastSickCheckMs);
+    f(p.lastDisciplineMs);
+    f(p.stageStartMs);
+    f(p.readyToEvolve);
+    f(p.isDead);
+    f(p.deathCause);
+    for (auto& word : p.rng.s) f(word);
+    f(p.lastForm);
+    f(p.diedMs);
+    f(p.poopSinceMs);
+    for (auto& k : p.care.kind) {
+        f(k.ewmaMs);
+        for (auto& n : k.hist) f(n);
+        f(k.answered);
+        f(k.missed);
+        f(k.recent);
+        f(k.recentCount);
+    }
+    f(p.care.timing);
+}
+
+// Fields the visitor actually walks; tables sized by PET_FIELD_COUNT
+// (the timeline's deltas) rely on the two agreeing
+constexpr uint8_t countPetFields() {
+    PetData p;
+    uint8_t n = 0;
+    forEachPetField(p, [&n](const auto&) { n++; });
+    return n;
+}
+static_assert(countPetFields() == PET_FIELD_COUNT, "PET_FIELD_COUNT is out of step with forEachPetField");
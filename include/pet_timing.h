@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+// Timer arithmetic shared by the pet's scheduler and the code that
+// projects it forward (forecast, evolution odds), so both agree on when
+// things happen.
+
+// Wrap-safe "has millis() reached dueMs"
+inline bool reached(unsigned long nowMs, unsigned long dueMs) {
+    return (long)(nowMs - dueMs) >= 0;
+}
+
+// Next value for a last*Ms timer that just fired. Keeps the scheduled
+// time so loop latency doesn't accumulate; if a whole interval was missed
+// (asleep, long park) it fires once and restarts from now, as before.
+inline unsigned long carry(unsigned long lastMs, unsigned long interval, unsigned long nowMs) {
+    unsigned long dueMs = lastMs + interval;
+    return (nowMs - dueMs < interval) ? dueMs : nowMs;
+}
+
+// Sleep windows of one character, mapped onto millis() time
+struct SleepWindow {
+    bool          enabled;
+    uint8_t       bed, wake;
+    unsigned long nowMs;
+    uint32_t      nowWall;  // seconds; hours are taken from this
+
+    uint32_t wallAt(unsigned long t) const { return nowWall + (uint32_t)((t - nowMs) / 1000UL); }
+
+    bool asleepAt(unsigned long t) const {
+        if (!enabled) return false;
+        uint8_t h = (wallAt(t) / 3600UL) % 24;
+        return (bed > wake) ? (h >= bed || h < wake) : (h >= bed && h < wake);
+    }
+
+    // Time a timer due at t actually fires: t, or the next wake-up
+    unsigned long fireTime(unsigned long t) const {
+        if (!asleepAt(t)) return t;
+        uint32_t w = wallAt(t);
+        uint8_t h = (w / 3600UL) % 24;
+        uint32_t hours = (wake + 24 - h) % 24;
+        return t + ((w / 3600UL + hours) * 3600UL - w) * 1000UL;
+    }
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include "pet.h"
+
+// Backlight / panel policy. Each loop it picks a target level from idle
+// time and pet state, then ramps toward it so changes fade instead of jump.
+//   FULL    input within DIM_AFTER_MS, or the pet needs care
+//   DIM     idle in normal screens
+//   AMBIENT ambient clock
+//   OFF     ambient while asleep with lights off and idle SCREEN_OFF_AFTER_MS
+// Logs CSV lines "[POWER],uptime_s,batt_pct,batt_mv,brightness,screen_on_s,avg_brightness"
+// every POWER_LOG_INTERVAL_MS and on each target change, for matching against battery drain.
+class PowerPolicy {
+public:
+    void init(unsigned long nowMs, uint8_t brightness);
+    void update(unsigned long nowMs, unsigned long lastInputMs,
+                const PetData& pet, bool ambient);
+
+    uint8_t brightness() const { return _level >> 8; }
+    bool isScreenOn() const { return !_panelAsleep; }
+    bool isRamping() const { return _level != (uint16_t)(_target << 8); }
+
+private:
+    uint16_t      _level  = 0;   // 8.8 fixed point
+    uint8_t       _target = 0;
+    bool          _panelAsleep = false;
+    unsigned long _lastMs = 0;
+    unsigned long _lastLogMs = 0;
+    unsigned long _startMs = 0;
+    uint32_t      _screenOnMs = 0;
+    uint64_t      _brightnessMs = 0;  // integral of brightness over time
+
+    void apply(uint8_t value);
+    void log(unsigned long nowMs);
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include "config.h"
+#include "pet.h"
+#include "rules.h"
+
+// Q15 fixed point: 32768 is certain
+constexpr uint16_t Q15_ONE = 1u << 15;
+
+// How the player is assumed to keep caring, Q15
+struct CareHabits {
+    uint16_t missCare         = (uint16_t)(PREDICT_MISS_CARE_PCT * Q15_ONE / 100);    // call runs out
+    uint16_t answerDiscipline = (uint16_t)(PREDICT_ANSWER_DISC_PCT * Q15_ONE / 100);  // call answered
+
+    // This pet's recent miss rates (care_stats.h) where there are enough
+    // calls to go on, the defaults above where not
+    static CareHabits measured(const CareStats& care);
+
+    bool operator==(const CareHabits& o) const {
+        return missCare == o.missCare && answerDiscipline == o.answerDiscipline;
+    }
+};
+
+// Chance of each adult form the pet ends up as, secret forms included
+struct EvoOdds {
+    uint16_t chance[static_cast<uint8_t>(CharacterID::CHARACTER_COUNT)] = {};  // Q15
+
+    // Forms with a chance, likeliest first; returns how many were written
+    uint8_t ranked(CharacterID* out, uint8_t max) const;
+    static uint8_t percent(uint16_t q15) { return (uint8_t)(((uint32_t)q15 * 100 + Q15_ONE / 2) >> 15); }
+};
+
+// Odds of where the pet's evolution leads, worked out exactly from the
+// rules rather than sampled. The state that decides an evolution (this
+// stage's mistakes, discipline, whether any mistake was ever made) is
+// held as a Q15 distribution; each stage's calls along its real timeline
+// (sleep, age gates, the discipline timer) update it one call at a time,
+// and at the stage's end every state is sent through resolveEvolution().
+// Adults then walk their hours for the secret form's per-tick roll.
+//
+// Not modelled: death before adulthood, and calls that crowd each other
+// out. Hunger and unhappy calls are expected once per full drain of each
+// stat, i.e. a player who tops the hearts up when called.
+class EvolutionPredictor {
+public:
+    // Recomputed only when something the odds depend on has changed since
+    // the last call. nowWallSec 0: RTC unset (noon-start hours, as forecast).
+    const EvoOdds& predict(const PetData& pet, const GameRules& rules, unsigned long nowMs,
+                           uint32_t nowWallSec, const CareHabits& habits);
+
+    unsigned long lastComputeUs() const { return _computeUs; }
+    uint32_t computeCount() const { return _computes; }
+
+private:
+    // Stage mistakes past this all read the same (the rules stop at 1)
+    static constexpr uint8_t MISTAKE_STATES = 4;
+    static constexpr uint8_t BUFFERS = 3;  // a child and its two teens at once
+
+    // [stage mistakes][discipline][any mistake ever]
+    struct Dist {
+        uint16_t p[MISTAKE_STATES][MAX_DISCIPLINE + 1][2];
+    };
+
+    struct Key {
+        CharacterID   characterId = CharacterID::NONE;
+        uint8_t       careMistakes = 0;
+        bool          anyMistake = false;
+        uint8_t       discipline = 0;
+        uint16_t      age = 0;
+        AttentionType pendingAttention = AttentionType::NONE;
+        bool          readyToEvolve = false;
+        unsigned long lastAgeTickMs = 0;
+        unsigned long lastDisciplineMs = 0;
+        unsigned long stageStartMs = 0;
+        uint32_t      wallHour = 0;
+        const GameRules* rules = nullptr;
+        CareHabits    habits;
+
+        bool operator==(const Key& o) const;
+    };
+
+    Dist          _dist[BUFFERS];
+    EvoOdds       _odds;
+    Key           _key;
+    bool          _valid     = false;
+    unsigned long _computeUs = 0;
+    uint32_t      _computes  = 0;
+
+    void compute(const PetData& pet, const GameRules& rules, unsigned long nowMs, uint32_t nowWall,
+                 const CareHabits& habits);
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+
+#ifdef STAGOTCHI_HOST
+// Host analysis tools can answer the rolls of one Rng themselves, e.g. to
+// follow every outcome of a roll instead of sampling one. Per thread, and
+// never compiled into the firmware.
+class RngOracle {
+public:
+    virtual ~RngOracle() = default;
+    virtual uint32_t next() = 0;
+    virtual uint32_t below(uint32_t n) = 0;
+};
+
+struct RngOverride {
+    const void* rng    = nullptr;  // the Rng whose rolls are answered
+    RngOracle*  oracle = nullptr;
+};
+
+inline RngOverride& rngOverride() {
+    static thread_local RngOverride o;
+    return o;
+}
+#endif
+
+// xoshiro128** (Blackman & Vigna): 128-bit state, period 2^128 - 1.
+// Plain data so it can live inside PetData and be saved with it. Every
+// roll the pet makes comes from its own Rng, so a seed plus the player's
+// inputs fully determines a life. jump() skips 2^64 outputs, which gives
+// non-overlapping streams for parallel runs from one seed.
+struct Rng {
+    uint32_t s[4] = {0x9E3779B9, 0x243F6A88, 0xB7E15162, 0x6A09E667};
+
+    void seed(uint32_t seed) {
+        // splitmix32 spreads one word over the whole state
+        for (int i = 0; i < 4; i++) {
+            uint32_t z = (seed += 0x9E3779B9);
+            z = (z ^ (z >> 16)) * 0x85EBCA6B;
+            z = (z ^ (z >> 13)) * 0xC2B2AE35;
+            s[i] = z ^ (z >> 16);
+        }
+        if ((s[0] | s[1] | s[2] | s[3]) == 0) s[0] = 1;  // all-zero is a fixed point
+    }
+
+    uint32_t next() {
+#ifdef STAGOTCHI_HOST
+        if (rngOverride().rng == this) return rngOverride().oracle->next();
+#endif
+        uint32_t result = rotl(s[1] * 5, 7) * 9;
+        uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    // Uniform in [0, n) by multiply-shift; bias is below 2^-24 for small n
+    uint32_t below(uint32_t n) {
+#ifdef STAGOTCHI_HOST
+        if (rngOverride().rng == this) return rngOverride().oracle->below(n);
+#endif
+        return (uint32_t)(((uint64_t)next() * n) >> 32);
+    }
+
+    void jump() {
+        static const uint32_t JUMP[] = {0x8764000B, 0xF542D2D3, 0x6FA035C3, 0x77F2DB5B};
+        uint32_t t[4] = {0, 0, 0, 0};
+        for (uint32_t j : JUMP) {
+            for (int b = 0; b < 32; b++) {
+                if (j & (1u << b)) {
+                    for (int i = 0; i < 4; i++) t[i] ^= s[i];
+                }
+                next();
+            }
+        }
+        for (int i = 0; i < 4; i++) s[i] = t[i];
+    }
+
+private:
+    static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include "config.h"
+#include "pet.h"
+
+// Up to MAX_PETS pets, one per save slot. The active pet is the one the
+// screens and buttons act on; its state handler steps it every loop as
+// before. The others are stepped round-robin by updateBackground() within
+// a time budget, picking up after the last one stepped, so the loop never
+// pays for all of them at once. PetManager::update() catches up anything
+// that came due in between, so waiting a few loops only delays a pet's
+// events by that long; it never skips one.
+class PetRoster {
+public:
+    bool occupied(uint8_t slot) const { return _used & (1u << slot); }
+    uint8_t usedMask() const { return _used; }
+    uint8_t count() const;
+    int8_t firstFree() const;  // -1 when every slot has a pet
+
+    uint8_t activeSlot() const { return _active; }
+    PetManager& active() { return _pets[_active]; }
+    PetManager& at(uint8_t slot) { return _pets[slot]; }
+    const PetManager& at(uint8_t slot) const { return _pets[slot]; }
+
+    void setActive(uint8_t slot) { _active = slot; }
+    void occupy(uint8_t slot) { _used |= (1u << slot); }
+    void vacate(uint8_t slot) { _used &= ~(1u << slot); }
+    void clear() { _used = 0; _active = 0; }
+
+    // Steps the inactive pets until each had a turn or budgetUs passed.
+    // Evolutions happen as soon as they are ready: there is nobody
+    // watching the animation. Returns how many pets were stepped.
+    uint8_t updateBackground(unsigned long nowMs, uint8_t hour, unsigned long budgetUs);
+
+    // Soonest scheduled event of any pet; false if none is armed
+    bool nextEventMs(unsigned long nowMs, unsigned long& dueMs) const;
+    // Bit per slot whose living pet is calling for care (sleep excluded)
+    uint8_t callingMask() const;
+
+private:
+    PetManager _pets[MAX_PETS];
+    uint8_t    _used   = 0;  // bit per slot
+    uint8_t    _active = 0;
+    uint8_t    _next   = 0;  // round-robin position
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "character.h"
+#include "config.h"
+#include <cstdint>
+
+// Game-feel timing that can change at runtime (balance tuning, host
+// sweeps). Defaults are the config.h constants and the per-character
+// multipliers from CHARACTER_TABLE; the device never changes them.
+struct GameRules {
+    static constexpr int CHARS = static_cast<int>(CharacterID::CHARACTER_COUNT);
+
+    unsigned long hungerDecayMs        = HUNGER_DECAY_MS;
+    unsigned long happyDecayMs         = HAPPY_DECAY_MS;
+    unsigned long poopIntervalMs       = POOP_INTERVAL_MS;
+    unsigned long poopIntervalYoungMs  = POOP_INTERVAL_YOUNG_MS;
+    unsigned long careWindowMs         = CARE_WINDOW_MS;
+    unsigned long disciplineIntervalMs = DISCIPLINE_INTERVAL_MS;
+    // x10 decay speed per character (10 = base rate, 0 = base rate)
+    uint8_t hungerDecayMul[CHARS] = {};
+    uint8_t happyDecayMul[CHARS]  = {};
+
+    GameRules();  // config.h + character table values
+
+    unsigned long hungerInterval(CharacterID id) const {
+        uint8_t m = hungerDecayMul[static_cast<uint8_t>(id)];
+        return m == 0 ? hungerDecayMs : hungerDecayMs * 10UL / m;
+    }
+    unsigned long happyInterval(CharacterID id) const {
+        uint8_t m = happyDecayMul[static_cast<uint8_t>(id)];
+        return m == 0 ? happyDecayMs : happyDecayMs * 10UL / m;
+    }
+};
+
+// Shared default for PetManagers that are not given rules
+const GameRules& defaultRules();
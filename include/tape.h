@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include "config.h"
+#include "clock.h"
+#include "input.h"
+#include "game_state.h"
+
+// Everything one loop() takes from outside the program: the buttons, the
+// game clock, the real-time millis() the loop runs on and the seeds of
+// new pets. Recording writes one frame per loop (setup() is frame 0) to a
+// compact file, headed by the saves the session started from; replaying
+// feeds the same frames back through the unmodified state handlers, with
+// no pacing, so a session reruns as fast as the loop can go.
+//
+// While a tape runs, the game reads time through it: gClock is the tape
+// and main.cpp takes millis() once per loop, so every read inside a loop
+// sees the same instant in both runs. Every TAPE_CHECK_FRAMES frames and
+// at the end the recording stores a hash of the game state; the replay
+// recomputes it and reports the first frame where they differ.
+//
+// File:  "TAPE", version, MAX_PETS, then per slot a present byte and
+//        the RawSave (version, savedMs, savedRtc, each PetData field as
+//        a varint), then frames, then an END record if it was stopped
+// Frame: byte  pressed (bits 0-2) | held (3-5) | SEEDS | EXTRA
+//        varint millis() delta, varint zigzag(game delta - millis delta)
+//        EXTRA: byte WALL | CHECK | END, zigzag wall delta, 8-byte hash
+//        SEEDS: varint count, varint seeds
+class InputTape : public Clock, public ButtonSource {
+public:
+    ~InputTape() { close(); }
+
+    // Starts recording; the game clock and buttons are read through `game`
+    // and `buttons` from here on. Snapshots the saves through `state`.
+    bool record(const char* path, Clock* game, ButtonSource* buttons, StateMachine& state);
+    // Loads a recording and writes its saves through `state` (point the
+    // save store somewhere disposable first)
+    bool replay(const char* path, StateMachine& state);
+    void close();
+
+    // Device: record from the next boot (flag kept in NVS)
+    static bool armed();
+    static void arm(bool on);
+
+    bool active() const { return _mode != Mode::OFF; }
+    bool recording() const { return _file != nullptr; }
+    bool replaying() const { return _mode == Mode::REPLAY; }
+    bool finished() const;  // replay: no frames left
+    bool diverged() const { return _diverged; }
+    uint32_t divergedAt() const { return _divergedAt; }  // first frame whose hash differed
+    uint32_t frames() const { return _frame; }
+    uint32_t checks() const { return _checks; }
+    uint32_t bytes() const { return _bytes; }
+    unsigned long recordedMs() const { return _millis - _millis0; }  // real time covered so far
+
+    // Top of a frame: latches this frame's times and returns its millis()
+    unsigned long beginFrame();
+    // Bottom of a frame; hash() is called on check frames only
+    void endFrame(uint64_t (*hash)());
+    // Recording: writes the final hash and stops writing (the clock keeps
+    // running through the tape). Replay: compares against that hash.
+    void end(uint64_t (*hash)());
+
+    // A new pet's seed: recorded as drawn, or the recorded one on replay
+    uint32_t seed(uint32_t drawn);
+
+    // Clock: the latched game time of the current frame
+    unsigned long nowMs() override { return _game; }
+    uint32_t wallSeconds() override { return _wall; }
+    unsigned long realMs(unsigned long gameMs) const override;
+    // ButtonSource: the frame's buttons
+    void read(bool pressed[3], bool held[3]) override;
+
+    // FNV-1a pieces for the state hash; fixed widths, so device and host
+    // agree on it although their PetData layouts differ
+    static uint64_t hashU32(uint64_t h, uint32_t v);
+    static uint64_t hashPet(uint64_t h, const PetData& pet);
+    static constexpr uint64_t HASH_SEED = 0xCBF29CE484222325ULL;
+
+private:
+    enum class Mode : uint8_t { OFF, RECORD, REPLAY };
+    Mode          _mode = Mode::OFF;
+    Clock*        _base = nullptr;
+    ButtonSource* _buttons = nullptr;
+
+    // Latched for the current frame
+    unsigned long _millis = 0, _millis0 = 0;
+    unsigned long _game = 0;
+    uint32_t      _wall = 0;
+    uint8_t       _bits = 0;  // pressed | held << 3
+
+    uint32_t _frame = 0;
+    uint32_t _checks = 0;
+    bool     _diverged = false;
+    uint32_t _divergedAt = 0;
+    uint32_t _bytes = 0;
+
+    // Recording: frame under construction, then batched into _buf
+    FILE*    _file = nullptr;
+    uint32_t _seeds[MAX_PETS] = {};
+    uint8_t  _seedCount = 0;
+    uint8_t  _seedNext = 0;  // replay
+    unsigned long _prevMillis = 0, _prevGame = 0;
+    uint32_t _prevWall = 0;
+    uint8_t  _buf[TAPE_BUFFER_BYTES];
+    size_t   _used = 0;
+
+    // Replay: the whole file, and the frame being played
+    uint8_t* _data = nullptr;
+    size_t   _size = 0, _pos = 0;
+    bool     _hasCheck = false;
+    uint64_t _check = 0;
+
+    void writeRecord(uint8_t extra, uint64_t hash);
+    void flush(bool sync);
+    bool readFrame();
+    void compare(uint64_t hash);
+};
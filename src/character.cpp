@@ -1,6 +1,6 @@
 #include "character.h"
 
-static const CharacterDef CHARACTER_TABLE[] = {
+static constexpr CharacterDef CHARACTER_TABLE[] = {
     // id                   nameJP                      nameEN            stage            wt  sleep    hMul hpMul
     {CharacterID::NONE,     "",                         "",               LifeStage::EGG,   0, {0, 0},   10, 10},
     {CharacterID::EGG,      "\xe3\x81\x9f\xe3\x81\xbe\xe3\x81\x94",
@@ -44,7 +44,7 @@ static const CharacterDef CHARACTER_TABLE[] = {
     // ゴースト
 };
 
-static const int TABLE_SIZE = sizeof(CHARACTER_TABLE) / sizeof(CHARACTER_TABLE[0]);
+static constexpr int TABLE_SIZE = sizeof(CHARACTER_TABLE) / sizeof(CHARACTER_TABLE[0]);
 
 const CharacterDef& getCharacterDef(CharacterID id) {
     uint8_t idx = static_cast<uint8_t>(id);
@@ -52,33 +52,218 @@ const CharacterDef& getCharacterDef(CharacterID id) {
     return CHARACTER_TABLE[0];
 }
 
-CharacterID resolveEvolution(CharacterID current, uint8_t careMistakes, uint8_t disciplinePct) {
-    switch (current) {
-        case CharacterID::BABY_CHAN:
-            return CharacterID::CHIBI_STACK;
+// ===== Evolution rules =====
+// A rule turns `from` into `to` when both conditions hold (field value in
+// [lo, hi]). Regular rules move to the next stage; for each character
+// they test a single field and must match every value of it exactly
+// once. Secret rules keep the stage and are rolled by PetManager.
+// The table is checked at compile time below, so editing it cannot
+// leave a character unreachable or a care/discipline value unhandled.
 
-        case CharacterID::CHIBI_STACK:
-            return (careMistakes <= 1)
-                ? CharacterID::STACK_JR
-                : CharacterID::DANBOARD_CHAN;
+namespace {
 
-        case CharacterID::STACK_JR:
-            if (disciplinePct >= 75) return CharacterID::AI_STACK;
-            if (disciplinePct >= 50) return CharacterID::ROSTACK;
-            return CharacterID::TAKAO;
+enum class EvoField : uint8_t {
+    ALWAYS = 0,
+    CARE_MISTAKES,
+    DISCIPLINE,
+    TOTAL_CARE_MISTAKES,
+    AGE,
+    COUNT
+};
+
+struct EvoCond {
+    EvoField field;
+    uint16_t lo, hi;
+};
+
+struct EvoRule {
+    CharacterID from;
+    CharacterID to;
+    EvoCond     a, b;
+    bool        secret;
+};
+
+constexpr uint16_t ANY_ABOVE = 0xFFFF;
+constexpr EvoCond  ALWAYS = {EvoField::ALWAYS, 0, 0};
+constexpr EvoCond when(EvoField f, uint16_t lo, uint16_t hi = ANY_ABOVE) { return {f, lo, hi}; }
+
+using C = CharacterID;
+using F = EvoField;
+
+constexpr EvoRule EVO_RULES[] = {
+    // from             to                condition                               second     secret
+    {C::EGG,           C::BABY_CHAN,     ALWAYS,                                 ALWAYS,    false},
+    {C::BABY_CHAN,     C::CHIBI_STACK,   ALWAYS,                                 ALWAYS,    false},
+    {C::CHIBI_STACK,   C::STACK_JR,      when(F::CARE_MISTAKES, 0, 1),           ALWAYS,    false},
+    {C::CHIBI_STACK,   C::DANBOARD_CHAN, when(F::CARE_MISTAKES, 2),              ALWAYS,    false},
+    {C::STACK_JR,      C::AI_STACK,      when(F::DISCIPLINE, 75),                ALWAYS,    false},
+    {C::STACK_JR,      C::ROSTACK,       when(F::DISCIPLINE, 50, 74),            ALWAYS,    false},
+    {C::STACK_JR,      C::TAKAO,         when(F::DISCIPLINE, 0, 49),             ALWAYS,    false},
+    {C::DANBOARD_CHAN, C::REXXCHAN,      when(F::DISCIPLINE, 75),                ALWAYS,    false},
+    {C::DANBOARD_CHAN, C::PROPELLA,      when(F::DISCIPLINE, 50, 74),            ALWAYS,    false},
+    {C::DANBOARD_CHAN, C::DK_ATOM,       when(F::DISCIPLINE, 0, 49),             ALWAYS,    false},
+    {C::AI_STACK,      C::SO_ARM,        when(F::TOTAL_CARE_MISTAKES, 0, 0),     when(F::AGE, 10), true},
+};
+
+constexpr int RULE_COUNT = sizeof(EVO_RULES) / sizeof(EVO_RULES[0]);
+constexpr int CHAR_COUNT = static_cast<int>(CharacterID::CHARACTER_COUNT);
+constexpr int FIELD_COUNT = static_cast<int>(EvoField::COUNT);
+
+// Rules of one character and kind, as a slice of EVO_RULES
+struct EvoSpan {
+    uint8_t first = 0;
+    uint8_t count = 0;
+};
+
+struct EvoIndex {
+    EvoSpan regular[CHAR_COUNT];
+    EvoSpan secret[CHAR_COUNT];
+};
+
+constexpr EvoIndex buildIndex() {
+    EvoIndex ix{};
+    for (int i = 0; i < RULE_COUNT; i++) {
+        int c = static_cast<int>(EVO_RULES[i].from);
+        EvoSpan& span = EVO_RULES[i].secret ? ix.secret[c] : ix.regular[c];
+        if (span.count == 0) span.first = (uint8_t)i;
+        span.count++;
+    }
+    return ix;
+}
+
+constexpr EvoIndex EVO_INDEX = buildIndex();
+
+constexpr bool holds(const EvoCond& c, const uint16_t* f) {
+    // One unsigned compare per range: values below lo wrap around
+    return (uint16_t)(f[static_cast<int>(c.field)] - c.lo) <= (uint16_t)(c.hi - c.lo);
+}
+
+// --- Compile-time validation ---
+
+constexpr int stageOf(CharacterID id) {
+    return static_cast<int>(CHARACTER_TABLE[static_cast<int>(id)].stage);
+}
+
+// Each (character, kind) is one contiguous slice, so a span lookup finds it all
+constexpr bool rulesGrouped() {
+    for (int i = 0; i < RULE_COUNT; i++) {
+        const EvoRule& r = EVO_RULES[i];
+        EvoSpan s = r.secret ? EVO_INDEX.secret[static_cast<int>(r.from)]
+                             : EVO_INDEX.regular[static_cast<int>(r.from)];
+        if (i < s.first || i >= s.first + s.count) return false;
+    }
+    return true;
+}
 
-        case CharacterID::DANBOARD_CHAN:
-            if (disciplinePct >= 75) return CharacterID::REXXCHAN;
-            if (disciplinePct >= 50) return CharacterID::PROPELLA;
-            return CharacterID::DK_ATOM;
+// Regular rules advance one stage; secret ones keep it
+constexpr bool stagesAdvance() {
+    for (const EvoRule& r : EVO_RULES) {
+        int want = stageOf(r.from) + (r.secret ? 0 : 1);
+        if (stageOf(r.to) != want || r.to == CharacterID::GHOST) return false;
+    }
+    return true;
+}
 
-        default:
-            return CharacterID::NONE;
+// Every pre-adult character has regular rules, all on one field, and
+// every value of that field (0..255 covers the uint8 facts) picks
+// exactly one of them. ALWAYS reads as a constant 0.
+constexpr bool rulesCoverEveryValue() {
+    for (int c = 0; c < CHAR_COUNT; c++) {
+        int stage = static_cast<int>(CHARACTER_TABLE[c].stage);
+        EvoSpan s = EVO_INDEX.regular[c];
+        bool grows = c != 0 && stage < static_cast<int>(LifeStage::ADULT);
+        if (grows != (s.count > 0)) return false;
+        if (s.count == 0) continue;
+        EvoField field = EVO_RULES[s.first].a.field;
+        for (int i = s.first; i < s.first + s.count; i++) {
+            if (EVO_RULES[i].a.field != field || EVO_RULES[i].b.field != EvoField::ALWAYS) return false;
+        }
+        int values = field == EvoField::ALWAYS ? 1 : 256;
+        for (int v = 0; v < values; v++) {
+            uint16_t f[FIELD_COUNT] = {};
+            f[static_cast<int>(field)] = (uint16_t)v;
+            int matches = 0;
+            for (int i = s.first; i < s.first + s.count; i++) {
+                if (holds(EVO_RULES[i].a, f)) matches++;
+            }
+            if (matches != 1) return false;
+        }
+    }
+    return true;
+}
+
+// Every living character can be reached from the egg
+constexpr bool allReachable() {
+    bool reached[CHAR_COUNT] = {};
+    reached[static_cast<int>(CharacterID::EGG)] = true;
+    for (int pass = 0; pass < CHAR_COUNT; pass++) {
+        for (const EvoRule& r : EVO_RULES) {
+            if (reached[static_cast<int>(r.from)]) reached[static_cast<int>(r.to)] = true;
+        }
+    }
+    for (int c = 1; c < CHAR_COUNT; c++) {
+        if (CHARACTER_TABLE[c].stage != LifeStage::DEAD && !reached[c]) return false;
     }
+    return true;
 }
 
-bool isSecretEligible(uint16_t totalCareMistakes, CharacterID currentChar, uint16_t age) {
-    return (totalCareMistakes == 0 &&
-            currentChar == CharacterID::AI_STACK &&
-            age >= 10);
+// Each character has at most one parent, so a final form names its whole path
+constexpr bool singleParent() {
+    for (int c = 0; c < CHAR_COUNT; c++) {
+        int parents = 0;
+        for (const EvoRule& r : EVO_RULES) {
+            if (static_cast<int>(r.to) == c) parents++;
+        }
+        if (parents > 1) return false;
+    }
+    return true;
+}
+
+struct EvoParents {
+    CharacterID of[CHAR_COUNT];
+};
+
+constexpr EvoParents buildParents() {
+    EvoParents p{};
+    for (const EvoRule& r : EVO_RULES) p.of[static_cast<int>(r.to)] = r.from;
+    return p;
+}
+
+constexpr EvoParents EVO_PARENTS = buildParents();
+
+static_assert(TABLE_SIZE == CHAR_COUNT, "CHARACTER_TABLE needs one row per CharacterID");
+static_assert(rulesGrouped(), "EVO_RULES: keep each character's regular and secret rules together");
+static_assert(stagesAdvance(), "EVO_RULES: regular rules must reach the next stage, secret rules the same one");
+static_assert(rulesCoverEveryValue(), "EVO_RULES: a growing character's rules must match every value exactly once");
+static_assert(allReachable(), "EVO_RULES: some character can never be reached from the egg");
+static_assert(singleParent(), "EVO_RULES: a character reached from two others has no single path");
+
+inline CharacterID firstMatch(EvoSpan span, const EvoFacts& facts) {
+    const uint16_t f[FIELD_COUNT] = {0, facts.careMistakes, facts.discipline,
+                                     facts.totalCareMistakes, facts.age};
+    for (int i = span.first; i < span.first + span.count; i++) {
+        const EvoRule& r = EVO_RULES[i];
+        if (holds(r.a, f) && holds(r.b, f)) return r.to;
+    }
+    return CharacterID::NONE;
+}
+
+}  // namespace
+
+CharacterID resolveEvolution(CharacterID current, const EvoFacts& facts) {
+    uint8_t idx = static_cast<uint8_t>(current);
+    if (idx >= CHAR_COUNT) return CharacterID::NONE;
+    return firstMatch(EVO_INDEX.regular[idx], facts);
+}
+
+CharacterID resolveSecretEvolution(CharacterID current, const EvoFacts& facts) {
+    uint8_t idx = static_cast<uint8_t>(current);
+    if (idx >= CHAR_COUNT) return CharacterID::NONE;
+    return firstMatch(EVO_INDEX.secret[idx], facts);
+}
+
+CharacterID evolutionParent(CharacterID id) {
+    uint8_t idx = static_cast<uint8_t>(id);
+    if (idx >= CHAR_COUNT) return CharacterID::NONE;
+    return EVO_PARENTS.of[idx];
 }
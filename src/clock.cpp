@@ -0,0 +1,72 @@
+#include "clock.h"
+#include <M5Unified.h>
+
+uint8_t Clock::hour() {
+    uint32_t wall = wallSeconds();
+    if (wall) return (wall / 3600UL) % 24;
+    return (12 + nowMs() / 3600000UL) % 24;
+}
+
+uint8_t Clock::minute() {
+    uint32_t wall = wallSeconds();
+    if (wall) return (wall / 60UL) % 60;
+    return (nowMs() / 60000UL) % 60;
+}
+
+unsigned long Clock::msUntilNextMinute() {
+    uint32_t wall = wallSeconds();
+    if (wall) return (60 - wall % 60) * 1000UL;
+    return 60000UL - nowMs() % 60000UL;
+}
+
+// ===== RealClock =====
+
+unsigned long RealClock::nowMs() {
+    return millis();
+}
+
+uint32_t RealClock::wallSeconds() {
+    auto dt = M5.Rtc.getDateTime();
+    if (dt.date.year <= 2020) return 0;  // RTC never set
+    // Days from civil date, with March as the first month so Feb 29 is last
+    int m = dt.date.month;
+    int y = dt.date.year - (m <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + dt.date.date - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    uint32_t days = (uint32_t)(era * 146097 + doe - 719468);
+    return days * 86400UL + dt.time.hours * 3600UL +
+           dt.time.minutes * 60UL + dt.time.seconds;
+}
+
+Clock& realClock() {
+    static RealClock clock;
+    return clock;
+}
+
+// ===== ScaledClock =====
+
+void ScaledClock::start() {
+    _startMs = _base.nowMs();
+    _startWall = _base.wallSeconds();
+    _started = true;
+}
+
+unsigned long ScaledClock::nowMs() {
+    if (!_started) start();
+    return _startMs + (_base.nowMs() - _startMs) * _factor;
+}
+
+uint32_t ScaledClock::wallSeconds() {
+    if (!_started) start();
+    if (!_startWall) return 0;
+    return _startWall + (uint32_t)((nowMs() - _startMs) / 1000UL);
+}
+
+// ===== VirtualClock =====
+
+uint32_t VirtualClock::wallSeconds() {
+    if (!_startWall) return 0;
+    return _startWall + (uint32_t)(_ms / 1000UL);
+}
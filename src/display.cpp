@@ -7,7 +7,7 @@
 
 void DisplayManager::init() {
     M5.Display.setRotation(1);
-    M5.Display.setBrightness(200);
+    M5.Display.setBrightness(DISPLAY_BRIGHTNESS);
     _canvas.setColorDepth(8);  // 8-bit = 76,800 bytes (fits in RAM)
     _canvas.createSprite(SCREEN_W, SCREEN_H);
     _canvas.fillSprite(TFT_BLACK);
@@ -16,7 +16,41 @@ void DisplayManager::init() {
 }
 
 void DisplayManager::flush() {
+#ifndef STAGOTCHI_HOST
     _canvas.pushSprite(0, 0);
+#endif
+    _pushCount++;
+    _pushedPixels += SCREEN_W * SCREEN_H;
+    notifySinks();
+}
+
+void DisplayManager::flushRect(int x, int y, int w, int h) {
+#ifndef STAGOTCHI_HOST
+    // pushSprite honours the panel clip rect, so only this region crosses SPI
+    M5.Display.setClipRect(x, y, w, h);
+    _canvas.pushSprite(0, 0);
+    M5.Display.clearClipRect();
+#else
+    (void)x;
+    (void)y;
+#endif
+    _pushCount++;
+    _pushedPixels += w * h;
+    notifySinks();
+}
+
+void DisplayManager::notifySinks() {
+    if (_sinkCount == 0) return;
+    const uint8_t* pixels = static_cast<const uint8_t*>(_canvas.getBuffer());
+    for (uint8_t i = 0; i < _sinkCount; i++) {
+        _sinks[i]->onFrame(pixels, SCREEN_W, SCREEN_H);
+    }
+}
+
+bool DisplayManager::addFrameSink(FrameSink* sink) {
+    if (_sinkCount >= MAX_FRAME_SINKS) return false;
+    _sinks[_sinkCount++] = sink;
+    return true;
 }
 
 // Font helpers using M5GFX built-in Japanese fonts
@@ -58,10 +92,28 @@ void DisplayManager::drawHearts(int x, int y, uint8_t filled, uint8_t max,
     }
 }
 
+void DisplayManager::drawSparkline(int x, int y, int w, int h, const Sparkline& spark) {
+    _canvas.drawFastHLine(x, y + h - 1, w, COL_HEART_E);
+    if (spark.count == 0) return;
+    int px = x, py = 0;
+    for (uint8_t i = 0; i < spark.count; i++) {
+        const SparkPoint& p = spark.points[i];
+        int cx = spark.span > 1 ? x + p.i * (w - 1) / (spark.span - 1) : x + w - 1;
+        int cy = y + h - 1 - (p.v < spark.max ? p.v : spark.max) * (h - 1) / spark.max;
+        if (i == 0) {
+            _canvas.drawPixel(cx, cy, COL_DARK);
+        } else {
+            _canvas.drawLine(px, py, cx, cy, COL_DARK);
+        }
+        px = cx;
+        py = cy;
+    }
+}
+
 void DisplayManager::drawMenuIcons(uint8_t cursor) {
     _canvas.fillRect(0, 0, SCREEN_W, 32, COL_ICON_BG);
-    // UTF-8 menu labels: 食 灯 遊 薬 掃 状 躾
-    const char* labelsU[] = {"\xe9\xa3\x9f", "\xe7\x81\xaf", "\xe9\x81\x8a", "\xe8\x96\xac", "\xe6\x8e\x83", "\xe7\x8a\xb6", "\xe8\xba\xbe"};
+    // UTF-8 menu labels: 食 灯 遊 薬 掃 状 躾 皆
+    const char* labelsU[] = {"\xe9\xa3\x9f", "\xe7\x81\xaf", "\xe9\x81\x8a", "\xe8\x96\xac", "\xe6\x8e\x83", "\xe7\x8a\xb6", "\xe8\xba\xbe", "\xe7\x9a\x86"};
 
     setFontSmall();
     for (int i = 0; i < ICON_COUNT; i++) {
@@ -95,6 +147,20 @@ void DisplayManager::drawStatusBar(const PetData& pet) {
         _canvas.drawString("(!)", 220, STATUS_BAR_Y + STATUS_BAR_H / 2);
     }
 
+    // Filled dot: the pet on screen; red: calling for care
+    if (_badgeUsed & (_badgeUsed - 1)) {
+        for (uint8_t s = 0; s < MAX_PETS; s++) {
+            if (!(_badgeUsed & (1u << s))) continue;
+            int bx = 176 + s * 10, by = STATUS_BAR_Y + STATUS_BAR_H / 2;
+            uint16_t c = (_badgeCalling & (1u << s)) ? COL_HEART : COL_STATUS_FG;
+            if (s == _badgeActive) {
+                _canvas.fillCircle(bx, by, 4, c);
+            } else {
+                _canvas.drawCircle(bx, by, 4, c);
+            }
+        }
+    }
+
     int batt = M5.Power.getBatteryLevel();
     if (batt >= 0) {
         _canvas.setTextColor(COL_STATUS_FG, COL_STATUS_BG);
@@ -104,10 +170,71 @@ void DisplayManager::drawStatusBar(const PetData& pet) {
     }
 }
 
+const DisplayManager::SpriteRuns& DisplayManager::decodeSprite(const uint8_t* data, uint8_t shift) {
+    SpriteRuns* victim = &_sprites[0];
+    for (SpriteRuns& e : _sprites) {
+        if (e.data == data && e.shift == shift) {
+            e.lastUse = ++_spriteUses;
+            return e;
+        }
+        if (e.lastUse < victim->lastUse) victim = &e;
+    }
+
+    SpriteRuns& e = *victim;
+    e.data = data;
+    e.shift = shift;
+    e.lastUse = ++_spriteUses;
+    e.ok = true;
+    int w = SPRITE_W >> shift, h = SPRITE_H >> shift;
+    int bytesPerRow = SPRITE_W / 8;
+    int n = 0;
+    for (int row = 0; row < h; row++) {
+        int start = -1;
+        for (int col = 0; col <= w; col++) {
+            bool on = false;
+            if (col < w) {
+                int sc = col << shift;
+                uint8_t b = pgm_read_byte(&data[(row << shift) * bytesPerRow + sc / 8]);
+                on = b & (1 << (7 - sc % 8));
+            }
+            if (on && start < 0) start = col;
+            if (!on && start >= 0) {
+                if (n == SPRITE_MAX_RUNS) {
+                    e.ok = false;
+                    return e;
+                }
+                e.runs[n][0] = (uint8_t)start;
+                e.runs[n][1] = (uint8_t)(col - start);
+                n++;
+                start = -1;
+            }
+        }
+        e.rowEnd[row] = (uint8_t)n;
+    }
+    return e;
+}
+
+void DisplayManager::drawSpriteRuns(int x, int y, const SpriteRuns& spr,
+                                    uint16_t fgColor, uint16_t bgColor) {
+    int h = SPRITE_H >> spr.shift;
+    _canvas.fillRect(x, y, SPRITE_W >> spr.shift, h, bgColor);
+    int i = 0;
+    for (int row = 0; row < h; row++) {
+        for (; i < spr.rowEnd[row]; i++) {
+            _canvas.drawFastHLine(x + spr.runs[i][0], y + row, spr.runs[i][1], fgColor);
+        }
+    }
+}
+
 void DisplayManager::drawPetSprite(int cx, int cy, CharacterID charId, uint16_t bgColor) {
     const uint8_t* spr = getSpriteForCharacter(charId);
-    drawSprite1bit(cx - SPRITE_W / 2, cy - SPRITE_H / 2, SPRITE_W, SPRITE_H,
-                   spr, COL_BLACK, bgColor);
+    int x = cx - SPRITE_W / 2, y = cy - SPRITE_H / 2;
+    const SpriteRuns& runs = decodeSprite(spr, 0);
+    if (runs.ok) {
+        drawSpriteRuns(x, y, runs, COL_BLACK, bgColor);
+    } else {
+        drawSprite1bit(x, y, SPRITE_W, SPRITE_H, spr, COL_BLACK, bgColor);
+    }
 }
 
 void DisplayManager::drawPoops(uint8_t count) {
@@ -119,7 +246,7 @@ void DisplayManager::drawPoops(uint8_t count) {
 }
 
 void DisplayManager::drawAttention(AttentionType type) {
-    unsigned long now = millis();
+    unsigned long now = _uiClock->nowMs();
     if (now - _lastBlinkMs > 500) {
         _blinkState = !_blinkState;
         _lastBlinkMs = now;
@@ -158,8 +285,8 @@ void DisplayManager::drawTitleScreen() {
 
     _canvas.setTextColor(0x7BCF, TFT_BLACK);
     setFontSmall();
-    _canvas.drawString("\xe3\x83\x9c\xe3\x82\xbf\xe3\x83\xb3\xe3\x82\x92\xe6\x8a\xbc\xe3\x81\x97\xe3\x81\xa6\xe3\x81\xad", SCREEN_W / 2, 220);
-    // "ボタンを押してね"
+    // "A: おはか  B/C: はじめる"
+    _canvas.drawString("A: \xe3\x81\x8a\xe3\x81\xaf\xe3\x81\x8b  B/C: \xe3\x81\xaf\xe3\x81\x98\xe3\x82\x81\xe3\x82\x8b", SCREEN_W / 2, 220);
     flush();
 }
 
@@ -302,7 +429,9 @@ void DisplayManager::drawFeedMenu(uint8_t subCursor) {
     // No flush here - caller handles it
 }
 
-void DisplayManager::drawStatScreen(const PetData& pet, const CharacterDef& charDef) {
+void DisplayManager::drawStatScreen(const PetData& pet, const CharacterDef& charDef,
+                                    const NeedForecast* next, const Sparkline* sparks, StatRange range,
+                                    const EvoOdds* odds) {
     _canvas.fillSprite(COL_BG);
     _canvas.fillRect(20, 15, 280, 210, COL_WHITE);
     _canvas.drawRect(20, 15, 280, 210, COL_BLACK);
@@ -311,40 +440,171 @@ void DisplayManager::drawStatScreen(const PetData& pet, const CharacterDef& char
     setFontMedium();
     _canvas.setTextDatum(ML_DATUM);
 
-    int x = 40, y = 38;
-    char buf[50];
+    const int row = 25;
+    int x = 40, y = 36;
+    char buf[96];
 
     // "なまえ: XXX"
     snprintf(buf, sizeof(buf), "\xe3\x81\xaa\xe3\x81\xbe\xe3\x81\x88: %s", charDef.nameJP);
-    _canvas.drawString(buf, x, y); y += 28;
+    _canvas.drawString(buf, x, y); y += row;
 
     // "ねんれい: X じかん"
     snprintf(buf, sizeof(buf), "\xe3\x81\xad\xe3\x82\x93\xe3\x82\x8c\xe3\x81\x84: %d \xe3\x81\x98\xe3\x81\x8b\xe3\x82\x93", pet.age);
-    _canvas.drawString(buf, x, y); y += 28;
+    _canvas.drawString(buf, x, y); y += row;
+
+    // Sparklines to the right of weight, hunger, happiness and discipline
+    if (sparks) {
+        static const StatSeries ROWS[] = {StatSeries::WEIGHT, StatSeries::HUNGER,
+                                          StatSeries::HAPPINESS, StatSeries::DISCIPLINE};
+        for (uint8_t r = 0; r < 4; r++) {
+            drawSparkline(200, y - 10 + r * row, 88, 20, sparks[static_cast<uint8_t>(ROWS[r])]);
+        }
+        // "3じかん" / "7にち"
+        if (range == StatRange::MINUTES) {
+            snprintf(buf, sizeof(buf), "%u\xe3\x81\x98\xe3\x81\x8b\xe3\x82\x93", HISTORY_MINUTES / 60);
+        } else {
+            snprintf(buf, sizeof(buf), "%u\xe3\x81\xab\xe3\x81\xa1",
+                     range == StatRange::HOURS ? HISTORY_HOURS / 24 : HISTORY_DAYS);
+        }
+        setFontSmall();
+        _canvas.setTextDatum(MR_DATUM);
+        _canvas.drawString(buf, 288, 36);
+        _canvas.setTextDatum(ML_DATUM);
+        setFontMedium();
+    }
 
     // "たいじゅう: Xg"
     snprintf(buf, sizeof(buf), "\xe3\x81\x9f\xe3\x81\x84\xe3\x81\x98\xe3\x82\x85\xe3\x81\x86: %dg", pet.weight);
-    _canvas.drawString(buf, x, y); y += 28;
+    _canvas.drawString(buf, x, y); y += row;
 
     // "おなか:"
     _canvas.drawString("\xe3\x81\x8a\xe3\x81\xaa\xe3\x81\x8b:", x, y);
     drawHearts(x + 80, y - 4, pet.hunger, MAX_HUNGER, COL_HEART);
-    y += 28;
+    y += row;
 
     // "ごきげん:"
     _canvas.drawString("\xe3\x81\x94\xe3\x81\x8d\xe3\x81\x92\xe3\x82\x93:", x, y);
     drawHearts(x + 80, y - 4, pet.happiness, MAX_HAPPY, COL_HEART);
-    y += 28;
+    y += row;
 
     // "しつけ: XX%"
     snprintf(buf, sizeof(buf), "\xe3\x81\x97\xe3\x81\xa4\xe3\x81\x91: %d%%", pet.discipline);
-    _canvas.drawString(buf, x, y);
+    _canvas.drawString(buf, x, y); y += row;
+
+    // "つぎ: おなか あと 42ふん" / "あと 3じかん"
+    if (next) {
+        const char* what;
+        switch (next->event) {
+            case PetEvent::HUNGER:      what = "\xe3\x81\x8a\xe3\x81\xaa\xe3\x81\x8b"; break;              // おなか
+            case PetEvent::HAPPINESS:   what = "\xe3\x81\x94\xe3\x81\x8d\xe3\x81\x92\xe3\x82\x93"; break;  // ごきげん
+            case PetEvent::POOP:        what = "\xe3\x81\x86\xe3\x82\x93\xe3\x81\xa1"; break;              // うんち
+            case PetEvent::SICKNESS:    what = "\xe3\x81\xb3\xe3\x82\x87\xe3\x81\x86\xe3\x81\x8d"; break;  // びょうき
+            case PetEvent::CARE_WINDOW: what = "\xe3\x81\x8a\xe3\x81\x9b\xe3\x82\x8f"; break;              // おせわ
+            case PetEvent::EVOLUTION:   what = "\xe3\x81\x97\xe3\x82\x93\xe3\x81\x8b"; break;              // しんか
+            default:                    what = "\xe3\x81\x84\xe3\x81\xae\xe3\x81\xa1"; break;              // いのち
+        }
+        long left = (long)(next->atMs - _clock->nowMs());
+        unsigned long mins = left > 0 ? (unsigned long)left / 60000UL : 0;
+        setFontSmall();
+        if (mins < 60) {
+            snprintf(buf, sizeof(buf), "\xe3\x81\xa4\xe3\x81\x8e: %s \xe3\x81\x82\xe3\x81\xa8 %lu\xe3\x81\xb5\xe3\x82\x93",
+                     what, mins);
+        } else {
+            snprintf(buf, sizeof(buf), "\xe3\x81\xa4\xe3\x81\x8e: %s \xe3\x81\x82\xe3\x81\xa8 %lu\xe3\x81\x98\xe3\x81\x8b\xe3\x82\x93",
+                     what, mins / 60);
+        }
+        _canvas.drawString(buf, x, y);
+    }
+
+    // "しんか: NAME 62% NAME 30%", the likeliest adult forms; nothing once
+    // the pet can only stay what it is
+    CharacterID forms[2];
+    uint8_t formCount = odds ? odds->ranked(forms, 2) : 0;
+    if (formCount > 0 && forms[0] != pet.characterId) {
+        setFontSmall();
+        int len = snprintf(buf, sizeof(buf), "\xe3\x81\x97\xe3\x82\x93\xe3\x81\x8b: %s %u%%",
+                           getCharacterDef(forms[0]).nameJP, EvoOdds::percent(odds->chance[static_cast<uint8_t>(forms[0])]));
+        if (formCount > 1 && EvoOdds::percent(odds->chance[static_cast<uint8_t>(forms[1])]) > 0) {
+            snprintf(buf + len, sizeof(buf) - len, "  %s %u%%", getCharacterDef(forms[1]).nameJP,
+                     EvoOdds::percent(odds->chance[static_cast<uint8_t>(forms[1])]));
+            if (_canvas.textWidth(buf) > 300 - x - 8) buf[len] = '\0';
+        }
+        _canvas.drawString(buf, x, y + 20);
+    }
 
     _canvas.setTextDatum(MC_DATUM);
     _canvas.setTextColor(COL_DARK, COL_BG);
     setFontSmall();
-    // "ボタンでもどる"
-    _canvas.drawString("\xe3\x83\x9c\xe3\x82\xbf\xe3\x83\xb3\xe3\x81\xa7\xe3\x82\x82\xe3\x81\xa9\xe3\x82\x8b", SCREEN_W / 2, 232);
+    // "A/C: きかん  B: つぎ"
+    _canvas.drawString("A/C: \xe3\x81\x8d\xe3\x81\x8b\xe3\x82\x93  B: \xe3\x81\xa4\xe3\x81\x8e", SCREEN_W / 2, 232);
+    flush();
+}
+
+void DisplayManager::drawCareStats(const CareStats& care) {
+    _canvas.fillSprite(COL_BG);
+    _canvas.fillRect(20, 15, 280, 210, COL_WHITE);
+    _canvas.drawRect(20, 15, 280, 210, COL_BLACK);
+    _canvas.setTextColor(COL_BLACK, COL_WHITE);
+
+    // "おせわのきろく"
+    setFontMedium();
+    _canvas.setTextDatum(ML_DATUM);
+    _canvas.drawString("\xe3\x81\x8a\xe3\x81\x9b\xe3\x82\x8f\xe3\x81\xae\xe3\x81\x8d\xe3\x82\x8d\xe3\x81\x8f", 40, 34);
+
+    // "へいきん" / "みす" / "はやい→おそい"
+    setFontSmall();
+    _canvas.drawString("\xe3\x81\xb8\xe3\x81\x84\xe3\x81\x8d\xe3\x82\x93", 118, 58);
+    _canvas.drawString("\xe3\x81\xbf\xe3\x81\x99", 170, 58);
+    _canvas.drawString("\xe3\x81\xaf\xe3\x82\x84\xe3\x81\x84\xe2\x86\x92\xe3\x81\x8a\xe3\x81\x9d\xe3\x81\x84", 210, 58);
+
+    // In AttentionType order
+    static const char* const KINDS[CARE_KINDS] = {
+        "\xe3\x81\x8a\xe3\x81\xaa\xe3\x81\x8b",              // おなか
+        "\xe3\x81\x94\xe3\x81\x8d\xe3\x81\x92\xe3\x82\x93",  // ごきげん
+        "\xe3\x81\x97\xe3\x81\xa4\xe3\x81\x91",              // しつけ
+        "\xe3\x81\xb3\xe3\x82\x87\xe3\x81\x86\xe3\x81\x8d",  // びょうき
+        "\xe3\x81\x86\xe3\x82\x93\xe3\x81\xa1",              // うんち
+        "\xe3\x81\xa7\xe3\x82\x93\xe3\x81\x8d",              // でんき
+    };
+    char buf[16];
+    for (uint8_t k = 0; k < CARE_KINDS; k++) {
+        const CareKindStats& c = care.kind[k];
+        int y = 80 + k * 24;
+        _canvas.drawString(KINDS[k], 40, y);
+
+        // Mean answer time as m:ss, or h:mm past an hour
+        uint32_t s = c.ewmaMs / 1000UL;
+        if (c.answered == 0) {
+            snprintf(buf, sizeof(buf), "-");
+        } else if (s < 3600) {
+            snprintf(buf, sizeof(buf), "%lu:%02lu", (unsigned long)(s / 60), (unsigned long)(s % 60));
+        } else {
+            snprintf(buf, sizeof(buf), "%luh%02lu", (unsigned long)(s / 3600), (unsigned long)(s / 60 % 60));
+        }
+        _canvas.drawString(buf, 118, y);
+
+        if (c.recentOutcomes() == 0) {
+            snprintf(buf, sizeof(buf), "-");
+        } else {
+            snprintf(buf, sizeof(buf), "%u%%", EvoOdds::percent(c.recentMissQ15()));
+        }
+        _canvas.drawString(buf, 170, y);
+
+        // Bars scaled to this row's tallest bucket
+        uint16_t most = 0;
+        for (uint16_t n : c.hist) most = n > most ? n : most;
+        for (uint8_t b = 0; b < CARE_BUCKETS; b++) {
+            int h = most ? (int)((uint32_t)c.hist[b] * 16 / most) : 0;
+            int bx = 210 + b * 9;
+            _canvas.drawFastHLine(bx, y + 8, 8, COL_DARK);
+            if (h > 0) _canvas.fillRect(bx, y + 8 - h, 8, h, COL_DARK);
+        }
+    }
+
+    _canvas.setTextDatum(MC_DATUM);
+    _canvas.setTextColor(COL_DARK, COL_BG);
+    // "B: もどる"
+    _canvas.drawString("B: \xe3\x82\x82\xe3\x81\xa9\xe3\x82\x8b", SCREEN_W / 2, 232);
     flush();
 }
 
@@ -430,6 +690,75 @@ void DisplayManager::drawDeathScreen(uint8_t cause) {
     flush();
 }
 
+void DisplayManager::drawGraveyard(const GraveIndex& index, const GraveRecord* best,
+                                   const GraveRecord* rows, uint8_t rowCount, uint32_t newest) {
+    // "ほうち", "びょうき", "じゅみょう"
+    static const char* const CAUSES[] = {
+        "\xe3\x81\xbb\xe3\x81\x86\xe3\x81\xa1",
+        "\xe3\x81\xb3\xe3\x82\x87\xe3\x81\x86\xe3\x81\x8d",
+        "\xe3\x81\x98\xe3\x82\x85\xe3\x81\xbf\xe3\x82\x87\xe3\x81\x86"
+    };
+    auto nameOf = [](const GraveRecord& r) {
+        CharacterID form = r.finalForm();
+        return form == CharacterID::NONE ? "???" : getCharacterDef(form).nameJP;
+    };
+
+    _canvas.fillSprite(COL_BG);
+    _canvas.fillRect(20, 15, 280, 210, COL_WHITE);
+    _canvas.drawRect(20, 15, 280, 210, COL_BLACK);
+    _canvas.setTextColor(COL_BLACK, COL_WHITE);
+    char buf[80];
+
+    // "おはか" and "N ひき"
+    setFontMedium();
+    _canvas.setTextDatum(ML_DATUM);
+    _canvas.drawString("\xe3\x81\x8a\xe3\x81\xaf\xe3\x81\x8b", 32, 32);
+    setFontSmall();
+    _canvas.setTextDatum(MR_DATUM);
+    snprintf(buf, sizeof(buf), "%lu \xe3\x81\xb2\xe3\x81\x8d", (unsigned long)index.count);
+    _canvas.drawString(buf, 288, 32);
+
+    // "さいちょう: NAME  X じかん" / "まだ いない"
+    _canvas.setTextDatum(ML_DATUM);
+    if (best) {
+        snprintf(buf, sizeof(buf), "\xe3\x81\x95\xe3\x81\x84\xe3\x81\xa1\xe3\x82\x87\xe3\x81\x86: %s  %lu \xe3\x81\x98\xe3\x81\x8b\xe3\x82\x93",
+                 nameOf(*best), (unsigned long)(best->minutes / 60));
+    } else {
+        snprintf(buf, sizeof(buf), "\xe3\x81\xbe\xe3\x81\xa0 \xe3\x81\x84\xe3\x81\xaa\xe3\x81\x84");
+    }
+    _canvas.drawString(buf, 32, 56);
+    _canvas.drawFastHLine(28, 70, 264, COL_HEART_E);
+
+    // Two lines per life: number, form and how many ended as it;
+    // age, cause, mistakes and discipline
+    int y = 86;
+    for (uint8_t i = 0; i < rowCount; i++, y += 34) {
+        const GraveRecord& r = rows[i];
+        CharacterID form = r.finalForm();
+        snprintf(buf, sizeof(buf), "#%lu %s", (unsigned long)(newest - i + 1), nameOf(r));
+        _canvas.setTextDatum(ML_DATUM);
+        _canvas.drawString(buf, 32, y);
+        snprintf(buf, sizeof(buf), "x%lu", (unsigned long)index.byForm[static_cast<uint8_t>(form)]);
+        _canvas.setTextDatum(MR_DATUM);
+        _canvas.drawString(buf, 288, y);
+
+        // "X じかん  CAUSE  ミス N  しつけ N%"
+        snprintf(buf, sizeof(buf), "%lu \xe3\x81\x98\xe3\x81\x8b\xe3\x82\x93  %s  \xe3\x83\x9f\xe3\x82\xb9 %u  \xe3\x81\x97\xe3\x81\xa4\xe3\x81\x91 %u%%",
+                 (unsigned long)(r.minutes / 60), r.deathCause < 3 ? CAUSES[r.deathCause] : "?",
+                 r.careMistakes, r.discipline);
+        _canvas.setTextDatum(ML_DATUM);
+        _canvas.setTextColor(COL_DARK, COL_WHITE);
+        _canvas.drawString(buf, 48, y + 15);
+        _canvas.setTextColor(COL_BLACK, COL_WHITE);
+    }
+
+    _canvas.setTextDatum(MC_DATUM);
+    _canvas.setTextColor(COL_DARK, COL_BG);
+    // "A/C: ページ  B: もどる"
+    _canvas.drawString("A/C: \xe3\x83\x9a\xe3\x83\xbc\xe3\x82\xb8  B: \xe3\x82\x82\xe3\x81\xa9\xe3\x82\x8b", SCREEN_W / 2, 232);
+    flush();
+}
+
 void DisplayManager::drawMinigame(uint8_t round, uint8_t currentNum, uint8_t wins,
                                    uint8_t lastResult, bool showResult) {
     _canvas.fillSprite(COL_BG);
@@ -470,3 +799,165 @@ void DisplayManager::drawMinigame(uint8_t round, uint8_t currentNum, uint8_t win
     }
     flush();
 }
+
+// ========== Ambient clock ==========
+
+void DisplayManager::drawAmbient(const PetData& pet, uint8_t hour, uint8_t minute, bool full) {
+    int8_t digits[4] = {(int8_t)(hour / 10), (int8_t)(hour % 10),
+                        (int8_t)(minute / 10), (int8_t)(minute % 10)};
+
+    if (full) {
+        _canvas.fillSprite(TFT_BLACK);
+        _canvas.fillRect(AMBIENT_CLOCK_X + 2 * AMBIENT_DIGIT_W + AMBIENT_COLON_W / 2 - 3,
+                         AMBIENT_CLOCK_Y + AMBIENT_DIGIT_H / 3, 6, 6, COL_AMBIENT);
+        _canvas.fillRect(AMBIENT_CLOCK_X + 2 * AMBIENT_DIGIT_W + AMBIENT_COLON_W / 2 - 3,
+                         AMBIENT_CLOCK_Y + AMBIENT_DIGIT_H * 2 / 3, 6, 6, COL_AMBIENT);
+        for (int i = 0; i < 4; i++) _ambientDigits[i] = -1;
+        _ambientGlyph = CharacterID::NONE;
+    }
+
+    _canvas.setFont(&fonts::Font7);  // 7-segment digits
+    _canvas.setTextColor(COL_AMBIENT, TFT_BLACK);
+    _canvas.setTextDatum(MC_DATUM);
+    for (int i = 0; i < 4; i++) {
+        if (digits[i] == _ambientDigits[i]) continue;
+        _ambientDigits[i] = digits[i];
+        int dx = AMBIENT_CLOCK_X + i * AMBIENT_DIGIT_W + (i >= 2 ? AMBIENT_COLON_W : 0);
+        char buf[2] = {(char)('0' + digits[i]), '\0'};
+        _canvas.fillRect(dx, AMBIENT_CLOCK_Y, AMBIENT_DIGIT_W, AMBIENT_DIGIT_H, TFT_BLACK);
+        _canvas.drawString(buf, dx + AMBIENT_DIGIT_W / 2, AMBIENT_CLOCK_Y + AMBIENT_DIGIT_H / 2);
+        if (!full) flushRect(dx, AMBIENT_CLOCK_Y, AMBIENT_DIGIT_W, AMBIENT_DIGIT_H);
+    }
+
+    if (pet.characterId != _ambientGlyph) {
+        _ambientGlyph = pet.characterId;
+        // Half-scale sprite: sample every other pixel of the 48x48 bitmap
+        const uint8_t* spr = getSpriteForCharacter(pet.characterId);
+        int gx = SCREEN_W / 2 - SPRITE_W / 4;
+        const SpriteRuns& runs = decodeSprite(spr, 1);
+        if (runs.ok) {
+            drawSpriteRuns(gx, AMBIENT_GLYPH_Y, runs, COL_AMBIENT, TFT_BLACK);
+        } else {
+            int bytesPerRow = SPRITE_W / 8;
+            for (int row = 0; row < SPRITE_H / 2; row++) {
+                for (int col = 0; col < SPRITE_W / 2; col++) {
+                    int sc = col * 2;
+                    uint8_t b = pgm_read_byte(&spr[row * 2 * bytesPerRow + sc / 8]);
+                    bool on = b & (1 << (7 - sc % 8));
+                    _canvas.drawPixel(gx + col, AMBIENT_GLYPH_Y + row, on ? COL_AMBIENT : TFT_BLACK);
+                }
+            }
+        }
+        if (!full) flushRect(gx, AMBIENT_GLYPH_Y, SPRITE_W / 2, SPRITE_H / 2);
+    }
+
+    if (full) flush();
+}
+
+// ========== Pet select ==========
+
+void DisplayManager::setRosterBadge(uint8_t activeSlot, uint8_t usedMask, uint8_t callingMask) {
+    _badgeActive = activeSlot;
+    _badgeUsed = usedMask;
+    _badgeCalling = callingMask;
+}
+
+// Everything a tile shows, packed; a tile is repainted when this changes
+static uint32_t tileKey(const PetData* pet, bool selected) {
+    uint32_t key = selected ? 1u : 0u;
+    if (!pet) return key;
+    bool calling = pet->pendingAttention != AttentionType::NONE &&
+                   pet->pendingAttention != AttentionType::SLEEP;
+    key |= 2u;
+    key |= (uint32_t)static_cast<uint8_t>(pet->characterId) << 2;
+    key |= (uint32_t)(pet->hunger & 7) << 10;
+    key |= (uint32_t)(pet->happiness & 7) << 13;
+    key |= (uint32_t)(pet->poopCount & 7) << 16;
+    key |= (pet->isSick ? 1u : 0u) << 19;
+    key |= (pet->isAsleep ? 1u : 0u) << 20;
+    key |= (pet->isDead ? 1u : 0u) << 21;
+    key |= (calling ? 1u : 0u) << 22;
+    return key;
+}
+
+void DisplayManager::drawPetTile(uint8_t slot, const PetData* pet, bool selected) {
+    int tx = (slot % 2) * TILE_W;
+    int ty = TILE_TOP + (slot / 2) * TILE_H;
+    uint16_t bg = (pet && pet->isDead) ? TFT_BLACK : COL_PET_BG;
+    _canvas.fillRect(tx, ty, TILE_W, TILE_H, COL_BG);
+    _canvas.fillRect(tx + 4, ty + 4, TILE_W - 8, TILE_H - 8, bg);
+    if (selected) {
+        _canvas.drawRect(tx + 1, ty + 1, TILE_W - 2, TILE_H - 2, COL_ICON_SEL);
+        _canvas.drawRect(tx + 2, ty + 2, TILE_W - 4, TILE_H - 4, COL_ICON_SEL);
+    } else {
+        _canvas.drawRect(tx + 3, ty + 3, TILE_W - 6, TILE_H - 6, COL_DARK);
+    }
+
+    setFontSmall();
+    _canvas.setTextDatum(MC_DATUM);
+    if (!pet) {
+        _canvas.setTextColor(COL_DARK, bg);
+        // "+ たまご"
+        _canvas.drawString("+ \xe3\x81\x9f\xe3\x81\xbe\xe3\x81\x94", tx + TILE_W / 2, ty + TILE_H / 2);
+        return;
+    }
+
+    drawPetSprite(tx + 32, ty + 32, pet->isDead ? CharacterID::GHOST : pet->characterId, bg);
+    if (pet->isAsleep && !pet->isDead) {
+        drawSprite1bit(tx + 50, ty + 10, 8, 8, SPR_ZZZ, COL_DARK, bg);
+    }
+    _canvas.setTextColor(pet->isDead ? TFT_WHITE : COL_BLACK, bg);
+    _canvas.drawString(getCharacterDef(pet->characterId).nameJP, tx + TILE_W / 2, ty + TILE_H - 18);
+    if (pet->isDead || pet->stage == LifeStage::EGG) return;
+
+    // Mini status card: おなか and ごきげん hearts, then poop / sick / call
+    int x = tx + 64, y = ty + 8;
+    _canvas.fillRect(x, y, TILE_W - 72, 50, COL_WHITE);
+    _canvas.setTextColor(COL_BLACK, COL_WHITE);
+    _canvas.setTextDatum(ML_DATUM);
+    _canvas.drawString("\xe9\xa3\x9f", x + 4, y + 9);   // 食
+    drawHearts(x + 22, y + 5, pet->hunger, MAX_HUNGER, COL_HEART);
+    _canvas.drawString("\xe9\x81\x8a", x + 4, y + 25);  // 遊
+    drawHearts(x + 22, y + 21, pet->happiness, MAX_HAPPY, COL_HEART);
+    if (pet->poopCount > 0) {
+        char buf[8];
+        drawSprite1bit(x + 4, y + 35, 12, 12, SPR_POOP, COL_POOP, COL_WHITE);
+        snprintf(buf, sizeof(buf), "%d", pet->poopCount);
+        _canvas.drawString(buf, x + 18, y + 41);
+    }
+    if (pet->isSick) {
+        drawSprite1bit(x + 34, y + 35, 12, 12, SPR_SKULL, COL_SICK, COL_WHITE);
+    }
+    if (pet->pendingAttention != AttentionType::NONE &&
+        pet->pendingAttention != AttentionType::SLEEP) {
+        drawSprite1bit(x + 56, y + 33, 8, 16, SPR_ATTENTION, COL_HEART, COL_WHITE);
+    }
+}
+
+void DisplayManager::drawPetSelect(const PetData* const* pets, uint8_t cursor, bool full) {
+    if (full) {
+        _canvas.fillSprite(COL_BG);
+        _canvas.setTextColor(COL_BLACK, COL_BG);
+        _canvas.setTextDatum(MC_DATUM);
+        setFontMedium();
+        // "ペットをえらぶ"
+        _canvas.drawString("\xe3\x83\x9a\xe3\x83\x83\xe3\x83\x88\xe3\x82\x92\xe3\x81\x88\xe3\x82\x89\xe3\x81\xb6",
+                           SCREEN_W / 2, TILE_TOP / 2);
+        setFontSmall();
+        _canvas.setTextColor(COL_DARK, COL_BG);
+        // "A/C:えらぶ  B:決定"
+        _canvas.drawString("A/C:\xe3\x81\x88\xe3\x82\x89\xe3\x81\xb6  B:\xe6\xb1\xba\xe5\xae\x9a",
+                           SCREEN_W / 2, (TILE_TOP + 2 * TILE_H + SCREEN_H) / 2);
+        for (uint8_t s = 0; s < MAX_PETS; s++) _tileKeys[s] = 0xFFFFFFFFu;
+    }
+
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        uint32_t key = tileKey(pets[s], s == cursor);
+        if (key == _tileKeys[s]) continue;
+        _tileKeys[s] = key;
+        drawPetTile(s, pets[s], s == cursor);
+        if (!full) flushRect((s % 2) * TILE_W, TILE_TOP + (s / 2) * TILE_H, TILE_W, TILE_H);
+    }
+
+    if (full) flush();
+}
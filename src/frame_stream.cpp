@@ -0,0 +1,133 @@
+#include "frame_stream.h"
+#include <Arduino.h>
+
+static constexpr uint8_t FRAME_END = 0xFF;
+
+bool FrameStreamer::start() {
+    if (!_ref) {
+        size_t size = (size_t)SCREEN_W * SCREEN_H;
+#ifdef ARDUINO_ARCH_ESP32
+        _ref = static_cast<uint8_t*>(ps_malloc(size));  // keep DRAM for the canvas
+        if (!_ref) _ref = static_cast<uint8_t*>(malloc(size));
+#else
+        _ref = static_cast<uint8_t*>(malloc(size));
+#endif
+        if (!_ref) return false;
+    }
+    _txLen = 0;
+    _row = -1;
+    _framesSent = 0;
+    _bytesSent = 0;
+    requestKeyframe();
+    return true;
+}
+
+void FrameStreamer::stop() {
+    free(_ref);
+    _ref = nullptr;
+    _row = -1;
+    _txLen = 0;
+}
+
+void FrameStreamer::requestKeyframe() {
+    _keyNext = true;
+    _pending = (_latest != nullptr);
+}
+
+void FrameStreamer::onFrame(const uint8_t* pixels, int w, int h) {
+    if (w != SCREEN_W || h != SCREEN_H) return;
+    _latest = pixels;
+    _w = w;
+    _h = h;
+    _pending = true;
+}
+
+void FrameStreamer::drainTx() {
+    if (_txLen == 0) return;
+    int room = Serial.availableForWrite();
+    if (room <= 0) return;
+    int n = (room < _txLen) ? room : _txLen;
+    n = (int)Serial.write(_tx, n);
+    if (n <= 0) return;
+    memmove(_tx, _tx + n, _txLen - n);
+    _txLen -= n;
+    _bytesSent += n;
+}
+
+void FrameStreamer::encodeRow(int row) {
+    const uint8_t* cur = _latest + row * _w;
+    uint8_t* ref = _ref + row * _w;
+
+    put((uint8_t)row);
+    int x = 0;
+    while (x < _w) {
+        uint8_t d = cur[x] ^ ref[x];
+        int n = 1;
+        if (d == 0) {
+            while (x + n < _w && n < 128 && cur[x + n] == ref[x + n]) n++;
+            put((uint8_t)(n - 1));
+            x += n;
+            continue;
+        }
+        while (x + n < _w && n < 64 && (uint8_t)(cur[x + n] ^ ref[x + n]) == d) n++;
+        if (n >= 3) {
+            put((uint8_t)(0x80 + n - 1));
+            put(d);
+            x += n;
+            continue;
+        }
+        // Literal span: stop at an unchanged pixel or the start of a repeat run
+        int start = x;
+        n = 0;
+        while (x < _w && n < 64) {
+            uint8_t e = cur[x] ^ ref[x];
+            if (e == 0) break;
+            if (n > 0 && x + 2 < _w &&
+                (uint8_t)(cur[x + 1] ^ ref[x + 1]) == e &&
+                (uint8_t)(cur[x + 2] ^ ref[x + 2]) == e) break;
+            x++;
+            n++;
+        }
+        put((uint8_t)(0xC0 + n - 1));
+        for (int i = start; i < start + n; i++) put(cur[i] ^ ref[i]);
+    }
+    memcpy(ref, cur, _w);
+}
+
+void FrameStreamer::pump() {
+    if (!_ref) return;
+    drainTx();
+
+    while (_latest) {
+        if (_row < 0) {
+            if (!_pending || txFree() < 8) break;
+            _pending = false;
+            if (_keyNext) {
+                // Viewer clears its frame on 'K', so the XOR is the full image
+                memset(_ref, 0, (size_t)_w * _h);
+                _keyNext = false;
+                put(0xA5); put(0x5A); put('K'); put(_seq++);
+            } else {
+                put(0xA5); put(0x5A); put('F'); put(_seq++);
+            }
+            put(_w & 0xFF); put(_w >> 8);
+            put(_h & 0xFF); put(_h >> 8);
+            _row = 0;
+        }
+        if (_row >= _h) {
+            if (txFree() < 1) break;
+            put(FRAME_END);
+            _row = -1;
+            _framesSent++;
+            continue;
+        }
+        if (memcmp(_latest + _row * _w, _ref + _row * _w, _w) == 0) {
+            _row++;
+            continue;
+        }
+        if (txFree() < MAX_ROW_BYTES) break;
+        encodeRow(_row++);
+    }
+
+    drainTx();
+}
@@ -1,5 +1,47 @@
 #include "game_state.h"
 #include "config.h"
+#include <cstddef>
+#include <cstdio>
+
+// "petdata", "petdata1", ... (NVS keys are at most 15 characters)
+static const char* slotKey(char* buf, size_t size, const char* base, uint8_t slot) {
+    if (slot == 0) return base;
+    snprintf(buf, size, "%s%u", base, (unsigned)slot);
+    return buf;
+}
+
+// Bytes of PetData a save version stored: each one appended fields
+static size_t savedSize(uint8_t version) {
+    switch (version) {
+        case 1:  return offsetof(PetData, rng);
+        case 2:  return offsetof(PetData, lastForm);
+        case 3:  return offsetof(PetData, poopSinceMs);
+        case SAVE_VERSION: return sizeof(PetData);
+        default: return 0;
+    }
+}
+
+// Save version of a slot. Slot 0's key is the one every slot shared
+// before versions were kept per slot, so older slots fall back to it.
+static uint8_t slotVersion(Preferences& prefs, uint8_t slot) {
+    char key[16];
+    const char* own = slotKey(key, sizeof(key), "version", slot);
+    return prefs.getUChar(prefs.isKey(own) ? own : "version", 0);
+}
+
+static void putSlotVersion(Preferences& prefs, uint8_t slot, uint8_t version) {
+    char key[16];
+    if (slot == 0) {
+        // Pin the shared version on older slots before slot 0 changes it
+        uint8_t shared = prefs.getUChar("version", 0);
+        for (uint8_t s = 1; s < MAX_PETS; s++) {
+            if (!prefs.isKey(slotKey(key, sizeof(key), "petdata", s))) continue;
+            const char* own = slotKey(key, sizeof(key), "version", s);
+            if (!prefs.isKey(own)) prefs.putUChar(own, shared);
+        }
+    }
+    prefs.putUChar(slotKey(key, sizeof(key), "version", slot), version);
+}
 
 void StateMachine::init() {
     _current = GameState::TITLE_SCREEN;
@@ -18,35 +60,85 @@ bool StateMachine::hasSaveData() {
     return (magic == SAVE_MAGIC);
 }
 
-void StateMachine::saveGame(const PetData& pet) {
+void StateMachine::saveGame(const PetData& pet, uint8_t slot) {
+    char key[16];
     _prefs.begin(NVS_NAMESPACE, false);
     _prefs.putUInt("magic", SAVE_MAGIC);
-    _prefs.putUChar("version", SAVE_VERSION);
-    _prefs.putBytes("petdata", &pet, sizeof(PetData));
-    _prefs.putULong("save_ms", millis());
+    putSlotVersion(_prefs, slot, SAVE_VERSION);
+    _prefs.putBytes(slotKey(key, sizeof(key), "petdata", slot), &pet, sizeof(PetData));
+    _prefs.putULong(slotKey(key, sizeof(key), "save_ms", slot), _clock->nowMs());
+    _prefs.putULong(slotKey(key, sizeof(key), "save_rtc", slot), _clock->wallSeconds());
     _prefs.end();
 }
 
-bool StateMachine::loadGame(PetData& pet) {
+bool StateMachine::loadGame(PetData& pet, uint8_t slot) {
+    char key[16];
     _prefs.begin(NVS_NAMESPACE, true);
     uint32_t magic = _prefs.getUInt("magic", 0);
-    uint8_t ver = _prefs.getUChar("version", 0);
-    if (magic != SAVE_MAGIC || ver != SAVE_VERSION) {
+    uint8_t ver = slotVersion(_prefs, slot);
+    if (magic != SAVE_MAGIC || ver < 1 || ver > SAVE_VERSION) {
         _prefs.end();
         return false;
     }
-    size_t len = _prefs.getBytes("petdata", &pet, sizeof(PetData));
-    unsigned long savedMs = _prefs.getULong("save_ms", 0);
+    pet = PetData();
+    size_t len = _prefs.getBytes(slotKey(key, sizeof(key), "petdata", slot), &pet, sizeof(PetData));
+    uint32_t savedMs  = _prefs.getULong(slotKey(key, sizeof(key), "save_ms", slot), 0);
+    uint32_t savedRtc = _prefs.getULong(slotKey(key, sizeof(key), "save_rtc", slot), 0);
     _prefs.end();
 
-    if (len != sizeof(PetData)) return false;
+    if (len != savedSize(ver)) return false;
+    // v1 had no rng: give the pet a fresh stream. Fields added later keep
+    // their defaults (a v2 pet that died does not know what it was).
+    if (ver == 1) pet.rng.seed(savedMs ^ (savedRtc * 2654435761u));
+    if (ver < 3 && pet.isDead) pet.diedMs = savedMs;
+
+    unsigned long now = _clock->nowMs();
+    uint32_t nowRtc = _clock->wallSeconds();
+    if (savedRtc == 0 || nowRtc == 0 || nowRtc < savedRtc) {
+        resetTimers(pet, now);  // no trustworthy wall clock: resume as saved
+        return true;
+    }
+
+    // The clock restarted at boot, but each timer's distance from the save
+    // is still valid. Shift them so the save happened offlineMs ago.
+    uint32_t offlineS = nowRtc - savedRtc;
+    if (offlineS > OFFLINE_CATCHUP_MAX_S) offlineS = OFFLINE_CATCHUP_MAX_S;
+    uint32_t offlineMs = offlineS * 1000UL;
+    unsigned long saveAt = now - offlineMs;
+    unsigned long shift  = saveAt - savedMs;
+    pet.lastHungerDecayMs += shift;
+    pet.lastHappyDecayMs  += shift;
+    pet.lastPoopMs        += shift;
+    pet.lastAgeTickMs     += shift;
+    pet.lastSickCheckMs   += shift;
+    pet.lastDisciplineMs  += shift;
+    pet.stageStartMs      += shift;
+    pet.attentionStartMs  += shift;
+    if (pet.isDead) pet.diedMs += shift;
+    pet.poopSinceMs       += shift;
 
-    // Recalibrate ALL timers to current millis()
-    // IMPORTANT: After reboot, millis() resets to 0.
-    // savedMs was from previous boot's millis(), so we CANNOT compute
-    // meaningful elapsed time. Just reset everything to "now" and
-    // preserve the pet's current stats as-is (no offline decay).
-    unsigned long now = millis();
+    // Replay the gap as if the device had been left running unattended
+    unsigned long t0 = micros();
+    PetManager sim;
+    sim.setJournal(_journal, slot);
+    sim.loadFromSave(pet);
+    if (_journal) _journal->setBlocking(true);  // a week away outgrows the ring
+    sim.simulateOffline(saveAt, offlineMs, nowRtc - offlineS);
+    if (_journal) {
+        _journal->setBlocking(false);
+        _journal->pump(true);
+    }
+    pet = sim.data();
+    Serial.printf("[SAVE] caught up %lus offline in %luus\n",
+                  (unsigned long)offlineS, micros() - t0);
+    return true;
+}
+
+// Old behaviour when offline time is unknown: every timer restarts now
+void StateMachine::resetTimers(PetData& pet, unsigned long now) {
+    // Recalibrate ALL timers to the current clock
+    // The clock resets to 0 after reboot, so saved timestamps are
+    // meaningless without the RTC. Preserve the pet's stats as-is.
     pet.lastHungerDecayMs = now;
     pet.lastHappyDecayMs  = now;
     pet.lastPoopMs        = now;
@@ -55,6 +147,8 @@ bool StateMachine::loadGame(PetData& pet) {
     pet.lastDisciplineMs  = now;
     pet.stageStartMs      = now;
     pet.attentionStartMs  = now;
+    if (pet.isDead) pet.diedMs = now;
+    pet.poopSinceMs       = now;
 
     // Clear any pending attention to prevent immediate death check
     // (attentionStartMs was from a previous boot and is now invalid)
@@ -66,8 +160,16 @@ bool StateMachine::loadGame(PetData& pet) {
 
     // Make sure readyToEvolve is false on load to prevent immediate evolution
     pet.readyToEvolve = false;
+}
 
-    return true;
+void StateMachine::clearSlot(uint8_t slot) {
+    char key[16];
+    _prefs.begin(NVS_NAMESPACE, false);
+    _prefs.remove(slotKey(key, sizeof(key), "petdata", slot));
+    _prefs.remove(slotKey(key, sizeof(key), "save_ms", slot));
+    _prefs.remove(slotKey(key, sizeof(key), "save_rtc", slot));
+    if (slot != 0) _prefs.remove(slotKey(key, sizeof(key), "version", slot));
+    _prefs.end();
 }
 
 void StateMachine::clearSave() {
@@ -75,3 +177,29 @@ void StateMachine::clearSave() {
     _prefs.clear();
     _prefs.end();
 }
+
+bool StateMachine::readRaw(uint8_t slot, RawSave& out) {
+    char key[16];
+    _prefs.begin(NVS_NAMESPACE, true);
+    uint32_t magic = _prefs.getUInt("magic", 0);
+    out = RawSave();
+    out.version = slotVersion(_prefs, slot);
+    size_t len = _prefs.getBytes(slotKey(key, sizeof(key), "petdata", slot), &out.pet, sizeof(PetData));
+    out.savedMs  = _prefs.getULong(slotKey(key, sizeof(key), "save_ms", slot), 0);
+    out.savedRtc = _prefs.getULong(slotKey(key, sizeof(key), "save_rtc", slot), 0);
+    _prefs.end();
+    if (magic != SAVE_MAGIC) return false;
+    return len != 0 && len == savedSize(out.version);
+}
+
+void StateMachine::writeRaw(uint8_t slot, const RawSave& in) {
+    char key[16];
+    size_t len = savedSize(in.version);
+    _prefs.begin(NVS_NAMESPACE, false);
+    _prefs.putUInt("magic", SAVE_MAGIC);
+    putSlotVersion(_prefs, slot, in.version);
+    _prefs.putBytes(slotKey(key, sizeof(key), "petdata", slot), &in.pet, len);
+    _prefs.putULong(slotKey(key, sizeof(key), "save_ms", slot), in.savedMs);
+    _prefs.putULong(slotKey(key, sizeof(key), "save_rtc", slot), in.savedRtc);
+    _prefs.end();
+}
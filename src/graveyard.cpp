@@ -0,0 +1,142 @@
+#include "graveyard.h"
+#include <Arduino.h>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+// Written files must survive a power cut before the next step relies on them
+static void commit(FILE* f) {
+    fflush(f);
+#ifndef STAGOTCHI_HOST
+    fsync(fileno(f));  // LittleFS commits on sync, not on fflush
+#endif
+}
+
+bool Graveyard::open(const char* path) {
+    _path[0] = '\0';
+    if (strlen(path) >= sizeof(_path)) return false;
+    strcpy(_path, path);
+
+    char idx[sizeof(_path) + 4];
+    snprintf(idx, sizeof(idx), "%s.idx", _path);
+    uint8_t buf[GRAVE_INDEX_BYTES + 1];
+    size_t got = 0;
+    if (FILE* f = fopen(idx, "rb")) {
+        got = fread(buf, 1, sizeof(buf), f);
+        fclose(f);
+    }
+    if (!graveIndexDecode(buf, got, _index)) _index = GraveIndex();
+
+    // Whole records in the log; a torn one at the end is overwritten by the next burial
+    uint32_t records = 0;
+    FILE* log = fopen(_path, "rb");
+    if (log) {
+        fseek(log, 0, SEEK_END);
+        records = (uint32_t)((size_t)ftell(log) / GRAVE_RECORD_BYTES);
+    }
+    uint32_t indexed = _index.count;
+    if (indexed > records) _index = GraveIndex();  // not this log's
+    uint32_t from = _index.count;
+    if (_index.count < records) {
+        // Lives buried after the index was last written: add them from the log
+        fseek(log, (long)_index.count * GRAVE_RECORD_BYTES, SEEK_SET);
+        uint8_t rec[GRAVE_RECORD_BYTES];
+        GraveRecord r;
+        while (_index.count < records && fread(rec, 1, sizeof(rec), log) == sizeof(rec)) {
+            if (graveDecode(rec, r)) {
+                _index.add(r);
+            } else {
+                _index.addDamaged();
+            }
+        }
+    }
+    if (log) fclose(log);
+    if (_index.count != indexed) writeIndex();
+
+    Serial.printf("[GRAVES] %s (%lu lives, %lu indexed from the log)\n", _path,
+                  (unsigned long)_index.count, (unsigned long)(_index.count - from));
+    return true;
+}
+
+GraveRecord Graveyard::recordFor(const PetData& pet, unsigned long nowMs, uint32_t wallNow) {
+    GraveRecord r;
+    long sinceTick = (long)(pet.diedMs - pet.lastAgeTickMs);
+    uint32_t lifeSec = pet.totalAge * 3600UL + (sinceTick > 0 ? (uint32_t)sinceTick / 1000UL : 0);
+    r.minutes = lifeSec / 60;
+    if (wallNow != 0) {
+        long agoMs = (long)(nowMs - pet.diedMs);
+        r.endWall = wallNow - (agoMs > 0 ? (uint32_t)agoMs / 1000UL : 0);
+        r.startWall = r.endWall > lifeSec ? r.endWall - lifeSec : 0;
+    }
+    r.careMistakes = pet.totalCareMistakes;
+    r.discipline   = pet.discipline;
+    r.deathCause   = pet.deathCause;
+    r.weight       = pet.weight;
+
+    // The rules form a tree, so walking back from the last form gives the path
+    CharacterID back[GRAVE_PATH_LEN];
+    uint8_t n = 0;
+    for (CharacterID c = pet.lastForm; c != CharacterID::NONE && n < GRAVE_PATH_LEN; c = evolutionParent(c)) {
+        back[n++] = c;
+    }
+    for (uint8_t i = 0; i < n; i++) r.path[i] = back[n - 1 - i];
+    return r;
+}
+
+bool Graveyard::bury(const PetData& pet, unsigned long nowMs, uint32_t wallNow) {
+    if (!isOpen() || !pet.isDead) return false;
+    GraveRecord r = recordFor(pet, nowMs, wallNow);
+    uint8_t rec[GRAVE_RECORD_BYTES];
+    graveEncode(r, rec);
+
+    FILE* f = fopen(_path, "r+b");
+    if (!f) f = fopen(_path, "wb");
+    if (!f) return false;
+    fseek(f, (long)_index.count * GRAVE_RECORD_BYTES, SEEK_SET);
+    bool ok = fwrite(rec, 1, sizeof(rec), f) == sizeof(rec);
+    commit(f);
+    fclose(f);
+    if (!ok) return false;
+
+    _index.add(r);
+    writeIndex();
+    Serial.printf("[GRAVES] life %lu: %lu min, cause %u\n", (unsigned long)(_index.count - 1),
+                  (unsigned long)r.minutes, r.deathCause);
+    return true;
+}
+
+bool Graveyard::writeIndex() {
+    char idx[sizeof(_path) + 4], tmp[sizeof(_path) + 8];
+    snprintf(idx, sizeof(idx), "%s.idx", _path);
+    snprintf(tmp, sizeof(tmp), "%s.idx.tmp", _path);
+    uint8_t buf[GRAVE_INDEX_BYTES];
+    graveIndexEncode(_index, buf);
+    FILE* f = fopen(tmp, "wb");
+    if (!f) return false;
+    bool ok = fwrite(buf, 1, sizeof(buf), f) == sizeof(buf);
+    commit(f);
+    fclose(f);
+    // Lost between the two: the next open rebuilds it from the log
+    remove(idx);
+    return ok && rename(tmp, idx) == 0;
+}
+
+bool Graveyard::best(GraveRecord& out) const {
+    return _index.best != GRAVE_NONE && read(_index.best, &out, 1) == 1;
+}
+
+uint8_t Graveyard::read(uint32_t first, GraveRecord* out, uint8_t max) const {
+    if (!isOpen() || first >= _index.count) return 0;
+    uint32_t left = _index.count - first;
+    uint8_t n = left < max ? (uint8_t)left : max;
+    FILE* f = fopen(_path, "rb");
+    if (!f) return 0;
+    fseek(f, (long)first * GRAVE_RECORD_BYTES, SEEK_SET);
+    uint8_t rec[GRAVE_RECORD_BYTES];
+    uint8_t got = 0;
+    while (got < n && fread(rec, 1, sizeof(rec), f) == sizeof(rec)) {
+        graveDecode(rec, out[got++]);
+    }
+    fclose(f);
+    return got;
+}
@@ -0,0 +1,216 @@
+#include "history.h"
+#include <Preferences.h>
+#include <cstdio>
+
+namespace {
+
+constexpr uint8_t  HISTORY_VERSION = 1;
+constexpr uint16_t MINUTES_PER_DAY = 24 * 60;
+
+void historyKey(char* buf, size_t size, uint8_t slot) {
+    snprintf(buf, size, "slot%u", slot);
+}
+
+// Minutes since the egg was laid, by the pet's own age clock. The part
+// within the hour stops at 59: the age timer restarts without ticking on
+// a boot with no RTC or after a long pause, and the minute must not run
+// past the next hour's first one.
+uint32_t lifeMinute(const PetData& pet, unsigned long nowMs) {
+    long sinceTick = (long)(nowMs - pet.lastAgeTickMs);
+    uint32_t inHour = sinceTick > 0 ? (uint32_t)sinceTick / 60000UL : 0;
+    return pet.totalAge * 60UL + (inHour < 59 ? inHour : 59);
+}
+
+StatSample toSample(const PetData& pet) {
+    StatSample s;
+    s.v[static_cast<uint8_t>(StatSeries::HUNGER)]     = pet.hunger * 100 / MAX_HUNGER;
+    s.v[static_cast<uint8_t>(StatSeries::HAPPINESS)]  = pet.happiness * 100 / MAX_HAPPY;
+    s.v[static_cast<uint8_t>(StatSeries::DISCIPLINE)] = pet.discipline;
+    s.v[static_cast<uint8_t>(StatSeries::WEIGHT)]     = pet.weight;
+    return s;
+}
+
+template <typename Sum>
+StatSample mean(const Sum* sum, uint16_t count) {
+    StatSample s;
+    for (uint8_t k = 0; k < STAT_SERIES; k++) s.v[k] = (uint8_t)((sum[k] + count / 2) / count);
+    return s;
+}
+
+}  // namespace
+
+void StatHistory::load() {
+    Preferences prefs;
+    prefs.begin(HISTORY_NVS_NAMESPACE, true);
+    bool current = prefs.getUChar("version", 0) == HISTORY_VERSION;
+    char key[16];
+    for (uint8_t i = 0; i < MAX_PETS; i++) {
+        historyKey(key, sizeof(key), i);
+        if (!current || prefs.getBytes(key, &_slots[i], sizeof(Slot)) != sizeof(Slot)) _slots[i] = Slot();
+    }
+    prefs.end();
+    _dirty = 0;
+}
+
+void StatHistory::save() {
+    if (!_dirty) return;
+    Preferences prefs;
+    prefs.begin(HISTORY_NVS_NAMESPACE, false);
+    prefs.putUChar("version", HISTORY_VERSION);
+    char key[16];
+    for (uint8_t i = 0; i < MAX_PETS; i++) {
+        if (!(_dirty & (1u << i))) continue;
+        historyKey(key, sizeof(key), i);
+        if (_slots[i].lastMinute == UINT32_MAX) {
+            prefs.remove(key);
+        } else {
+            prefs.putBytes(key, &_slots[i], sizeof(Slot));
+        }
+    }
+    prefs.end();
+    _dirty = 0;
+}
+
+void StatHistory::clear(uint8_t slot) {
+    _slots[slot] = Slot();
+    _dirty |= 1u << slot;
+}
+
+void StatHistory::sample(uint8_t slot, const PetData& pet, unsigned long nowMs) {
+    Slot& s = _slots[slot];
+    uint32_t minute = lifeMinute(pet, nowMs);
+    // A restarted age timer reads earlier minutes again; wait for it to
+    // catch up. New pets start from clear().
+    if (s.lastMinute != UINT32_MAX && minute <= s.lastMinute) return;
+
+    if (s.lastMinute != UINT32_MAX) {
+        uint32_t gap = minute - s.lastMinute - 1;
+        if (gap >= (uint32_t)HISTORY_DAYS * MINUTES_PER_DAY) {
+            // Longer than anything kept: start over from here
+            s = Slot();
+        } else {
+            // The device was off or busy; hold the last value through it
+            for (uint32_t m = s.lastMinute + 1; m < minute; m++) {
+                s.lastMinute = m;
+                push(s, s.last);
+            }
+        }
+    }
+    s.lastMinute = minute;
+    s.last = toSample(pet);
+    push(s, s.last);
+    _dirty |= 1u << slot;
+}
+
+void StatHistory::push(Slot& s, const StatSample& v) {
+    s.minutes[s.minuteRing.head] = v;
+    s.minuteRing.head = (s.minuteRing.head + 1) % HISTORY_MINUTES;
+    if (s.minuteRing.count < HISTORY_MINUTES) s.minuteRing.count++;
+
+    for (uint8_t k = 0; k < STAT_SERIES; k++) {
+        s.hourSum[k] += v.v[k];
+        s.daySum[k] += v.v[k];
+    }
+    s.hourCount++;
+    s.dayCount++;
+
+    // Close the hour / day when this was its last minute
+    if (s.lastMinute % 60 == 59) {
+        s.hours[s.hourRing.head] = mean(s.hourSum, s.hourCount);
+        s.hourRing.head = (s.hourRing.head + 1) % HISTORY_HOURS;
+        if (s.hourRing.count < HISTORY_HOURS) s.hourRing.count++;
+        for (uint16_t& sum : s.hourSum) sum = 0;
+        s.hourCount = 0;
+    }
+    if (s.lastMinute % MINUTES_PER_DAY == MINUTES_PER_DAY - 1) {
+        s.days[s.dayRing.head] = mean(s.daySum, s.dayCount);
+        s.dayRing.head = (s.dayRing.head + 1) % HISTORY_DAYS;
+        if (s.dayRing.count < HISTORY_DAYS) s.dayRing.count++;
+        for (uint32_t& sum : s.daySum) sum = 0;
+        s.dayCount = 0;
+    }
+}
+
+void StatHistory::sparkline(uint8_t slot, StatRange range, StatSeries series, Sparkline& out) const {
+    const Slot& s = _slots[slot];
+    const uint8_t k = static_cast<uint8_t>(series);
+    out.count = 0;
+    out.span = 0;
+    out.max = series == StatSeries::WEIGHT ? MAX_WEIGHT : 100;
+
+    // The series oldest first, plus the bucket still being filled
+    const StatSample* ring;
+    Ring r;
+    uint16_t cap;
+    bool partial = false;
+    StatSample open = {};
+    switch (range) {
+    case StatRange::HOURS:
+        ring = s.hours;
+        r = s.hourRing;
+        cap = HISTORY_HOURS;
+        partial = s.hourCount > 0;
+        if (partial) open = mean(s.hourSum, s.hourCount);
+        break;
+    case StatRange::DAYS:
+        ring = s.days;
+        r = s.dayRing;
+        cap = HISTORY_DAYS;
+        partial = s.dayCount > 0;
+        if (partial) open = mean(s.daySum, s.dayCount);
+        break;
+    default:
+        ring = s.minutes;
+        r = s.minuteRing;
+        cap = HISTORY_MINUTES;
+        break;
+    }
+    uint8_t v[HISTORY_MINUTES + 1];
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < r.count; i++) v[n++] = ring[(r.head + cap - r.count + i) % cap].v[k];
+    if (partial) v[n++] = open.v[k];
+    out.span = n;
+
+    if (n <= SPARK_POINTS) {
+        for (uint16_t i = 0; i < n; i++) out.points[out.count++] = {i, v[i]};
+        return;
+    }
+
+    // LTTB: keep the ends; from each bucket in between, the point making
+    // the largest triangle with the last kept point and the next bucket's mean
+    const float every = (float)(n - 2) / (SPARK_POINTS - 2);
+    uint16_t a = 0;
+    out.points[out.count++] = {0, v[0]};
+    for (uint8_t b = 0; b < SPARK_POINTS - 2; b++) {
+        uint16_t from = (uint16_t)(b * every) + 1;
+        uint16_t to   = (uint16_t)((b + 1) * every) + 1;
+        uint16_t nextTo = (uint16_t)((b + 2) * every) + 1;
+        if (nextTo > n) nextTo = n;
+
+        if (nextTo <= to) {
+            to = n - 1;
+            nextTo = n;
+        }
+        float cx = 0, cy = 0;
+        for (uint16_t i = to; i < nextTo; i++) {
+            cx += i;
+            cy += v[i];
+        }
+        cx /= nextTo - to;
+        cy /= nextTo - to;
+
+        float best = -1;
+        uint16_t pick = from;
+        for (uint16_t i = from; i < to; i++) {
+            float area = (a - cx) * ((float)v[i] - v[a]) - ((float)a - i) * (cy - v[a]);
+            if (area < 0) area = -area;
+            if (area > best) {
+                best = area;
+                pick = i;
+            }
+        }
+        out.points[out.count++] = {pick, v[pick]};
+        a = pick;
+    }
+    out.points[out.count++] = {(uint16_t)(n - 1), v[n - 1]};
+}
@@ -0,0 +1,37 @@
+#pragma once
+// Host (Linux) stand-in for the subset of the Arduino core the game uses.
+// Only compiled into the native env (-I src/host/compat).
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdarg>
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+int  analogRead(uint8_t pin);
+void randomSeed(unsigned long seed);
+
+template <typename T> inline const T& min(const T& a, const T& b) { return (b < a) ? b : a; }
+template <typename T> inline const T& max(const T& a, const T& b) { return (a < b) ? b : a; }
+
+// Serial goes to stderr; the native build points that at a log file while
+// the terminal frontend owns the screen (host_main.cpp, --log)
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    size_t setTxBufferSize(size_t n) { return n; }
+    size_t print(const char* s);
+    size_t println(const char* s = "");
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    size_t write(const uint8_t* buf, size_t len);
+    size_t write(uint8_t b) { return write(&b, 1); }
+    int    availableForWrite() { return 4096; }
+    int    available();
+    int    read();
+    void   flush() {}
+};
+
+extern HardwareSerial Serial;
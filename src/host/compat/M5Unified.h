@@ -0,0 +1,81 @@
+#pragma once
+// Host stand-in for M5Unified. Drawing still uses the real M5GFX canvas;
+// buttons, RTC, power and speaker are headless stubs.
+#include "Arduino.h"
+#include <M5GFX.h>
+#include <ctime>
+
+namespace m5 {
+
+struct rtc_date_t { int16_t year = 2000; int8_t month = 1; int8_t date = 1; int8_t weekDay = 0; };
+struct rtc_time_t { int8_t hours = 0; int8_t minutes = 0; int8_t seconds = 0; };
+struct rtc_datetime_t { rtc_date_t date; rtc_time_t time; };
+
+class Button_Class {
+public:
+    bool wasPressed() const { return false; }
+    bool pressedFor(uint32_t) const { return false; }
+};
+
+class RTC_Class {
+public:
+    rtc_datetime_t getDateTime() const {
+        time_t t = time(nullptr);
+        struct tm lt;
+        localtime_r(&t, &lt);
+        rtc_datetime_t dt;
+        dt.date.year    = lt.tm_year + 1900;
+        dt.date.month   = lt.tm_mon + 1;
+        dt.date.date    = lt.tm_mday;
+        dt.date.weekDay = lt.tm_wday;
+        dt.time.hours   = lt.tm_hour;
+        dt.time.minutes = lt.tm_min;
+        dt.time.seconds = lt.tm_sec;
+        return dt;
+    }
+};
+
+class Power_Class {
+public:
+    int32_t getBatteryLevel() const { return -1; }
+    int16_t getBatteryVoltage() const { return 0; }
+};
+
+class Speaker_Class {
+public:
+    bool begin() { return true; }
+    void end() {}
+    void stop() {}
+    void setVolume(uint8_t) {}
+    bool tone(float, uint32_t) { return true; }
+};
+
+class Display_Class {
+public:
+    void setRotation(uint8_t) {}
+    void setBrightness(uint8_t b) { _brightness = b; }
+    uint8_t getBrightness() const { return _brightness; }
+    void sleep() {}
+    void wakeup() {}
+private:
+    uint8_t _brightness = 0;
+};
+
+struct config_t {};
+
+class M5Unified {
+public:
+    config_t config() const { return {}; }
+    void begin(const config_t&) {}
+    void update() {}
+
+    Display_Class Display;
+    Button_Class  BtnA, BtnB, BtnC;
+    RTC_Class     Rtc;
+    Power_Class   Power;
+    Speaker_Class Speaker;
+};
+
+}  // namespace m5
+
+extern m5::M5Unified M5;
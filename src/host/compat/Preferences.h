@@ -0,0 +1,40 @@
+#pragma once
+// Host stand-in for the ESP32 NVS Preferences API.
+// Each namespace is one file under $STAGOTCHI_NVS_DIR (default ".nvs/").
+#include "Arduino.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key) const { return _data.count(key) != 0; }
+
+    size_t putUChar(const char* key, uint8_t v)        { return putBytes(key, &v, sizeof(v)); }
+    size_t putUInt(const char* key, uint32_t v)        { return putBytes(key, &v, sizeof(v)); }
+    size_t putULong(const char* key, uint32_t v)       { return putBytes(key, &v, sizeof(v)); }
+    size_t putULong64(const char* key, uint64_t v)     { return putBytes(key, &v, sizeof(v)); }
+    size_t putBytes(const char* key, const void* value, size_t len);
+
+    uint8_t  getUChar(const char* key, uint8_t def = 0)       { return getScalar(key, def); }
+    uint32_t getUInt(const char* key, uint32_t def = 0)       { return getScalar(key, def); }
+    uint32_t getULong(const char* key, uint32_t def = 0)      { return getScalar(key, def); }
+    uint64_t getULong64(const char* key, uint64_t def = 0)    { return getScalar(key, def); }
+    size_t   getBytesLength(const char* key) const;
+    size_t   getBytes(const char* key, void* buf, size_t maxLen) const;
+
+private:
+    std::string _path;
+    bool _readOnly = true;
+    bool _dirty    = false;
+    std::map<std::string, std::vector<uint8_t>> _data;
+
+    template <typename T> T getScalar(const char* key, T def) {
+        T v;
+        return (getBytes(key, &v, sizeof(v)) == sizeof(v)) ? v : def;
+    }
+};
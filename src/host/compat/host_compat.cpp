@@ -0,0 +1,146 @@
+#include "Arduino.h"
+#include "M5Unified.h"
+#include "Preferences.h"
+#include <chrono>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+m5::M5Unified  M5;
+HardwareSerial Serial;
+
+// ===== Arduino core =====
+
+static const auto kBootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    auto d = std::chrono::steady_clock::now() - kBootTime;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+}
+
+unsigned long micros() {
+    auto d = std::chrono::steady_clock::now() - kBootTime;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+int analogRead(uint8_t) {
+    return (int)(std::chrono::steady_clock::now().time_since_epoch().count() & 0xFFF);
+}
+
+void randomSeed(unsigned long seed) {
+    srand((unsigned)seed);
+}
+
+size_t HardwareSerial::print(const char* s) {
+    return fputs(s, stderr) < 0 ? 0 : strlen(s);
+}
+
+size_t HardwareSerial::println(const char* s) {
+    size_t n = print(s);
+    fputc('\n', stderr);
+    return n + 1;
+}
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) {
+    return fwrite(buf, 1, len, stderr);
+}
+
+int HardwareSerial::available() { return 0; }
+int HardwareSerial::read() { return -1; }
+
+// ===== Preferences (one file per namespace) =====
+
+static std::string nvsDir() {
+    const char* env = getenv("STAGOTCHI_NVS_DIR");
+    std::string dir = (env && *env) ? env : ".nvs";
+    mkdir(dir.c_str(), 0755);
+    return dir;
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    _path = nvsDir() + "/" + name + ".bin";
+    _readOnly = readOnly;
+    _dirty = false;
+    _data.clear();
+
+    FILE* f = fopen(_path.c_str(), "rb");
+    if (!f) return true;
+    uint8_t klen;
+    while (fread(&klen, 1, 1, f) == 1) {
+        std::string key(klen, '\0');
+        uint32_t vlen;
+        if (fread(&key[0], 1, klen, f) != klen) break;
+        if (fread(&vlen, sizeof(vlen), 1, f) != 1) break;
+        std::vector<uint8_t> val(vlen);
+        if (vlen && fread(val.data(), 1, vlen, f) != vlen) break;
+        _data[key] = std::move(val);
+    }
+    fclose(f);
+    return true;
+}
+
+void Preferences::end() {
+    if (_dirty && !_readOnly) {
+        std::string tmp = _path + ".tmp";
+        FILE* f = fopen(tmp.c_str(), "wb");
+        if (f) {
+            for (const auto& kv : _data) {
+                uint8_t  klen = (uint8_t)kv.first.size();
+                uint32_t vlen = (uint32_t)kv.second.size();
+                fwrite(&klen, 1, 1, f);
+                fwrite(kv.first.data(), 1, klen, f);
+                fwrite(&vlen, sizeof(vlen), 1, f);
+                fwrite(kv.second.data(), 1, vlen, f);
+            }
+            fclose(f);
+            rename(tmp.c_str(), _path.c_str());
+        }
+    }
+    _dirty = false;
+    _data.clear();
+}
+
+bool Preferences::clear() {
+    if (_readOnly) return false;
+    _data.clear();
+    _dirty = true;
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (_readOnly) return false;
+    _dirty |= (_data.erase(key) != 0);
+    return true;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (_readOnly || strlen(key) > 15) return 0;  // NVS key limit
+    const uint8_t* p = static_cast<const uint8_t*>(value);
+    _data[key].assign(p, p + len);
+    _dirty = true;
+    return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) const {
+    auto it = _data.find(key);
+    return (it == _data.end()) ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) const {
+    auto it = _data.find(key);
+    if (it == _data.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
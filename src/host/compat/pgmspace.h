@@ -0,0 +1,4 @@
+#pragma once
+// Host: flash and RAM share one address space
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
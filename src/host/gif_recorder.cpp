@@ -0,0 +1,221 @@
+#include "gif_recorder.h"
+#include <Arduino.h>
+
+// ===== GIF LZW encoder (8-bit minimum code size) =====
+
+namespace {
+
+constexpr int LZW_MIN_BITS  = 8;
+constexpr int LZW_CLEAR     = 1 << LZW_MIN_BITS;
+constexpr int LZW_EOI       = LZW_CLEAR + 1;
+constexpr int LZW_MAX_CODE  = 4095;
+constexpr int HASH_SIZE     = 5003;  // prime > 4096
+
+class LzwWriter {
+public:
+    explicit LzwWriter(FILE* f) : _f(f) { reset(); }
+
+    void encode(const uint8_t* pixels, int stride, int w, int h) {
+        fputc(LZW_MIN_BITS, _f);
+        writeCode(LZW_CLEAR);
+        int prefix = -1;
+        for (int y = 0; y < h; y++) {
+            const uint8_t* row = pixels + y * stride;
+            for (int x = 0; x < w; x++) {
+                int k = row[x];
+                if (prefix < 0) { prefix = k; continue; }
+                int32_t key = (prefix << 8) | k;
+                int slot = lookup(key);
+                if (_keys[slot] == key) {
+                    prefix = _codes[slot];
+                    continue;
+                }
+                writeCode(prefix);
+                _keys[slot]  = key;
+                _codes[slot] = (int16_t)(++_maxCode);
+                if (_maxCode >= (1 << _bits)) _bits++;
+                if (_maxCode == LZW_MAX_CODE) {
+                    writeCode(LZW_CLEAR);
+                    reset();
+                }
+                prefix = k;
+            }
+        }
+        if (prefix >= 0) writeCode(prefix);
+        writeCode(LZW_EOI);
+        if (_bitCount > 0) pushByte((uint8_t)_bitBuf);
+        flushBlock();
+        fputc(0, _f);  // block terminator
+    }
+
+private:
+    FILE*    _f;
+    int32_t  _keys[HASH_SIZE];
+    int16_t  _codes[HASH_SIZE];
+    int      _maxCode = LZW_EOI;
+    int      _bits = LZW_MIN_BITS + 1;
+    uint32_t _bitBuf = 0;
+    int      _bitCount = 0;
+    uint8_t  _block[255];
+    int      _blockLen = 0;
+
+    void reset() {
+        for (int i = 0; i < HASH_SIZE; i++) _keys[i] = -1;
+        _maxCode = LZW_EOI;
+        _bits = LZW_MIN_BITS + 1;
+    }
+
+    int lookup(int32_t key) const {
+        int slot = (int)((uint32_t)key * 2654435761u % HASH_SIZE);
+        while (_keys[slot] != -1 && _keys[slot] != key) {
+            if (++slot == HASH_SIZE) slot = 0;
+        }
+        return slot;
+    }
+
+    void writeCode(int code) {
+        _bitBuf |= (uint32_t)code << _bitCount;
+        _bitCount += _bits;
+        while (_bitCount >= 8) {
+            pushByte((uint8_t)_bitBuf);
+            _bitBuf >>= 8;
+            _bitCount -= 8;
+        }
+    }
+
+    void pushByte(uint8_t b) {
+        _block[_blockLen++] = b;
+        if (_blockLen == 255) flushBlock();
+    }
+
+    void flushBlock() {
+        if (_blockLen == 0) return;
+        fputc(_blockLen, _f);
+        fwrite(_block, 1, _blockLen, _f);
+        _blockLen = 0;
+    }
+};
+
+void put16(FILE* f, uint16_t v) {
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+}  // namespace
+
+// ===== Recorder =====
+
+bool GifRecorder::begin(const char* path, int maxFps) {
+    _file = fopen(path, "wb");
+    if (!_file) return false;
+    _minIntervalMs = (maxFps > 0) ? 1000UL / maxFps : 0;
+    _hasPending = false;
+    _latest = nullptr;
+    _latestSkipped = false;
+    _framesWritten = 0;
+
+    fwrite("GIF89a", 1, 6, _file);
+    put16(_file, SCREEN_W);
+    put16(_file, SCREEN_H);
+    fputc(0xF7, _file);  // global table, 8-bit resolution, 256 entries
+    fputc(0, _file);     // background index
+    fputc(0, _file);     // pixel aspect
+    for (int c = 0; c < 256; c++) {
+        fputc(((c >> 5) & 7) * 255 / 7, _file);
+        fputc(((c >> 2) & 7) * 255 / 7, _file);
+        fputc((c & 3) * 255 / 3, _file);
+    }
+    // NETSCAPE2.0: loop forever
+    static const uint8_t kLoop[] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E',
+                                    '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00};
+    fwrite(kLoop, 1, sizeof(kLoop), _file);
+    return true;
+}
+
+void GifRecorder::end() {
+    if (!_file) return;
+    unsigned long now = millis();
+    if (_latestSkipped && _latest) accept(_latest, now);
+    writePending(now + 1000);  // hold the last frame for a second
+    fputc(0x3B, _file);        // trailer
+    fclose(_file);
+    _file = nullptr;
+}
+
+uint32_t GifRecorder::bytesWritten() const {
+    return _file ? (uint32_t)ftell(_file) : 0;
+}
+
+void GifRecorder::onFrame(const uint8_t* pixels, int w, int h) {
+    if (!_file || w != SCREEN_W || h != SCREEN_H) return;
+    unsigned long now = millis();
+    _latest = pixels;
+    if (_hasPending && now - _lastAcceptMs < _minIntervalMs) {
+        _latestSkipped = true;  // picked up by the next accepted frame or end()
+        return;
+    }
+    accept(pixels, now);
+}
+
+void GifRecorder::accept(const uint8_t* pixels, unsigned long nowMs) {
+    _lastAcceptMs = nowMs;
+    _latestSkipped = false;
+
+    int x0 = 0, y0 = 0, x1 = SCREEN_W - 1, y1 = SCREEN_H - 1;
+    if (_hasPending) {
+        // Bounding box of pixels that differ from what the GIF already shows
+        x0 = SCREEN_W; y0 = SCREEN_H; x1 = -1; y1 = -1;
+        for (int y = 0; y < SCREEN_H; y++) {
+            const uint8_t* a = pixels + y * SCREEN_W;
+            const uint8_t* b = _prev + y * SCREEN_W;
+            if (memcmp(a, b, SCREEN_W) == 0) continue;
+            int l = 0, r = SCREEN_W - 1;
+            while (a[l] == b[l]) l++;
+            while (a[r] == b[r]) r--;
+            if (l < x0) x0 = l;
+            if (r > x1) x1 = r;
+            if (y0 == SCREEN_H) y0 = y;
+            y1 = y;
+        }
+        if (x1 < 0) return;  // identical: previous frame just stays up longer
+        writePending(nowMs);
+    }
+
+    _px = x0; _py = y0; _pw = x1 - x0 + 1; _ph = y1 - y0 + 1;
+    for (int y = 0; y < _ph; y++) {
+        const uint8_t* src = pixels + (_py + y) * SCREEN_W + _px;
+        memcpy(_pending + y * _pw, src, _pw);
+        memcpy(_prev + (_py + y) * SCREEN_W + _px, src, _pw);
+    }
+    _pendingMs = nowMs;
+    _hasPending = true;
+}
+
+void GifRecorder::writePending(unsigned long untilMs) {
+    if (!_hasPending) return;
+    // Difference of rounded timestamps keeps the total duration exact
+    unsigned long cs = untilMs / 10 - _pendingMs / 10;
+    if (cs < 2) cs = 2;  // viewers clamp shorter delays to 100ms
+    if (cs > 0xFFFF) cs = 0xFFFF;
+    writeImage(_px, _py, _pw, _ph, (uint16_t)cs);
+    _hasPending = false;
+}
+
+void GifRecorder::writeImage(int x, int y, int w, int h, uint16_t delayCs) {
+    // Graphic control: leave previous frame in place, no transparency
+    fputc(0x21, _file); fputc(0xF9, _file); fputc(0x04, _file);
+    fputc(0x04, _file);
+    put16(_file, delayCs);
+    fputc(0x00, _file); fputc(0x00, _file);
+
+    fputc(0x2C, _file);
+    put16(_file, (uint16_t)x);
+    put16(_file, (uint16_t)y);
+    put16(_file, (uint16_t)w);
+    put16(_file, (uint16_t)h);
+    fputc(0x00, _file);  // no local color table
+
+    LzwWriter lzw(_file);
+    lzw.encode(_pending, w, w, h);
+    _framesWritten++;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "config.h"
+#include "display.h"
+#include <cstdio>
+
+// Records flushed frames to an animated GIF (host build only).
+// The RGB332 canvas maps 1:1 onto one 256-entry global palette, so frames
+// never need a local color table. Each frame stores only the bounding box
+// that changed since the previous one, delayed by the real time between
+// flushes. Memory is fixed: one reference frame and one pending box, and
+// encoded data goes straight to the file.
+class GifRecorder : public FrameSink {
+public:
+    bool begin(const char* path, int maxFps = 30);
+    void end();
+    bool isRecording() const { return _file != nullptr; }
+
+    void onFrame(const uint8_t* pixels, int w, int h) override;
+
+    uint32_t framesWritten() const { return _framesWritten; }
+    uint32_t bytesWritten() const;
+
+private:
+    FILE* _file = nullptr;
+    unsigned long _minIntervalMs = 0;
+
+    uint8_t _prev[SCREEN_W * SCREEN_H];     // image as the GIF shows it
+    uint8_t _pending[SCREEN_W * SCREEN_H];  // changed box, written on next frame
+    int  _px = 0, _py = 0, _pw = 0, _ph = 0;
+    bool _hasPending = false;
+    unsigned long _pendingMs = 0;
+
+    const uint8_t* _latest = nullptr;
+    bool _latestSkipped = false;
+    unsigned long _lastAcceptMs = 0;
+    uint32_t _framesWritten = 0;
+
+    void accept(const uint8_t* pixels, unsigned long nowMs);
+    void writePending(unsigned long untilMs);
+    void writeImage(int x, int y, int w, int h, uint16_t delayCs);
+};
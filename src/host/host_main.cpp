@@ -0,0 +1,244 @@
+// =============================================
+//  Host entry point (native env)
+//  Runs the unmodified setup()/loop() from main.cpp in a terminal.
+// =============================================
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "config.h"
+#include "display.h"
+#include "input.h"
+#include "terminal.h"
+#include "gif_recorder.h"
+#include "clock.h"
+#include "journal.h"
+#include "graveyard.h"
+#include "sound.h"
+#include "tape.h"
+
+extern DisplayManager gDisplay;
+extern InputManager   gInput;
+extern Clock*         gClock;
+extern Journal        gJournal;
+extern Graveyard      gGraves;
+extern InputTape      gTape;
+extern StateMachine   gState;
+extern SoundManager   gSound;
+
+void setup();
+void loop();
+uint64_t stateHash();
+
+static TerminalFrontend sTerm;
+static GifRecorder      sRecorder;
+
+// Serial writes to stderr, which is the tty the frame is drawn on, and
+// the renderer only repaints cells it changed itself. While the frontend
+// runs, stderr goes to a log file instead; returns the tty's fd to put
+// back, or -1.
+static int logStderrTo(const char* path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return -1;
+    fflush(stderr);
+    int tty = dup(STDERR_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+    return tty;
+}
+
+static void restoreStderr(int tty) {
+    if (tty < 0) return;
+    fflush(stderr);
+    dup2(tty, STDERR_FILENO);
+    close(tty);
+}
+
+// Default --log: beside the saves
+static std::string defaultLogPath() {
+    const char* env = getenv("STAGOTCHI_NVS_DIR");
+    std::string dir = (env && *env) ? env : ".nvs";
+    mkdir(dir.c_str(), 0755);
+    return dir + "/serial.log";
+}
+
+// Empties and removes the replay's scratch save store (one file per NVS
+// namespace)
+static void removeScratch(const char* dir) {
+    if (DIR* d = opendir(dir)) {
+        while (dirent* e = readdir(d)) {
+            if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) continue;
+            remove((std::string(dir) + "/" + e->d_name).c_str());
+        }
+        closedir(d);
+    }
+    rmdir(dir);
+}
+
+// Plays a tape headless, as fast as loop() runs, in a scratch save store
+static int replay(const char* path) {
+    char dir[] = "/tmp/stagotchi-replay-XXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    setenv("STAGOTCHI_NVS_DIR", dir, 1);
+    if (!gTape.replay(path, gState)) {
+        fprintf(stderr, "stagotchi: %s is not a tape from this build\n", path);
+        removeScratch(dir);
+        return 1;
+    }
+
+    gSound.setMute(true);  // tones block for their length
+
+    using SteadyClock = std::chrono::steady_clock;
+    std::vector<uint32_t> loopUs;
+    auto t0 = SteadyClock::now();
+    setup();
+    while (!gTape.finished()) {
+        auto l0 = SteadyClock::now();
+        loop();
+        loopUs.push_back((uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                             SteadyClock::now() - l0).count());
+    }
+    double secs = std::chrono::duration<double>(SteadyClock::now() - t0).count();
+    gTape.end(stateHash);
+    gJournal.close();
+    removeScratch(dir);
+
+    std::sort(loopUs.begin(), loopUs.end());
+    auto pct = [&](double q) { return loopUs.empty() ? 0u : loopUs[(size_t)(q * (loopUs.size() - 1))]; };
+    printf("%lu frames, %.1f s recorded, replayed in %.3f s (%.0fx)\n",
+           (unsigned long)gTape.frames(), gTape.recordedMs() / 1000.0, secs,
+           secs > 0 ? gTape.recordedMs() / 1000.0 / secs : 0.0);
+    printf("loop us: p50 %u  p99 %u  max %u\n", pct(0.50), pct(0.99), pct(1.0));
+    printf("state hash %016llx, %lu checks: %s", (unsigned long long)stateHash(),
+           (unsigned long)gTape.checks(), gTape.diverged() ? "DIVERGED" : "match");
+    if (gTape.diverged()) printf(" (first at frame %lu)", (unsigned long)gTape.divergedAt());
+    printf("\n");
+    return gTape.diverged() ? 3 : 0;
+}
+
+int main(int argc, char** argv) {
+    int scale = 0;  // auto
+    const char* recordPath = nullptr;
+    const char* journalPath = nullptr;
+    const char* gravesPath = nullptr;
+    const char* tapePath = nullptr;
+    const char* replayPath = nullptr;
+    const char* logPath = nullptr;
+    int recordFps = 30;
+    uint32_t speed = 1;
+    unsigned long stepMs = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scale = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--record-fps") == 0 && i + 1 < argc) {
+            recordFps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            stepMs = (unsigned long)atol(argv[++i]);
+        } else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc) {
+            journalPath = argv[++i];
+        } else if (strcmp(argv[i], "--graves") == 0 && i + 1 < argc) {
+            gravesPath = argv[++i];
+        } else if (strcmp(argv[i], "--tape") == 0 && i + 1 < argc) {
+            tapePath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--scale 1|2] [--record out.gif] [--record-fps N]\n"
+                            "          [--speed N | --step MS] [--journal events.bin] [--graves graves.bin]\n"
+                            "          [--tape session.tape | --replay session.tape] [--log serial.log]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // --speed: game time runs N times faster than real time
+    // --step:  game time advances exactly MS per loop, regardless of real time
+    static ScaledClock  scaled(realClock(), speed > 0 ? speed : 1);
+    static VirtualClock stepped(realClock().wallSeconds());
+    if (stepMs > 0) {
+        gClock = &stepped;
+    } else if (speed > 1) {
+        gClock = &scaled;
+    }
+
+    if (journalPath) {
+        gJournal.setClock(gClock);
+        if (!gJournal.open(journalPath)) {
+            fprintf(stderr, "stagotchi: cannot write %s\n", journalPath);
+            return 1;
+        }
+    }
+
+    if (gravesPath && replayPath) {
+        // A replayed death would be buried in the real graveyard
+        fprintf(stderr, "stagotchi: --graves cannot be used with --replay\n");
+        return 2;
+    }
+    if (gravesPath && !gGraves.open(gravesPath)) {
+        fprintf(stderr, "stagotchi: cannot use %s\n", gravesPath);
+        return 1;
+    }
+
+    if (replayPath) return replay(replayPath);
+
+    if (recordPath) {
+        if (!sRecorder.begin(recordPath, recordFps)) {
+            fprintf(stderr, "stagotchi: cannot write %s\n", recordPath);
+            return 1;
+        }
+        gDisplay.addFrameSink(&sRecorder);
+    }
+
+    std::string log = logPath ? logPath : defaultLogPath();
+    int tty = logStderrTo(log.c_str());
+    if (tty < 0) {
+        fprintf(stderr, "stagotchi: cannot write %s\n", log.c_str());
+        return 1;
+    }
+    if (!sTerm.begin(scale)) {
+        restoreStderr(tty);
+        fprintf(stderr, "stagotchi: stdin/stdout must be a terminal\n");
+        return 1;
+    }
+    gDisplay.addFrameSink(&sTerm);
+    gInput.setSource(&sTerm);
+    if (tapePath && !gTape.record(tapePath, gClock, &sTerm, gState)) {
+        sTerm.end();
+        restoreStderr(tty);
+        fprintf(stderr, "stagotchi: cannot write %s\n", tapePath);
+        return 1;
+    }
+
+    setup();
+    while (!sTerm.quitRequested()) {
+        loop();
+        stepped.advance(stepMs);
+    }
+
+    sTerm.end();
+    gTape.end(stateHash);
+    gJournal.close();
+    restoreStderr(tty);
+    if (sRecorder.isRecording()) {
+        uint32_t bytes = sRecorder.bytesWritten();
+        sRecorder.end();
+        fprintf(stderr, "[REC] %s: %lu frames, %lu bytes\n", recordPath,
+                (unsigned long)sRecorder.framesWritten(), (unsigned long)bytes);
+    }
+    fprintf(stderr, "[TERM] %lu bytes written in %lus\n",
+            sTerm.bytesWritten(), millis() / 1000);
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "terminal.h"
+#include <csignal>
+#include <cstdio>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+static struct termios sSavedTermios;
+static volatile sig_atomic_t sInterrupted = 0;
+
+static void onSignal(int) { sInterrupted = 1; }
+
+// RGB332 -> xterm 6x6x6 color cube index
+static uint8_t sXterm[256];
+
+static void buildPalette() {
+    for (int c = 0; c < 256; c++) {
+        int r = ((c >> 5) & 7) * 5 / 7;
+        int g = ((c >> 2) & 7) * 5 / 7;
+        int b = (c & 3) * 5 / 3;
+        sXterm[c] = (uint8_t)(16 + 36 * r + 6 * g + b);
+    }
+}
+
+bool TerminalFrontend::begin(int scale) {
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) return false;
+
+    if (scale <= 0) {
+        // Auto: full resolution only if the terminal is wide enough
+        struct winsize ws;
+        bool wide = ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 &&
+                    ws.ws_col >= MAX_COLS && ws.ws_row > MAX_ROWS;
+        scale = wide ? 1 : 2;
+    }
+    _scale = scale;
+    _cols  = MAX_COLS / _scale;
+    _rows  = MAX_ROWS / _scale;
+    buildPalette();
+
+    tcgetattr(STDIN_FILENO, &sSavedTermios);
+    struct termios raw = sSavedTermios;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN]  = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    _active = true;
+    _fullRedraw = true;
+    _out = "\x1b[?25l\x1b[0m\x1b[2J";
+    char buf[96];
+    snprintf(buf, sizeof(buf), "\x1b[%d;1H a/\xe2\x86\x90:A  s/space:B  d/\xe2\x86\x92:C  q:quit", _rows + 1);
+    _out += buf;
+    _curRow = _curCol = _curFg = _curBg = -1;
+    return true;
+}
+
+void TerminalFrontend::end() {
+    if (!_active) return;
+    char buf[32];
+    snprintf(buf, sizeof(buf), "\x1b[0m\x1b[%d;1H\r\n\x1b[?25h", _rows + 2);
+    fputs(buf, stdout);
+    fflush(stdout);
+    tcsetattr(STDIN_FILENO, TCSANOW, &sSavedTermios);
+    _active = false;
+}
+
+void TerminalFrontend::moveTo(int row, int col) {
+    if (row == _curRow && col == _curCol) return;
+    char buf[32];
+    if (row == _curRow && col > _curCol && col - _curCol < 4) {
+        snprintf(buf, sizeof(buf), "\x1b[%dC", col - _curCol);
+    } else {
+        snprintf(buf, sizeof(buf), "\x1b[%d;%dH", row + 1, col + 1);
+    }
+    _out += buf;
+    _curRow = row;
+    _curCol = col;
+}
+
+void TerminalFrontend::setColors(int fg, int bg) {
+    char buf[32];
+    bool setFg = (fg >= 0 && fg != _curFg);
+    bool setBg = (bg != _curBg);
+    if (setFg && setBg) {
+        snprintf(buf, sizeof(buf), "\x1b[38;5;%d;48;5;%dm", fg, bg);
+    } else if (setFg) {
+        snprintf(buf, sizeof(buf), "\x1b[38;5;%dm", fg);
+    } else if (setBg) {
+        snprintf(buf, sizeof(buf), "\x1b[48;5;%dm", bg);
+    } else {
+        return;
+    }
+    _out += buf;
+    if (setFg) _curFg = fg;
+    _curBg = bg;
+}
+
+void TerminalFrontend::onFrame(const uint8_t* pixels, int w, int h) {
+    if (!_active || !pixels) return;
+
+    for (int row = 0; row < _rows; row++) {
+        int yTop = row * 2 * _scale;
+        int yBot = yTop + _scale;
+        if (yBot >= h) break;
+        const uint8_t* top = pixels + yTop * w;
+        const uint8_t* bot = pixels + yBot * w;
+        uint16_t* cells = &_cells[row * MAX_COLS];
+
+        for (int col = 0; col < _cols; col++) {
+            int x = col * _scale;
+            uint16_t cell = (uint16_t)((top[x] << 8) | bot[x]);
+            if (!_fullRedraw && cells[col] == cell) continue;
+            cells[col] = cell;
+
+            moveTo(row, col);
+            if (top[x] == bot[x]) {
+                setColors(-1, sXterm[top[x]]);  // solid cell: background only
+                _out += ' ';
+            } else {
+                setColors(sXterm[top[x]], sXterm[bot[x]]);
+                _out += "\xe2\x96\x80";  // U+2580 upper half block
+            }
+            _curCol++;
+        }
+    }
+    _fullRedraw = false;
+
+    const char* p = _out.data();
+    size_t left = _out.size();
+    while (left > 0) {
+        ssize_t n = ::write(STDOUT_FILENO, p, left);
+        if (n <= 0) break;
+        p += n;
+        left -= (size_t)n;
+    }
+    _bytesWritten += _out.size();
+    _out.clear();
+}
+
+void TerminalFrontend::pollKeys(bool pressed[3]) {
+    unsigned char buf[64];
+    ssize_t n = ::read(STDIN_FILENO, buf, sizeof(buf));
+    for (ssize_t i = 0; i < n; i++) {
+        unsigned char c = buf[i];
+        if (c == 0x1b && i + 2 < n && buf[i + 1] == '[') {
+            switch (buf[i + 2]) {
+                case 'D': pressed[0] = true; break;  // Left
+                case 'B': pressed[1] = true; break;  // Down
+                case 'C': pressed[2] = true; break;  // Right
+                default: break;
+            }
+            i += 2;
+            continue;
+        }
+        switch (c) {
+            case 'a': case 'A': case '1':
+                pressed[0] = true; break;
+            case 's': case 'S': case '2': case ' ': case '\r': case '\n':
+                pressed[1] = true; break;
+            case 'd': case 'D': case '3':
+                pressed[2] = true; break;
+            case 'q': case 'Q':
+                _quit = true; break;
+            default:
+                break;
+        }
+    }
+}
+
+void TerminalFrontend::read(bool pressed[3], bool held[3]) {
+    for (int i = 0; i < 3; i++) {
+        pressed[i] = false;
+        held[i] = false;  // terminals report no key-up, so long-press is unavailable
+    }
+    if (!_active) return;
+    pollKeys(pressed);
+    if (sInterrupted) _quit = true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "display.h"
+#include "input.h"
+#include <string>
+
+// ANSI terminal frontend for the host build.
+// Renders the canvas with upper-half-block cells (one cell = 1x2 pixels,
+// xterm-256 colors) and only re-emits cells that changed since the last frame.
+// Keys: a/Left = A, s/Space/Enter/Down = B, d/Right = C, q = quit.
+class TerminalFrontend : public FrameSink, public ButtonSource {
+public:
+    bool begin(int scale);  // scale 1 = 320x120 cells, 2 = 160x60 cells
+    void end();
+    bool quitRequested() const { return _quit; }
+
+    void onFrame(const uint8_t* pixels, int w, int h) override;
+    void read(bool pressed[3], bool held[3]) override;
+
+    unsigned long bytesWritten() const { return _bytesWritten; }
+
+private:
+    static constexpr int MAX_COLS = 320;
+    static constexpr int MAX_ROWS = 120;
+
+    int  _scale = 1;
+    int  _cols  = 0;
+    int  _rows  = 0;
+    bool _active = false;
+    bool _quit   = false;
+    bool _fullRedraw = true;
+    unsigned long _bytesWritten = 0;
+
+    uint16_t _cells[MAX_ROWS * MAX_COLS];  // (top << 8) | bottom, RGB332
+    std::string _out;
+
+    // Terminal state as last emitted (-1 = unknown)
+    int _curRow = -1, _curCol = -1;
+    int _curFg  = -1, _curBg  = -1;
+
+    void moveTo(int row, int col);
+    void setColors(int fg, int bg);
+    void pollKeys(bool pressed[3]);
+};
@@ -5,12 +5,16 @@ void InputManager::init() {
 }
 
 void InputManager::update() {
-    _pressed[0] = M5.BtnA.wasPressed();
-    _pressed[1] = M5.BtnB.wasPressed();
-    _pressed[2] = M5.BtnC.wasPressed();
-    _held[0]    = M5.BtnA.pressedFor(800);
-    _held[1]    = M5.BtnB.pressedFor(800);
-    _held[2]    = M5.BtnC.pressedFor(800);
+    source()->read(_pressed, _held);
+}
+
+void M5ButtonSource::read(bool pressed[3], bool held[3]) {
+    pressed[0] = M5.BtnA.wasPressed();
+    pressed[1] = M5.BtnB.wasPressed();
+    pressed[2] = M5.BtnC.wasPressed();
+    held[0]    = M5.BtnA.pressedFor(800);
+    held[1]    = M5.BtnB.pressedFor(800);
+    held[2]    = M5.BtnC.pressedFor(800);
 }
 
 bool InputManager::wasPressed(VButton btn) const {
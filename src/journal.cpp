@@ -0,0 +1,104 @@
+#include "journal.h"
+#include <Arduino.h>
+#include <cstring>
+#include <unistd.h>
+
+static uint8_t* encodeRecord(uint8_t* p, int32_t deltaMs, JournalOp op, uint32_t a, uint32_t b) {
+    uint8_t i = static_cast<uint8_t>(op);
+    p = journalPutVarint64(p, ((uint64_t)journalZigzag(deltaMs) << 5) | i);
+    if (JOURNAL_ARGS[i] > 0) p = journalPutVarint(p, a);
+    if (JOURNAL_ARGS[i] > 1) p = journalPutVarint(p, b);
+    return p;
+}
+
+bool Journal::open(const char* path) {
+    close();
+    if (strlen(path) + 5 > sizeof(_path)) return false;  // room for ".old"
+    strcpy(_path, path);
+    _file = fopen(_path, "ab");
+    if (!_file) return false;
+    fseek(_file, 0, SEEK_END);
+    _fileBytes = (size_t)ftell(_file);
+    beginSession();
+    Serial.printf("[JOURNAL] %s (%lu bytes)\n", _path, (unsigned long)_fileBytes);
+    return true;
+}
+
+void Journal::close() {
+    if (!_file) return;
+    pump(true);
+    fclose(_file);
+    _file = nullptr;
+}
+
+void Journal::beginSession() {
+    _head = 0;
+    _used = 0;
+    _lastMs = _clock->nowMs();
+    _lastSlot = 0;
+    uint8_t buf[JOURNAL_MAX_RECORD];
+    uint8_t* end = encodeRecord(buf, 0, JournalOp::SESSION, _lastMs, _clock->wallSeconds());
+    push(buf, (size_t)(end - buf));
+}
+
+bool Journal::push(const uint8_t* data, size_t size) {
+    if (size > JOURNAL_RING_BYTES - _used) return false;
+    size_t tail = (_head + _used) % JOURNAL_RING_BYTES;
+    size_t first = JOURNAL_RING_BYTES - tail;
+    if (first > size) first = size;
+    memcpy(_ring + tail, data, first);
+    memcpy(_ring, data + first, size - first);
+    _used += size;
+    return true;
+}
+
+void Journal::append(uint8_t slot, unsigned long nowMs, JournalOp op, uint32_t a, uint32_t b) {
+    if (!_file) return;
+    for (;;) {
+        // Encoded per attempt: a rotation while pumping restarts the times
+        uint8_t buf[2 * JOURNAL_MAX_RECORD];
+        uint8_t* p = buf;
+        if (slot != _lastSlot) p = encodeRecord(p, 0, JournalOp::PET, slot, 0);
+        p = encodeRecord(p, (int32_t)(nowMs - _lastMs), op, a, b);
+        if (push(buf, (size_t)(p - buf))) break;
+        size_t waiting = _used;
+        if (_blocking && _file) pump(true);
+        if (!_file || _used >= waiting) {  // not blocking, or the write failed
+            _dropped++;
+            return;
+        }
+    }
+    _lastMs = nowMs;
+    _lastSlot = slot;
+    _records++;
+}
+
+void Journal::pump(bool force) {
+    if (!_file || _used == 0 || (!force && _used < JOURNAL_FLUSH_BYTES)) return;
+    size_t first = JOURNAL_RING_BYTES - _head;
+    if (first > _used) first = _used;
+    size_t n = fwrite(_ring + _head, 1, first, _file);
+    if (n == first && first < _used) n += fwrite(_ring, 1, _used - first, _file);
+    fflush(_file);
+#ifndef STAGOTCHI_HOST
+    fsync(fileno(_file));  // LittleFS commits on sync, not on fflush
+#endif
+    _head = (_head + n) % JOURNAL_RING_BYTES;
+    _used -= n;
+    _fileBytes += n;
+    _bytesWritten += (uint32_t)n;
+    if (_used == 0 && _fileBytes >= JOURNAL_MAX_FILE_BYTES) rotate();
+}
+
+void Journal::rotate() {
+    char old[sizeof(_path) + 4];
+    snprintf(old, sizeof(old), "%s.old", _path);
+    fclose(_file);
+    remove(old);
+    rename(_path, old);
+    _file = fopen(_path, "ab");
+    _fileBytes = 0;
+    if (!_file) return;
+    beginSession();  // the new file must not depend on the old one's times
+    Serial.printf("[JOURNAL] rotated to %s\n", old);
+}
@@ -5,48 +5,266 @@
 // =============================================
 
 #include <M5Unified.h>
+#include <climits>
 #include "config.h"
 #include "game_state.h"
 #include "character.h"
 #include "pet.h"
+#include "roster.h"
 #include "display.h"
 #include "input.h"
 #include "menu.h"
 #include "minigame.h"
 #include "sound.h"
+#include "frame_stream.h"
+#include "power.h"
+#include "clock.h"
+#include "journal.h"
+#include "tape.h"
+#include "history.h"
+#include "graveyard.h"
+#include "predictor.h"
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_sleep.h>
+#endif
+#ifndef STAGOTCHI_HOST
+#include <LittleFS.h>
+#endif
 
 // ===== Global Managers =====
 StateMachine   gState;
-PetManager     gPet;
+PetRoster      gRoster;
+PetManager*    gPet = &gRoster.active();  // the pet on screen (gRoster's active slot)
 DisplayManager gDisplay;
 InputManager   gInput;
 MenuSystem     gMenu;
 MiniGame       gGame;
 SoundManager   gSound;
+FrameStreamer  gStream;
+PowerPolicy    gPower;
+Journal        gJournal;  // host: opened by host_main (--journal)
+InputTape      gTape;     // host: started by host_main (--tape / --replay)
+StatHistory    gHistory;
+Graveyard      gGraves;   // host: opened by host_main (--graves)
+EvolutionPredictor gPredictor;  // stat screen odds, for the pet on screen
+
+// ===== Clock =====
+// Game time for the pets and what the screen says about them. Input
+// idle, backlight, autosave, frame pacing and animation stay on millis()
+// (gLoopMs).
+#ifdef STAGOTCHI_TIME_SCALE
+ScaledClock    gFastClock(realClock(), STAGOTCHI_TIME_SCALE);  // debug: a life in minutes
+Clock*         gClock = &gFastClock;
+#else
+Clock*         gClock = &realClock();
+#endif
 
 // ===== Timers =====
 unsigned long gLastSaveMs     = 0;
+unsigned long gLastHistorySaveMs = 0;
 unsigned long gLastDrawMs     = 0;
 constexpr unsigned long DRAW_INTERVAL_MS = 200; // Redraw every 200ms (5fps) to prevent flicker
 unsigned long gEvoAnimStartMs = 0;
 unsigned long gEvoAnimDuration= 3000;
 CharacterID   gEvoFromChar    = CharacterID::NONE;
 uint8_t       gNewContinueSel = 0;  // 0=New, 1=Continue
+uint8_t       gSelectCursor   = 0;  // pet select tile
+StatRange     gStatRange      = StatRange::MINUTES;  // stat screen graphs
+uint32_t      gGravePage      = 0;  // graveyard page, 0 = newest lives
 bool          gForceRedraw    = true;
+unsigned long gLastInputMs    = 0;
+unsigned long gLoopMs         = 0;  // millis() read once per loop, so a tape can replay it
+
+// Presentation timing (blinks, minigame results, the evolution and draw
+// pacing) runs on the loop's real time, so a sped-up game clock doesn't
+// rush it; only the pets live on gClock
+class LoopClock : public Clock {
+public:
+    unsigned long nowMs() override { return gLoopMs; }
+    uint32_t wallSeconds() override { return gClock->wallSeconds(); }
+};
+LoopClock gUiClock;
+
+// Ambient mode stats (logged on exit)
+unsigned long gAmbientStartMs = 0;
+uint32_t      gAmbientPushes0 = 0;
+uint32_t      gAmbientWakeups = 0;
 
 // ===== Helper =====
-uint8_t getCurrentHour() {
-    auto dt = M5.Rtc.getDateTime();
-    if (dt.date.year > 2020) {
-        return dt.time.hours;
+
+// Seed for a new pet's Rng; everything after that is reproducible
+uint32_t newPetSeed() {
+#ifdef ARDUINO_ARCH_ESP32
+    return gTape.seed(esp_random());  // hardware RNG
+#else
+    return gTape.seed(((uint32_t)rand() << 16) ^ (uint32_t)rand() ^ (uint32_t)micros());
+#endif
+}
+
+// Everything a replay must reproduce: the screen state and every pet
+uint64_t stateHash() {
+    uint64_t h = InputTape::HASH_SEED;
+    h = InputTape::hashU32(h, static_cast<uint32_t>(gState.current()));
+    h = InputTape::hashU32(h, static_cast<uint32_t>(gState.previous()));
+    h = InputTape::hashU32(h, gRoster.usedMask() | gRoster.activeSlot() << 8);
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        if (gRoster.occupied(s)) h = InputTape::hashPet(h, gRoster.at(s).data());
+    }
+    return h;
+}
+
+// Sleep the CPU until the timeout or a touch (Core2 buttons are touch zones)
+void parkFor(unsigned long ms) {
+#ifdef ARDUINO_ARCH_ESP32
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000ULL);
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)TOUCH_INT_PIN, 0);
+    esp_light_sleep_start();
+#else
+    delay(ms < 100 ? ms : 100);  // host: stay responsive to terminal keys
+#endif
+}
+
+// Puts a slot's pet on screen, in whichever state it is in
+void enterPet(uint8_t slot) {
+    gRoster.setActive(slot);
+    gPet = &gRoster.active();
+    gForceRedraw = true;
+    if (gPet->data().isDead) {
+        gState.transition(GameState::DEATH_SCREEN);
+        gDisplay.drawDeathScreen(gPet->data().deathCause);
+    } else if (gPet->data().stage == LifeStage::EGG) {
+        gState.transition(GameState::EGG_HATCHING);
+    } else if (gPet->data().isAsleep) {
+        gState.transition(GameState::SLEEPING);
+    } else {
+        gState.transition(GameState::GAMEPLAY);
     }
-    // Fallback: assume noon start
-    return (12 + (millis() / 3600000UL)) % 24;
+}
+
+// Lays a new egg in an empty slot and shows it hatching
+void hatchInto(uint8_t slot) {
+    gRoster.occupy(slot);
+    gHistory.clear(slot);
+    gRoster.at(slot).initNewEgg(gClock->nowMs(), newPetSeed());
+    enterPet(slot);
+}
+
+// ===== Serial Console =====
+char    gCmdBuf[32];
+uint8_t gCmdLen = 0;
+
+void handleSerialCommand(const char* cmd) {
+    if (strcmp(cmd, "stream on") == 0) {
+        Serial.println(gStream.start() ? "[STREAM] on" : "[STREAM] no memory");
+    } else if (strcmp(cmd, "stream off") == 0) {
+        gStream.stop();
+        Serial.printf("\n[STREAM] off (%lu frames, %lu bytes)\n",
+                      (unsigned long)gStream.framesSent(), (unsigned long)gStream.bytesSent());
+    } else if (strcmp(cmd, "stream key") == 0) {
+        gStream.requestKeyframe();
+    } else if (strcmp(cmd, "tape on") == 0) {
+        InputTape::arm(true);
+        Serial.println("[TAPE] recording from the next boot");
+    } else if (strcmp(cmd, "tape off") == 0) {
+        InputTape::arm(false);
+        gTape.end(stateHash);
+    } else if (strcmp(cmd, "tape") == 0) {
+        Serial.printf("[TAPE] %s, %lu frames, %lu bytes\n", gTape.recording() ? "recording" : "off",
+                      (unsigned long)gTape.frames(), (unsigned long)gTape.bytes());
+    } else if (strcmp(cmd, "odds") == 0) {
+        const EvoOdds& odds = gPredictor.predict(gPet->data(), gPet->rules(), gClock->nowMs(),
+                                                 gClock->wallSeconds(), CareHabits::measured(gPet->data().care));
+        CharacterID forms[static_cast<uint8_t>(CharacterID::CHARACTER_COUNT)];
+        uint8_t n = odds.ranked(forms, sizeof(forms));
+        for (uint8_t i = 0; i < n; i++) {
+            Serial.printf("[ODDS] %-16s %5.1f%%\n", getCharacterDef(forms[i]).nameEN,
+                          odds.chance[static_cast<uint8_t>(forms[i])] * 100.0f / Q15_ONE);
+        }
+        Serial.printf("[ODDS] %lu us (%lu computed)\n", gPredictor.lastComputeUs(),
+                      (unsigned long)gPredictor.computeCount());
+    } else if (strcmp(cmd, "care") == 0) {
+        // CSV: one line per call type for the pet on screen
+        Serial.printf("[CARE],kind,answered,missed,ewma_s,recent_miss_pct,recent_n");
+        for (uint8_t b = 0; b < CARE_BUCKETS - 1; b++) Serial.printf(",lt%us", CARE_BUCKET_EDGE_S[b]);
+        Serial.printf(",ge%us\n", CARE_BUCKET_EDGE_S[CARE_BUCKETS - 2]);
+        static const char* const KINDS[CARE_KINDS] = {"hungry", "unhappy", "discipline", "sick", "poop", "sleep"};
+        for (uint8_t k = 0; k < CARE_KINDS; k++) {
+            const CareKindStats& c = gPet->data().care.kind[k];
+            Serial.printf("[CARE],%s,%u,%u,%lu,%u,%u", KINDS[k], c.answered, c.missed,
+                          (unsigned long)(c.ewmaMs / 1000UL), EvoOdds::percent(c.recentMissQ15()),
+                          c.recentOutcomes());
+            for (uint16_t n : c.hist) Serial.printf(",%u", n);
+            Serial.printf("\n");
+        }
+    } else if (strcmp(cmd, "journal") == 0) {
+        Serial.printf("[JOURNAL] %lu records, %lu dropped, %lu bytes written\n",
+                      (unsigned long)gJournal.records(), (unsigned long)gJournal.dropped(),
+                      (unsigned long)gJournal.bytesWritten());
+    }
+}
+
+void pollSerial() {
+    while (Serial.available() > 0) {
+        char c = (char)Serial.read();
+        if (c == '\r' || c == '\n') {
+            if (gCmdLen > 0) {
+                gCmdBuf[gCmdLen] = '\0';
+                handleSerialCommand(gCmdBuf);
+                gCmdLen = 0;
+            }
+        } else if (gCmdLen < sizeof(gCmdBuf) - 1) {
+            gCmdBuf[gCmdLen++] = c;
+        }
+    }
+}
+
+// ===== Ambient Mode =====
+
+void enterAmbient() {
+    gState.transition(GameState::AMBIENT);
+    gAmbientStartMs = gLoopMs;
+    gAmbientPushes0 = gDisplay.pushCount();
+    gAmbientWakeups = 0;
+    gForceRedraw = true;
+}
+
+void exitAmbient() {
+    Serial.printf("[AMBIENT] %lus: %lu pushes, %lu wakeups\n",
+                  (gLoopMs - gAmbientStartMs) / 1000,
+                  (unsigned long)(gDisplay.pushCount() - gAmbientPushes0),
+                  (unsigned long)gAmbientWakeups);
+    gState.transition(gState.previous());
+    gLastInputMs = gLoopMs;
+    gForceRedraw = true;
 }
 
 // ===== State Handlers =====
 
+void drawGraveyardPage() {
+    GraveRecord rows[GRAVE_PAGE_ROWS], page[GRAVE_PAGE_ROWS];
+    uint8_t n = 0;
+    uint32_t skip = gGravePage * GRAVE_PAGE_ROWS;
+    uint32_t newest = 0;
+    if (skip < gGraves.count()) {
+        newest = gGraves.count() - 1 - skip;
+        uint32_t first = newest + 1 > GRAVE_PAGE_ROWS ? newest + 1 - GRAVE_PAGE_ROWS : 0;
+        n = gGraves.read(first, page, (uint8_t)(newest + 1 - first));
+        for (uint8_t i = 0; i < n; i++) rows[i] = page[n - 1 - i];
+    }
+    GraveRecord best;
+    bool hasBest = gGraves.best(best);
+    gDisplay.drawGraveyard(gGraves.index(), hasBest ? &best : nullptr, rows, n, newest);
+}
+
 void handleTitleScreen() {
+    if (gInput.wasPressed(VButton::LEFT)) {
+        gSound.play(SoundEffect::BUTTON_PRESS);
+        gGravePage = 0;
+        gState.transition(GameState::GRAVEYARD);
+        drawGraveyardPage();
+        return;
+    }
     if (gInput.anyPressed()) {
         gSound.play(SoundEffect::BUTTON_PRESS);
         gForceRedraw = true;
@@ -56,8 +274,8 @@ void handleTitleScreen() {
             gDisplay.drawNewOrContinue(gNewContinueSel);
         } else {
             // New game directly
-            gPet.initNewEgg(millis());
-            gState.transition(GameState::EGG_HATCHING);
+            gRoster.clear();
+            hatchInto(0);
         }
     }
 }
@@ -76,30 +294,38 @@ void handleNewOrContinue() {
     }
     if (gInput.wasPressed(VButton::CENTER)) {
         gSound.play(SoundEffect::BUTTON_PRESS);
+        // Every slot that loads, either way
+        gRoster.clear();
+        PetData loaded;
+        for (uint8_t s = 0; s < MAX_PETS; s++) {
+            if (!gState.loadGame(loaded, s)) continue;
+            gRoster.at(s).loadFromSave(loaded);
+            gRoster.occupy(s);
+        }
         if (gNewContinueSel == 0) {
-            // New Game
-            gState.clearSave();
-            gPet.initNewEgg(millis());
-            gState.transition(GameState::EGG_HATCHING);
+            // New Game: the other pets stay (and the dead still get seen
+            // off); the egg goes in a free slot picked on the select screen
+            if (gRoster.count() == 0) {
+                gState.clearSave();
+                hatchInto(0);
+                return;
+            }
+            uint8_t first = 0;
+            while (!gRoster.occupied(first)) first++;
+            gRoster.setActive(first);
+            gPet = &gRoster.active();
+            gSelectCursor = 0;
+            while (gSelectCursor < MAX_PETS - 1 && gRoster.occupied(gSelectCursor)) gSelectCursor++;
+            gForceRedraw = true;
+            gState.transition(GameState::PET_SELECT);
         } else {
-            // Continue
-            PetData loaded;
-            if (gState.loadGame(loaded)) {
-                gPet.loadFromSave(loaded);
-                if (gPet.data().isDead) {
-                    gState.transition(GameState::DEATH_SCREEN);
-                    gDisplay.drawDeathScreen(gPet.data().deathCause);
-                } else if (gPet.data().stage == LifeStage::EGG) {
-                    gState.transition(GameState::EGG_HATCHING);
-                } else if (gPet.data().isAsleep) {
-                    gState.transition(GameState::SLEEPING);
-                } else {
-                    gState.transition(GameState::GAMEPLAY);
-                }
+            if (gRoster.count() > 0) {
+                uint8_t first = 0;
+                while (!gRoster.occupied(first)) first++;
+                enterPet(first);
             } else {
                 // Load failed, start new
-                gPet.initNewEgg(millis());
-                gState.transition(GameState::EGG_HATCHING);
+                hatchInto(0);
             }
         }
         return;
@@ -110,52 +336,52 @@ void handleNewOrContinue() {
 }
 
 void handleEggHatching(unsigned long now) {
-    gPet.update(now, getCurrentHour());
+    gPet->update(now, gClock->hour());
 
-    if (gPet.isEvolving()) {
+    if (gPet->isEvolving()) {
         gSound.play(SoundEffect::HATCH);
-        gEvoFromChar = gPet.data().characterId;
-        gPet.doEvolve(now);
-        gEvoAnimStartMs = now;
+        gEvoFromChar = gPet->data().characterId;
+        gPet->doEvolve(now);
+        gEvoAnimStartMs = gLoopMs;
         gForceRedraw = true;
         gState.transition(GameState::EVOLUTION);
         return;
     }
 
-    if (now - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
-        float progress = (float)(now - gPet.data().stageStartMs) / (float)EGG_HATCH_MS;
+    if (gLoopMs - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
+        float progress = (float)(now - gPet->data().stageStartMs) / (float)EGG_HATCH_MS;
         if (progress > 1.0f) progress = 1.0f;
         gDisplay.drawEggHatching(progress);
-        gLastDrawMs = now;
+        gLastDrawMs = gLoopMs;
         gForceRedraw = false;
     }
 }
 
 void handleGameplay(unsigned long now, uint8_t hour) {
     // Update pet
-    gPet.update(now, hour);
+    gPet->update(now, hour);
 
     // Check death
-    if (gPet.data().isDead) {
+    if (gPet->data().isDead) {
         gSound.play(SoundEffect::DEATH);
         gState.transition(GameState::DEATH_SCREEN);
-        gDisplay.drawDeathScreen(gPet.data().deathCause);
-        gState.saveGame(gPet.data());
+        gDisplay.drawDeathScreen(gPet->data().deathCause);
+        gState.saveGame(gPet->data(), gRoster.activeSlot());
         return;
     }
 
     // Check evolution
-    if (gPet.isEvolving()) {
+    if (gPet->isEvolving()) {
         gSound.play(SoundEffect::EVOLUTION);
-        gEvoFromChar = gPet.data().characterId;
-        gPet.doEvolve(now);
-        gEvoAnimStartMs = now;
+        gEvoFromChar = gPet->data().characterId;
+        gPet->doEvolve(now);
+        gEvoAnimStartMs = gLoopMs;
         gState.transition(GameState::EVOLUTION);
         return;
     }
 
     // Check sleep
-    if (gPet.data().isAsleep) {
+    if (gPet->data().isAsleep) {
         gState.transition(GameState::SLEEPING);
         return;
     }
@@ -181,27 +407,27 @@ void handleGameplay(unsigned long now, uint8_t hour) {
                 gState.transition(GameState::MENU_FEED);
                 break;
             case MenuItem::LIGHT:
-                if (gPet.toggleLight()) {
+                if (gPet->toggleLight()) {
                     gSound.play(SoundEffect::HAPPY);
                 }
                 break;
             case MenuItem::PLAY:
-                if (gPet.startGame()) {
-                    gGame.start();
+                if (gPet->startGame()) {
+                    gGame.start(gPet->nextRandom());
                     gState.transition(GameState::MINIGAME);
                 } else {
                     gSound.play(SoundEffect::SAD);
                 }
                 break;
             case MenuItem::MEDICINE:
-                if (gPet.giveMedicine()) {
+                if (gPet->giveMedicine()) {
                     gSound.play(SoundEffect::MEDICINE);
                 } else {
                     gSound.play(SoundEffect::SAD);
                 }
                 break;
             case MenuItem::CLEAN:
-                if (gPet.clean()) {
+                if (gPet->clean()) {
                     gSound.play(SoundEffect::HAPPY);
                 } else {
                     gSound.play(SoundEffect::SAD);
@@ -211,29 +437,40 @@ void handleGameplay(unsigned long now, uint8_t hour) {
                 gState.transition(GameState::STAT_SCREEN);
                 break;
             case MenuItem::DISCIPLINE:
-                if (gPet.discipline()) {
+                if (gPet->discipline()) {
                     gSound.play(SoundEffect::DISCIPLINE);
                 } else {
                     gSound.play(SoundEffect::SAD);
                 }
                 break;
+            case MenuItem::PETS:
+                gSelectCursor = gRoster.activeSlot();
+                gState.transition(GameState::PET_SELECT);
+                break;
             default:
                 break;
         }
     }
 
+    // Idle with nothing to attend to: dim clock
+    if (gState.current() == GameState::GAMEPLAY && !gPet->hasAttention() &&
+        gRoster.callingMask() == 0 && gLoopMs - gLastInputMs >= AMBIENT_IDLE_MS) {
+        enterAmbient();
+        return;
+    }
+
     // Draw (throttled to avoid flicker)
-    if (now - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
-        const auto& charDef = getCharacterDef(gPet.data().characterId);
-        gDisplay.drawGameplay(gPet.data(), charDef, gMenu.getCursor());
-        gLastDrawMs = now;
+    if (gLoopMs - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
+        const auto& charDef = getCharacterDef(gPet->data().characterId);
+        gDisplay.drawGameplay(gPet->data(), charDef, gMenu.getCursor());
+        gLastDrawMs = gLoopMs;
         gForceRedraw = false;
     }
 }
 
 void handleFeedMenu(unsigned long now, uint8_t hour) {
     // Still update pet in background
-    gPet.update(now, hour);
+    gPet->update(now, hour);
 
     if (gInput.wasPressed(VButton::LEFT)) {
         gMenu.feedSubUp();
@@ -248,7 +485,7 @@ void handleFeedMenu(unsigned long now, uint8_t hour) {
         FeedChoice choice = gMenu.getFeedChoice();
         switch (choice) {
             case FeedChoice::MEAL:
-                if (gPet.feedMeal()) {
+                if (gPet->feedMeal()) {
                     gSound.play(SoundEffect::FEED);
                 } else {
                     gSound.play(SoundEffect::SAD);
@@ -257,7 +494,7 @@ void handleFeedMenu(unsigned long now, uint8_t hour) {
                 gState.transition(GameState::GAMEPLAY);
                 break;
             case FeedChoice::SNACK:
-                if (gPet.feedSnack()) {
+                if (gPet->feedSnack()) {
                     gSound.play(SoundEffect::FEED);
                 } else {
                     gSound.play(SoundEffect::SAD);
@@ -276,25 +513,25 @@ void handleFeedMenu(unsigned long now, uint8_t hour) {
     }
 
     // Draw gameplay + feed overlay in single flush (no flicker)
-    if (now - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
-        const auto& charDef = getCharacterDef(gPet.data().characterId);
-        gDisplay.drawGameplayNoFlush(gPet.data(), charDef, gMenu.getCursor());
+    if (gLoopMs - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
+        const auto& charDef = getCharacterDef(gPet->data().characterId);
+        gDisplay.drawGameplayNoFlush(gPet->data(), charDef, gMenu.getCursor());
         gDisplay.drawFeedMenu(gMenu.getSubCursor());
         gDisplay.flush();
-        gLastDrawMs = now;
+        gLastDrawMs = gLoopMs;
         gForceRedraw = false;
     }
 }
 
-void handleMinigame(unsigned long now) {
-    gGame.update(now);
+void handleMinigame() {
+    gGame.update(gLoopMs);
 
     if (gGame.isFinished()) {
         if (gGame.isWin()) {
-            gPet.onGameWin();
+            gPet->onGameWin();
             gSound.play(SoundEffect::GAME_WIN);
         } else {
-            gPet.onGameLose();
+            gPet->onGameLose();
             gSound.play(SoundEffect::GAME_LOSE);
         }
         gState.transition(GameState::GAMEPLAY);
@@ -312,30 +549,30 @@ void handleMinigame(unsigned long now) {
         }
         if (gInput.wasPressed(VButton::CENTER)) {
             // Quit game
-            gPet.onGameLose();
+            gPet->onGameLose();
             gState.transition(GameState::GAMEPLAY);
             return;
         }
     }
 
-    if (now - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
+    if (gLoopMs - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
         gDisplay.drawMinigame(gGame.currentRound(), gGame.currentNumber(),
                                gGame.wins(), gGame.lastResult(),
                                gGame.showingResult());
-        gLastDrawMs = now;
+        gLastDrawMs = gLoopMs;
         gForceRedraw = false;
     }
 }
 
-void handleEvolution(unsigned long now) {
-    float progress = (float)(now - gEvoAnimStartMs) / (float)gEvoAnimDuration;
+void handleEvolution() {
+    float progress = (float)(gLoopMs - gEvoAnimStartMs) / (float)gEvoAnimDuration;
     if (progress > 1.0f) progress = 1.0f;
 
-    if (now - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
+    if (gLoopMs - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
         const auto& fromDef = getCharacterDef(gEvoFromChar);
-        const auto& toDef = getCharacterDef(gPet.data().characterId);
+        const auto& toDef = getCharacterDef(gPet->data().characterId);
         gDisplay.drawEvolution(fromDef.nameJP, toDef.nameJP, progress);
-        gLastDrawMs = now;
+        gLastDrawMs = gLoopMs;
         gForceRedraw = false;
     }
 
@@ -346,9 +583,9 @@ void handleEvolution(unsigned long now) {
 }
 
 void handleSleeping(unsigned long now, uint8_t hour) {
-    gPet.update(now, hour);
+    gPet->update(now, hour);
 
-    if (!gPet.data().isAsleep) {
+    if (!gPet->data().isAsleep) {
         gSound.play(SoundEffect::HAPPY);
         gForceRedraw = true;
         gState.transition(GameState::GAMEPLAY);
@@ -357,29 +594,91 @@ void handleSleeping(unsigned long now, uint8_t hour) {
 
     // Allow toggling light
     if (gInput.wasPressed(VButton::CENTER)) {
-        gPet.toggleLight();
+        gPet->toggleLight();
         gSound.play(SoundEffect::BUTTON_PRESS);
         gForceRedraw = true;
     }
 
-    if (now - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
-        const auto& charDef = getCharacterDef(gPet.data().characterId);
-        gDisplay.drawSleepScreen(gPet.data(), charDef, gPet.data().lightOff);
-        gLastDrawMs = now;
+    // Lights out: nothing to show but the time
+    if (gPet->data().lightOff && gRoster.callingMask() == 0 &&
+        gLoopMs - gLastInputMs >= AMBIENT_SLEEP_DELAY_MS) {
+        enterAmbient();
+        return;
+    }
+
+    if (gLoopMs - gLastDrawMs >= DRAW_INTERVAL_MS || gForceRedraw) {
+        const auto& charDef = getCharacterDef(gPet->data().characterId);
+        gDisplay.drawSleepScreen(gPet->data(), charDef, gPet->data().lightOff);
+        gLastDrawMs = gLoopMs;
         gForceRedraw = false;
     }
 }
 
+void handleAmbient(unsigned long now, uint8_t hour) {
+    gAmbientWakeups++;
+    gPet->update(now, hour);
+
+    const PetData& pet = gPet->data();
+    bool fromSleep = (gState.previous() == GameState::SLEEPING);
+    bool needsCare = gRoster.callingMask() != 0;  // any pet, not just this one
+    bool sleepEnded = fromSleep ? !(pet.isAsleep && pet.lightOff) : pet.isAsleep;
+    if (gInput.anyPressed() || needsCare || sleepEnded ||
+        pet.isDead || gPet->isEvolving()) {
+        exitAmbient();  // previous state's handler deals with the cause
+        return;
+    }
+
+    if (!gPower.isScreenOn()) {
+        gForceRedraw = true;  // repaint everything once the panel wakes
+        return;
+    }
+    gDisplay.drawAmbient(pet, hour, gClock->minute(), gForceRedraw);
+    gForceRedraw = false;
+}
+
 void handleStatScreen() {
-    if (gInput.anyPressed()) {
+    if (gInput.wasPressed(VButton::CENTER)) {
+        gSound.play(SoundEffect::BUTTON_PRESS);
+        gForceRedraw = true;
+        gState.transition(GameState::CARE_STATS);
+        return;
+    }
+    const uint8_t ranges = static_cast<uint8_t>(StatRange::COUNT);
+    if (gInput.wasPressed(VButton::LEFT)) {
+        gStatRange = static_cast<StatRange>((static_cast<uint8_t>(gStatRange) + ranges - 1) % ranges);
+        gSound.play(SoundEffect::BUTTON_PRESS);
+        gForceRedraw = true;
+    }
+    if (gInput.wasPressed(VButton::RIGHT)) {
+        gStatRange = static_cast<StatRange>((static_cast<uint8_t>(gStatRange) + 1) % ranges);
+        gSound.play(SoundEffect::BUTTON_PRESS);
+        gForceRedraw = true;
+    }
+    if (gForceRedraw) {
+        const auto& charDef = getCharacterDef(gPet->data().characterId);
+        NeedForecast next;
+        bool hasNext = gPet->forecast(gClock->nowMs(), gClock->wallSeconds(),
+                                     24UL * 3600000UL, &next, 1) > 0;
+        Sparkline sparks[STAT_SERIES];
+        for (uint8_t k = 0; k < STAT_SERIES; k++) {
+            gHistory.sparkline(gRoster.activeSlot(), gStatRange, static_cast<StatSeries>(k), sparks[k]);
+        }
+        const EvoOdds& odds = gPredictor.predict(gPet->data(), gPet->rules(), gClock->nowMs(),
+                                                 gClock->wallSeconds(), CareHabits::measured(gPet->data().care));
+        gDisplay.drawStatScreen(gPet->data(), charDef, hasNext ? &next : nullptr, sparks, gStatRange, &odds);
+        gForceRedraw = false;
+    }
+}
+
+void handleCareStats() {
+    if (gInput.wasPressed(VButton::CENTER)) {
         gSound.play(SoundEffect::BUTTON_PRESS);
         gForceRedraw = true;
         gState.transition(GameState::GAMEPLAY);
         return;
     }
     if (gForceRedraw) {
-        const auto& charDef = getCharacterDef(gPet.data().characterId);
-        gDisplay.drawStatScreen(gPet.data(), charDef);
+        gDisplay.drawCareStats(gPet->data().care);
         gForceRedraw = false;
     }
 }
@@ -387,36 +686,135 @@ void handleStatScreen() {
 void handleDeathScreen() {
     if (gInput.anyPressed()) {
         gSound.play(SoundEffect::BUTTON_PRESS);
-        gState.clearSave();
+        uint8_t slot = gRoster.activeSlot();
+        gGraves.bury(gPet->data(), gClock->nowMs(), gClock->wallSeconds());
+        gRoster.vacate(slot);
+        gHistory.clear(slot);
+        gHistory.save();
+        if (gRoster.count() == 0) {
+            gState.clearSave();
+            gState.transition(GameState::TITLE_SCREEN);
+            gDisplay.drawTitleScreen();
+        } else {
+            gState.clearSlot(slot);
+            gSelectCursor = slot;
+            gForceRedraw = true;
+            gState.transition(GameState::PET_SELECT);
+        }
+    }
+}
+
+void handleGraveyard() {
+    if (gInput.wasPressed(VButton::CENTER)) {
+        gSound.play(SoundEffect::BUTTON_PRESS);
         gState.transition(GameState::TITLE_SCREEN);
         gDisplay.drawTitleScreen();
+        return;
+    }
+    uint32_t pages = (gGraves.count() + GRAVE_PAGE_ROWS - 1) / GRAVE_PAGE_ROWS;
+    bool redraw = false;
+    if (gInput.wasPressed(VButton::LEFT) && gGravePage > 0) {
+        gGravePage--;  // newer
+        redraw = true;
+    }
+    if (gInput.wasPressed(VButton::RIGHT) && gGravePage + 1 < pages) {
+        gGravePage++;  // older
+        redraw = true;
+    }
+    if (redraw) {
+        gSound.play(SoundEffect::BUTTON_PRESS);
+        drawGraveyardPage();
     }
 }
 
+void handlePetSelect(unsigned long now, uint8_t hour) {
+    // The pet left on screen keeps living; its handler evolves it on return
+    gPet->update(now, hour);
+
+    if (gInput.wasPressed(VButton::LEFT)) {
+        gSelectCursor = (gSelectCursor + MAX_PETS - 1) % MAX_PETS;
+        gSound.play(SoundEffect::BUTTON_PRESS);
+    }
+    if (gInput.wasPressed(VButton::RIGHT)) {
+        gSelectCursor = (gSelectCursor + 1) % MAX_PETS;
+        gSound.play(SoundEffect::BUTTON_PRESS);
+    }
+    if (gInput.wasPressed(VButton::CENTER)) {
+        gSound.play(SoundEffect::BUTTON_PRESS);
+        if (gRoster.occupied(gSelectCursor)) {
+            enterPet(gSelectCursor);
+        } else {
+            hatchInto(gSelectCursor);
+        }
+        return;
+    }
+
+    // Every loop: only tiles that changed reach the panel
+    const PetData* pets[MAX_PETS];
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        pets[s] = gRoster.occupied(s) ? &gRoster.at(s).data() : nullptr;
+    }
+    gDisplay.drawPetSelect(pets, gSelectCursor, gForceRedraw);
+    gForceRedraw = false;
+}
+
 // ===== Arduino Entry Points =====
 
 void setup() {
+    Serial.setTxBufferSize(2048);  // room for frame streaming; must precede begin
     auto cfg = M5.config();
     M5.begin(cfg);
 
-    randomSeed(analogRead(0) ^ millis());
-
+    randomSeed(analogRead(0) ^ millis());  // host seeds only; a tape has them
+
+#ifndef STAGOTCHI_HOST
+    if (LittleFS.begin(true)) {
+        if (InputTape::armed()) gTape.record(TAPE_PATH, gClock, gInput.source(), gState);
+        gJournal.setClock(gClock);
+        gJournal.open(JOURNAL_PATH);
+        gGraves.open(GRAVEYARD_PATH);
+    }
+#endif
+    // From here the game reads its time and buttons through the tape
+    if (gTape.active()) {
+        gClock = &gTape;
+        gInput.setSource(&gTape);
+    }
+    gLoopMs = gTape.beginFrame();
+
+    gDisplay.setClock(gClock);
+    gDisplay.setUiClock(&gUiClock);
+    gGame.setClock(&gUiClock);
+    gState.setClock(gClock);
+    gState.setJournal(&gJournal);
+    for (uint8_t s = 0; s < MAX_PETS; s++) gRoster.at(s).setJournal(&gJournal, s);
+    gDisplay.addFrameSink(&gStream);
     gDisplay.init();
     gInput.init();
     gSound.init();
     gMenu.init();
     gState.init();
+    gHistory.load();
 
     gState.transition(GameState::TITLE_SCREEN);
     gDisplay.drawTitleScreen();
+    gPower.init(gLoopMs, DISPLAY_BRIGHTNESS);
+    gTape.endFrame(stateHash);
 }
 
 void loop() {
+    gLoopMs = gTape.beginFrame();
     M5.update();
     gInput.update();
+    if (gInput.anyPressed()) gLastInputMs = gLoopMs;
+
+    unsigned long now = gClock->nowMs();
+    uint8_t hour = gClock->hour();
 
-    unsigned long now = millis();
-    uint8_t hour = getCurrentHour();
+    // Pets not on screen, a few per loop. A tape steps all of them: how many
+    // fit the budget depends on the CPU, and the replay must match.
+    gRoster.updateBackground(now, hour, gTape.active() ? ULONG_MAX : PET_BG_BUDGET_US);
+    gDisplay.setRosterBadge(gRoster.activeSlot(), gRoster.usedMask(), gRoster.callingMask());
 
     switch (gState.current()) {
         case GameState::TITLE_SCREEN:
@@ -435,10 +833,10 @@ void loop() {
             handleFeedMenu(now, hour);
             break;
         case GameState::MINIGAME:
-            handleMinigame(now);
+            handleMinigame();
             break;
         case GameState::EVOLUTION:
-            handleEvolution(now);
+            handleEvolution();
             break;
         case GameState::SLEEPING:
             handleSleeping(now, hour);
@@ -449,17 +847,65 @@ void loop() {
         case GameState::DEATH_SCREEN:
             handleDeathScreen();
             break;
+        case GameState::AMBIENT:
+            handleAmbient(now, hour);
+            break;
+        case GameState::PET_SELECT:
+            handlePetSelect(now, hour);
+            break;
+        case GameState::GRAVEYARD:
+            handleGraveyard();
+            break;
+        case GameState::CARE_STATS:
+            handleCareStats();
+            break;
     }
 
+    // One sample per minute of each living pet's age
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        if (gRoster.occupied(s) && !gRoster.at(s).data().isDead) {
+            gHistory.sample(s, gRoster.at(s).data(), now);
+        }
+    }
+
+    pollSerial();
+    gStream.pump();
+    gJournal.pump();
+    gPower.update(gLoopMs, gLastInputMs, gPet->data(),
+                  gState.current() == GameState::AMBIENT);
+
     // Autosave during active gameplay
     if (gState.current() == GameState::GAMEPLAY ||
         gState.current() == GameState::SLEEPING ||
-        gState.current() == GameState::MENU_FEED) {
-        if (now - gLastSaveMs > AUTOSAVE_INTERVAL_MS) {
-            gState.saveGame(gPet.data());
-            gLastSaveMs = now;
+        gState.current() == GameState::MENU_FEED ||
+        gState.current() == GameState::AMBIENT ||
+        gState.current() == GameState::PET_SELECT) {
+        if (gLoopMs - gLastSaveMs > AUTOSAVE_INTERVAL_MS) {  // flash wear: real time
+            for (uint8_t s = 0; s < MAX_PETS; s++) {
+                if (gRoster.occupied(s)) gState.saveGame(gRoster.at(s).data(), s);
+            }
+            gJournal.pump(true);
+            gLastSaveMs = gLoopMs;
+        }
+        if (gLoopMs - gLastHistorySaveMs > HISTORY_SAVE_INTERVAL_MS) {
+            gHistory.save();
+            gLastHistorySaveMs = gLoopMs;
         }
     }
 
-    delay(16);  // ~60fps
+    gTape.endFrame(stateHash);
+    if (gTape.replaying()) return;  // no pacing: the tape says when each loop ran
+
+    if (gState.current() == GameState::AMBIENT && !gPower.isRamping()) {
+        // Wake for the next digit change, any pet's next event or a touch
+        unsigned long parkMs = gClock->msUntilNextMinute();
+        unsigned long dueMs;
+        if (gRoster.nextEventMs(gClock->nowMs(), dueMs)) {
+            long untilEvent = (long)(dueMs - gClock->nowMs());
+            if (untilEvent < (long)parkMs) parkMs = untilEvent > 0 ? (unsigned long)untilEvent : 0;
+        }
+        parkFor(gClock->realMs(parkMs));
+    } else {
+        delay(16);  // ~60fps
+    }
 }
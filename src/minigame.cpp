@@ -1,10 +1,11 @@
 #include "minigame.h"
 #include <Arduino.h>
 
-void MiniGame::start() {
+void MiniGame::start(uint32_t seed) {
+    _rng.seed(seed);
     _round = 1;
     _wins = 0;
-    _currentNum = 1 + (rand() % 9);
+    _currentNum = 1 + _rng.below(9);
     _lastResult = 0;
     _showResult = false;
     _finished = false;
@@ -12,11 +13,9 @@ void MiniGame::start() {
 }
 
 void MiniGame::generateNext() {
-    _nextNum = 1 + (rand() % 9);
-    // Avoid same number
-    while (_nextNum == _currentNum) {
-        _nextNum = 1 + (rand() % 9);
-    }
+    // Any of the other eight numbers
+    _nextNum = 1 + _rng.below(8);
+    if (_nextNum >= _currentNum) _nextNum++;
 }
 
 void MiniGame::guessHigher() {
@@ -25,7 +24,7 @@ void MiniGame::guessHigher() {
     _lastResult = correct ? 1 : 2;
     if (correct) _wins++;
     _showResult = true;
-    _resultShowMs = millis();
+    _resultShowMs = _clock->nowMs();
 }
 
 void MiniGame::guessLower() {
@@ -34,7 +33,7 @@ void MiniGame::guessLower() {
     _lastResult = correct ? 1 : 2;
     if (correct) _wins++;
     _showResult = true;
-    _resultShowMs = millis();
+    _resultShowMs = _clock->nowMs();
 }
 
 void MiniGame::advanceRound() {
@@ -1,9 +1,12 @@
 #include "pet.h"
 #include "config.h"
+#include "journal.h"
+#include "pet_timing.h"
 #include <Arduino.h>
 
-void PetManager::initNewEgg(unsigned long nowMs) {
+void PetManager::initNewEgg(unsigned long nowMs, uint32_t seed) {
     _pet = PetData();
+    _pet.rng.seed(seed);
     _pet.characterId = CharacterID::EGG;
     _pet.stage = LifeStage::EGG;
     _pet.stageStartMs = nowMs;
@@ -13,134 +16,391 @@ void PetManager::initNewEgg(unsigned long nowMs) {
     _pet.lastAgeTickMs     = nowMs;
     _pet.lastSickCheckMs   = nowMs;
     _pet.lastDisciplineMs  = nowMs;
+    _lastHour = 0xFF;
+    _nowMs = nowMs;
+    log(JournalOp::EGG, seed);
+    reschedule();
 }
 
-void PetManager::loadFromSave(const PetData& d) {
+void PetManager::loadFromSave(const PetData& d, uint8_t lastHour) {
     _pet = d;
+    _lastHour = lastHour;
+    reschedule();
 }
 
 PetData& PetManager::data() { return _pet; }
 const PetData& PetManager::data() const { return _pet; }
 
-unsigned long PetManager::effectiveHungerInterval() const {
-    const auto& def = getCharacterDef(_pet.characterId);
-    if (def.hungerDecayMul == 0) return HUNGER_DECAY_MS;
-    return HUNGER_DECAY_MS * 10UL / def.hungerDecayMul;
+void PetManager::setRules(const GameRules* rules) {
+    _rules = rules ? rules : &defaultRules();
+    _intervalChar = CharacterID::NONE;
+    reschedule();
 }
 
-unsigned long PetManager::effectiveHappyInterval() const {
-    const auto& def = getCharacterDef(_pet.characterId);
-    if (def.happyDecayMul == 0) return HAPPY_DECAY_MS;
-    return HAPPY_DECAY_MS * 10UL / def.happyDecayMul;
+void PetManager::refreshIntervals() {
+    if (_intervalChar == _pet.characterId) return;
+    _intervalChar = _pet.characterId;
+    _hungerInterval = _rules->hungerInterval(_pet.characterId);
+    _happyInterval  = _rules->happyInterval(_pet.characterId);
 }
 
-void PetManager::update(unsigned long nowMs, uint8_t currentHour) {
+unsigned long PetManager::poopInterval() const {
+    return (_pet.stage <= LifeStage::CHILD) ? _rules->poopIntervalYoungMs : _rules->poopIntervalMs;
+}
+
+// === Scheduler ===
+
+void PetManager::arm(PetEvent ev, unsigned long dueMs) {
+    uint8_t i = static_cast<uint8_t>(ev);
+    uint16_t bit = 1u << i;
+    // Several conditions share DEATH; keep the earliest
+    if (!(_armed & bit) || !reached(dueMs, _due[i])) _due[i] = dueMs;
+    _armed |= bit;
+    // Armed in enum order, so a strict compare keeps the original tie order
+    if (_nextEvent == PetEvent::COUNT || !reached(_due[i], _nextDue)) {
+        _nextDue = _due[i];
+        _nextEvent = ev;
+    }
+}
+
+void PetManager::reschedule() {
+    _armed = 0;
+    _nextEvent = PetEvent::COUNT;
     if (_pet.isDead) return;
 
-    // Egg stage: just wait for hatch
     if (_pet.stage == LifeStage::EGG) {
-        if (nowMs - _pet.stageStartMs >= EGG_HATCH_MS) {
-            _pet.readyToEvolve = true;
-        }
+        if (!_pet.readyToEvolve) arm(PetEvent::EVOLUTION, _pet.stageStartMs + EGG_HATCH_MS);
         return;
     }
 
-    // Age tick
-    if (nowMs - _pet.lastAgeTickMs >= AGE_TICK_MS) {
-        _pet.age++;
-        _pet.totalAge++;
-        _pet.lastAgeTickMs = nowMs;
+    refreshIntervals();
+    arm(PetEvent::AGE, _pet.lastAgeTickMs + AGE_TICK_MS);
+    if (_pet.isAsleep) return;  // only the age clock runs overnight
+
+    arm(PetEvent::HUNGER, _pet.lastHungerDecayMs + _hungerInterval);
+    arm(PetEvent::HAPPINESS, _pet.lastHappyDecayMs + _happyInterval);
+    arm(PetEvent::POOP, _pet.lastPoopMs + poopInterval());
+
+    if (!_pet.isSick && _pet.poopCount >= 3) {
+        arm(PetEvent::SICKNESS, _pet.lastSickCheckMs + SICK_FROM_POOP_MS);
+    }
+    if (_pet.stage >= LifeStage::CHILD &&
+        _pet.pendingAttention == AttentionType::NONE &&
+        _pet.discipline < MAX_DISCIPLINE) {
+        arm(PetEvent::DISCIPLINE, _pet.lastDisciplineMs + _rules->disciplineIntervalMs);
+    }
+    if (_pet.pendingAttention != AttentionType::NONE &&
+        _pet.pendingAttention != AttentionType::SLEEP &&
+        _pet.pendingAttention != AttentionType::DISCIPLINE) {
+        arm(PetEvent::CARE_WINDOW, _pet.attentionStartMs + _rules->careWindowMs);
     }
 
-    // Sleep check
-    checkSleep(currentHour);
-    if (_pet.isAsleep) return;
+    // Age gates become due on the tick that reached them
+    if (!_pet.readyToEvolve) {
+        if (_pet.stage == LifeStage::BABY) {
+            arm(PetEvent::EVOLUTION, _pet.stageStartMs + BABY_EVOLVE_MS);
+        } else if ((_pet.stage == LifeStage::CHILD && _pet.age >= CHILD_EVOLVE_AGE) ||
+                   (_pet.stage == LifeStage::TEEN && _pet.age >= TEEN_EVOLVE_AGE)) {
+            arm(PetEvent::EVOLUTION, _pet.lastAgeTickMs);
+        }
+    }
 
-    // Stat decay
-    decayHunger(nowMs);
-    decayHappiness(nowMs);
-    checkPoop(nowMs);
-    checkSickness(nowMs);
-    checkDisciplineCall(nowMs);
-    checkCareWindow(nowMs);
-    checkEvolution(nowMs);
-    checkDeath(nowMs);
+    if (_pet.hunger == 0 && _pet.pendingAttention == AttentionType::HUNGRY) {
+        arm(PetEvent::DEATH, _pet.attentionStartMs + _rules->careWindowMs * 8);
+    }
+    if (_pet.isSick) {
+        arm(PetEvent::DEATH, _pet.lastSickCheckMs + _rules->careWindowMs * 12);
+    }
+    if (_pet.age >= 168) {
+        arm(PetEvent::DEATH, _pet.lastAgeTickMs);
+    }
 }
 
-void PetManager::decayHunger(unsigned long nowMs) {
-    unsigned long interval = effectiveHungerInterval();
-    if (nowMs - _pet.lastHungerDecayMs >= interval) {
-        if (_pet.hunger > 0) {
-            _pet.hunger--;
+void PetManager::update(unsigned long nowMs, uint8_t currentHour) {
+    if (_pet.isDead) return;
+    _nowMs = nowMs;
+
+    // Sleep only changes on the hour
+    if (currentHour != _lastHour) {
+        _lastHour = currentHour;
+        bool wasAsleep = _pet.isAsleep;
+        checkSleep(currentHour);
+        if (_pet.isAsleep != wasAsleep) reschedule();
+    }
+
+    if (_nextEvent == PetEvent::COUNT || !reached(nowMs, _nextDue)) return;
+    runDueEvents(nowMs);
+}
+
+void PetManager::runDueEvents(unsigned long nowMs) {
+    // Every handler moves its own due time forward or disarms itself;
+    // the bound only guards against a future handler that forgets to.
+    for (int n = 0; n < 4 * EVENT_COUNT; n++) {
+        if (_nextEvent == PetEvent::COUNT || !reached(nowMs, _nextDue)) return;
+        fire(_nextEvent, nowMs);
+        reschedule();
+    }
+}
+
+void PetManager::fire(PetEvent ev, unsigned long nowMs) {
+    switch (ev) {
+        case PetEvent::AGE:         onAgeTick(nowMs); break;
+        case PetEvent::HUNGER:      decayHunger(nowMs); break;
+        case PetEvent::HAPPINESS:   decayHappiness(nowMs); break;
+        case PetEvent::POOP:        checkPoop(nowMs); break;
+        case PetEvent::SICKNESS:    checkSickness(nowMs); break;
+        case PetEvent::DISCIPLINE:  checkDisciplineCall(nowMs); break;
+        case PetEvent::CARE_WINDOW: checkCareWindow(); break;
+        case PetEvent::EVOLUTION:   checkEvolution(); break;
+        case PetEvent::DEATH:       checkDeath(nowMs); break;
+        default: break;
+    }
+}
+
+void PetManager::simulateOffline(unsigned long fromMs, uint32_t elapsedMs, uint32_t fromWallSec) {
+    uint64_t wallMs = (uint64_t)fromWallSec * 1000ULL;
+    uint32_t e = 0;
+    int evolutions = 0;
+    for (;;) {
+        unsigned long t = fromMs + e;
+        update(t, (uint8_t)((wallMs + e) / 3600000ULL % 24));
+        if (isEvolving() && evolutions++ < 8) {
+            doEvolve(t);
+            continue;  // new stage may already have something due
         }
-        _pet.lastHungerDecayMs = nowMs;
-        if (_pet.hunger == 0 && _pet.pendingAttention == AttentionType::NONE) {
-            triggerAttention(AttentionType::HUNGRY, nowMs);
+        if (_pet.isDead || e >= elapsedMs) break;
+
+        // Nothing changes before the next event or the next hour
+        uint32_t step = elapsedMs - e;
+        uint32_t toHour = 3600000UL - (uint32_t)((wallMs + e) % 3600000ULL);
+        if (toHour < step) step = toHour;
+        if (hasScheduledEvent()) {
+            long toEvent = (long)(_nextDue - t);
+            if (toEvent < (long)step) step = toEvent > 0 ? (uint32_t)toEvent : 1;
         }
+        e += step;
     }
 }
 
-void PetManager::decayHappiness(unsigned long nowMs) {
-    unsigned long interval = effectiveHappyInterval();
-    if (nowMs - _pet.lastHappyDecayMs >= interval) {
-        if (_pet.happiness > 0) {
-            _pet.happiness--;
+// === Forecast ===
+
+namespace {
+
+// Keeps out[] sorted by time and at most max long
+class ForecastList {
+public:
+    ForecastList(NeedForecast* out, uint8_t max, unsigned long nowMs, unsigned long horizonMs)
+        : _out(out), _max(max), _nowMs(nowMs), _horizonMs(horizonMs) {}
+
+    // False once t can no longer make the list (callers stop their stream)
+    bool fits(unsigned long t) const {
+        if (t - _nowMs > _horizonMs) return false;
+        return _count < _max || (long)(t - _out[_count - 1].atMs) < 0;
+    }
+
+    void add(PetEvent ev, unsigned long t, uint8_t value) {
+        if (!fits(t)) return;
+        int i = (_count < _max) ? _count++ : _count - 1;
+        while (i > 0 && (long)(t - _out[i - 1].atMs) < 0) {
+            _out[i] = _out[i - 1];
+            i--;
+        }
+        _out[i] = {ev, t, value};
+    }
+
+    uint8_t count() const { return _count; }
+
+private:
+    NeedForecast* _out;
+    uint8_t       _max;
+    uint8_t       _count = 0;
+    unsigned long _nowMs;
+    unsigned long _horizonMs;
+};
+
+}  // namespace
+
+uint8_t PetManager::forecast(unsigned long nowMs, uint32_t nowWallSec, unsigned long horizonMs,
+                             NeedForecast* out, uint8_t maxCount) const {
+    ForecastList list(out, maxCount, nowMs, horizonMs);
+    if (_pet.isDead || maxCount == 0) return 0;
+
+    // Anything already overdue happens on the next update
+    auto notBefore = [nowMs](unsigned long t) { return (long)(t - nowMs) < 0 ? nowMs : t; };
+
+    if (_pet.stage == LifeStage::EGG) {
+        list.add(PetEvent::EVOLUTION, notBefore(_pet.stageStartMs + EGG_HATCH_MS), 0);
+        return list.count();
+    }
+
+    const auto& def = getCharacterDef(_pet.characterId);
+    SleepWindow sleep = {def.sleep.bedHour != def.sleep.wakeHour, def.sleep.bedHour,
+                         def.sleep.wakeHour, nowMs,
+                         nowWallSec ? nowWallSec : (uint32_t)(12 * 3600UL + nowMs / 1000UL)};
+    auto fire = [&](unsigned long t) { return sleep.fireTime(notBefore(t)); };
+
+    // Hunger / happiness: one step per interval; each step at zero is a
+    // new call for attention that becomes a care mistake if ignored
+    struct Decay { PetEvent ev; unsigned long last; unsigned long interval;
+                   uint8_t level; AttentionType call; };
+    const unsigned long careWindow = _rules->careWindowMs;
+    unsigned long hungerIv = _rules->hungerInterval(_pet.characterId);
+    unsigned long happyIv  = _rules->happyInterval(_pet.characterId);
+    Decay decays[] = {
+        {PetEvent::HUNGER, _pet.lastHungerDecayMs, hungerIv, _pet.hunger, AttentionType::HUNGRY},
+        {PetEvent::HAPPINESS, _pet.lastHappyDecayMs, happyIv, _pet.happiness, AttentionType::UNHAPPY},
+    };
+    for (auto& d : decays) {
+        if (_pet.pendingAttention == d.call) {
+            list.add(PetEvent::CARE_WINDOW, fire(_pet.attentionStartMs + careWindow), 0);
         }
-        _pet.lastHappyDecayMs = nowMs;
-        if (_pet.happiness == 0 && _pet.pendingAttention == AttentionType::NONE) {
-            triggerAttention(AttentionType::UNHAPPY, nowMs);
+        for (;;) {
+            unsigned long t = fire(d.last + d.interval);
+            if (!list.fits(t)) break;
+            if (d.level > 0) d.level--;
+            list.add(d.ev, t, d.level);
+            if (d.level == 0) list.add(PetEvent::CARE_WINDOW, fire(t + careWindow), 0);
+            d.last = carry(d.last, d.interval, t);
         }
     }
-}
 
-void PetManager::checkPoop(unsigned long nowMs) {
-    unsigned long interval = (_pet.stage <= LifeStage::CHILD)
-        ? POOP_INTERVAL_YOUNG_MS : POOP_INTERVAL_MS;
-    if (nowMs - _pet.lastPoopMs >= interval) {
-        if (_pet.poopCount < MAX_POOP) {
-            _pet.poopCount++;
+    // Poop, and the sickness that the third one starts
+    unsigned long sickAt = 0;
+    bool willBeSick = _pet.isSick;
+    if (_pet.isSick) {
+        sickAt = _pet.lastSickCheckMs;
+    } else if (_pet.poopCount >= 3) {
+        sickAt = fire(_pet.lastSickCheckMs + SICK_FROM_POOP_MS);
+        willBeSick = true;
+    }
+    unsigned long last = _pet.lastPoopMs;
+    uint8_t poops = _pet.poopCount;
+    while (poops < MAX_POOP) {
+        unsigned long t = fire(last + poopInterval());
+        if (!list.fits(t)) break;
+        poops++;
+        list.add(PetEvent::POOP, t, poops);
+        if (poops == 3 && !willBeSick) {
+            sickAt = fire(t + SICK_FROM_POOP_MS);
+            willBeSick = true;
         }
-        _pet.lastPoopMs = nowMs;
+        last = carry(last, poopInterval(), t);
+    }
+    if (willBeSick) {
+        if (!_pet.isSick) list.add(PetEvent::SICKNESS, sickAt, 0);
+        list.add(PetEvent::DEATH, fire(sickAt + careWindow * 12), 1);
     }
-}
 
-void PetManager::checkSickness(unsigned long nowMs) {
-    if (_pet.isSick) return;
-    // Sick from too much poop
-    if (_pet.poopCount >= 3) {
-        if (nowMs - _pet.lastSickCheckMs >= SICK_FROM_POOP_MS) {
-            _pet.isSick = true;
-            _pet.sicknessLevel = 1 + (rand() % 3);  // 1-3 doses
-            _pet.medicineGiven = 0;
-            _pet.lastSickCheckMs = nowMs;
+    // Age runs through the night; its gates take effect on waking
+    auto ageTickAt = [&](uint16_t age) -> unsigned long {
+        if (_pet.age >= age) return nowMs;
+        return _pet.lastAgeTickMs + (unsigned long)(age - _pet.age) * AGE_TICK_MS;
+    };
+    if (!_pet.readyToEvolve) {
+        if (_pet.stage == LifeStage::BABY) {
+            list.add(PetEvent::EVOLUTION, fire(_pet.stageStartMs + BABY_EVOLVE_MS), 0);
+        } else if (_pet.stage == LifeStage::CHILD) {
+            list.add(PetEvent::EVOLUTION, fire(ageTickAt(CHILD_EVOLVE_AGE)), 0);
+        } else if (_pet.stage == LifeStage::TEEN) {
+            list.add(PetEvent::EVOLUTION, fire(ageTickAt(TEEN_EVOLVE_AGE)), 0);
         }
-    } else {
-        _pet.lastSickCheckMs = nowMs;
     }
+    list.add(PetEvent::DEATH, fire(ageTickAt(168)), 2);
+
+    // Nothing follows the first death
+    for (uint8_t i = 0; i < list.count(); i++) {
+        if (out[i].event == PetEvent::DEATH) return i + 1;
+    }
+    return list.count();
+}
+
+// === Event handlers (called only when due) ===
+
+void PetManager::onAgeTick(unsigned long nowMs) {
+    _pet.age++;
+    _pet.totalAge++;
+    _pet.lastAgeTickMs = carry(_pet.lastAgeTickMs, AGE_TICK_MS, nowMs);
+    log(JournalOp::AGE, _pet.age);
+    if (_pet.isAsleep) return;
+
     // Old age sickness
     if (_pet.age >= 15 && ((_pet.age - 15) % 3 == 0) && !_pet.isSick) {
-        if (rand() % 10 < 3) {  // 30% chance per age tick
+        if (_pet.rng.below(10) < 3) {  // 30% chance per age tick
             _pet.isSick = true;
-            _pet.sicknessLevel = 2 + (rand() % 2);
+            _pet.sicknessLevel = 2 + _pet.rng.below(2);
             _pet.medicineGiven = 0;
+            _pet.lastSickCheckMs = nowMs;
+            startTimed(AttentionType::SICK);
+            log(JournalOp::SICK, _pet.sicknessLevel);
+        }
+    }
+    // Secret evolution
+    if (_pet.stage == LifeStage::ADULT && !_pet.readyToEvolve &&
+        resolveSecretEvolution(_pet.characterId, evoFacts()) != CharacterID::NONE) {
+        if (_pet.rng.below(10) < SECRET_EVOLVE_TENTHS) {
+            _pet.readyToEvolve = true;
         }
     }
 }
 
-void PetManager::checkDisciplineCall(unsigned long nowMs) {
-    if (_pet.stage < LifeStage::CHILD) return;
-    if (_pet.pendingAttention != AttentionType::NONE) return;
-    if (_pet.discipline >= MAX_DISCIPLINE) return;
+void PetManager::decayHunger(unsigned long nowMs) {
+    if (_pet.hunger > 0) {
+        _pet.hunger--;
+    }
+    _pet.lastHungerDecayMs = carry(_pet.lastHungerDecayMs, _hungerInterval, nowMs);
+    log(JournalOp::HUNGER, _pet.hunger);
+    if (_pet.hunger == 0 && _pet.pendingAttention == AttentionType::NONE) {
+        triggerAttention(AttentionType::HUNGRY, nowMs);
+    }
+}
 
-    if (nowMs - _pet.lastDisciplineMs >= DISCIPLINE_INTERVAL_MS) {
-        if (rand() % 3 == 0) {  // 33% chance per interval
-            triggerAttention(AttentionType::DISCIPLINE, nowMs);
-            _pet.disciplineCalls++;
-        }
-        _pet.lastDisciplineMs = nowMs;
+void PetManager::decayHappiness(unsigned long nowMs) {
+    if (_pet.happiness > 0) {
+        _pet.happiness--;
+    }
+    _pet.lastHappyDecayMs = carry(_pet.lastHappyDecayMs, _happyInterval, nowMs);
+    log(JournalOp::HAPPINESS, _pet.happiness);
+    if (_pet.happiness == 0 && _pet.pendingAttention == AttentionType::NONE) {
+        triggerAttention(AttentionType::UNHAPPY, nowMs);
+    }
+}
+
+void PetManager::checkPoop(unsigned long nowMs) {
+    uint8_t before = _pet.poopCount;
+    if (_pet.poopCount < MAX_POOP) {
+        _pet.poopCount++;
+    }
+    _pet.lastPoopMs = carry(_pet.lastPoopMs, poopInterval(), nowMs);
+    log(JournalOp::POOP, _pet.poopCount);
+    if (before == 0 && _pet.poopCount > 0) {
+        _pet.poopSinceMs = nowMs;
+        startTimed(AttentionType::POOP);
+    }
+    if (before < 3 && _pet.poopCount >= 3) {
+        _pet.lastSickCheckMs = nowMs;  // sickness countdown starts at the third
     }
 }
 
+void PetManager::checkSickness(unsigned long nowMs) {
+    // Sick from too much poop (armed only while poopCount >= 3)
+    _pet.isSick = true;
+    _pet.sicknessLevel = 1 + _pet.rng.below(3);  // 1-3 doses
+    _pet.medicineGiven = 0;
+    _pet.lastSickCheckMs = nowMs;
+    startTimed(AttentionType::SICK);
+    log(JournalOp::SICK, _pet.sicknessLevel);
+    missCall(AttentionType::POOP);  // left on the floor until it did this
+}
+
+void PetManager::checkDisciplineCall(unsigned long nowMs) {
+    // Armed only for CHILD+ with no pending attention and room to discipline
+    if (_pet.rng.below(DISCIPLINE_CALL_ONE_IN) == 0) {
+        triggerAttention(AttentionType::DISCIPLINE, nowMs);
+        _pet.disciplineCalls++;
+    }
+    _pet.lastDisciplineMs = carry(_pet.lastDisciplineMs, _rules->disciplineIntervalMs, nowMs);
+}
+
 void PetManager::checkSleep(uint8_t currentHour) {
     if (_pet.stage == LifeStage::EGG) return;
     const auto& def = getCharacterDef(_pet.characterId);
@@ -154,20 +414,27 @@ void PetManager::checkSleep(uint8_t currentHour) {
     }
 
     if (shouldSleep && !_pet.isAsleep) {
+        dropCall(_pet.pendingAttention);  // bedtime replaces any call
         _pet.isAsleep = true;
         _pet.lightOff = false;
         _pet.pendingAttention = AttentionType::SLEEP;
+        _pet.attentionStartMs = _nowMs;
+        log(JournalOp::SLEEP, 1);
     } else if (!shouldSleep && _pet.isAsleep) {
+        missCall(_pet.pendingAttention);  // the light stayed on all night
         _pet.isAsleep = false;
         _pet.lightOff = false;
         _pet.pendingAttention = AttentionType::NONE;
+        log(JournalOp::SLEEP, 0);
     }
 }
 
 void PetManager::checkDeath(unsigned long nowMs) {
+    bool wasDead = _pet.isDead;
+    CharacterID form = _pet.characterId;
     // Death from prolonged hunger (care window x 8 = 2 hours)
     if (_pet.hunger == 0 && _pet.pendingAttention == AttentionType::HUNGRY) {
-        if (nowMs - _pet.attentionStartMs >= CARE_WINDOW_MS * 8) {
+        if (nowMs - _pet.attentionStartMs >= _rules->careWindowMs * 8) {
             _pet.isDead = true;
             _pet.deathCause = 0;
             _pet.characterId = CharacterID::GHOST;
@@ -176,7 +443,7 @@ void PetManager::checkDeath(unsigned long nowMs) {
     }
     // Death from prolonged sickness
     if (_pet.isSick) {
-        if (nowMs - _pet.lastSickCheckMs >= CARE_WINDOW_MS * 12) {
+        if (nowMs - _pet.lastSickCheckMs >= _rules->careWindowMs * 12) {
             _pet.isDead = true;
             _pet.deathCause = 1;
             _pet.characterId = CharacterID::GHOST;
@@ -190,54 +457,73 @@ void PetManager::checkDeath(unsigned long nowMs) {
         _pet.characterId = CharacterID::GHOST;
         _pet.stage = LifeStage::DEAD;
     }
+    if (_pet.isDead && !wasDead) {
+        dropCall(_pet.pendingAttention);
+        missCall(AttentionType::SICK);
+        _pet.lastForm = form;
+        _pet.diedMs = nowMs;
+        log(JournalOp::DEATH, _pet.deathCause);
+    }
 }
 
-void PetManager::checkEvolution(unsigned long nowMs) {
-    if (_pet.readyToEvolve) return;
-    switch (_pet.stage) {
-        case LifeStage::BABY:
-            if (nowMs - _pet.stageStartMs >= BABY_EVOLVE_MS) {
-                _pet.readyToEvolve = true;
-            }
-            break;
-        case LifeStage::CHILD:
-            if (_pet.age >= CHILD_EVOLVE_AGE) {
-                _pet.readyToEvolve = true;
-            }
-            break;
-        case LifeStage::TEEN:
-            if (_pet.age >= TEEN_EVOLVE_AGE) {
-                _pet.readyToEvolve = true;
-            }
-            break;
-        case LifeStage::ADULT:
-            if (isSecretEligible(_pet.totalCareMistakes, _pet.characterId, _pet.age)) {
-                if (rand() % 10 < 2) {  // 20% chance per check
-                    _pet.readyToEvolve = true;
-                }
-            }
-            break;
-        default:
-            break;
-    }
-}
-
-void PetManager::checkCareWindow(unsigned long nowMs) {
-    if (_pet.pendingAttention == AttentionType::NONE) return;
-    if (_pet.pendingAttention == AttentionType::SLEEP) return;
-    if (_pet.pendingAttention == AttentionType::DISCIPLINE) return;
-
-    if (nowMs - _pet.attentionStartMs >= CARE_WINDOW_MS) {
-        _pet.careMistakes++;
-        _pet.totalCareMistakes++;
-        _pet.pendingAttention = AttentionType::NONE;
-    }
+void PetManager::checkEvolution() {
+    // Due time already encodes the hatch/baby timer or the age gate
+    _pet.readyToEvolve = true;
+}
+
+void PetManager::checkCareWindow() {
+    _pet.careMistakes++;
+    _pet.totalCareMistakes++;
+    log(JournalOp::MISTAKE, static_cast<uint32_t>(_pet.pendingAttention));
+    missCall(_pet.pendingAttention);
+    _pet.pendingAttention = AttentionType::NONE;
 }
 
 void PetManager::triggerAttention(AttentionType type, unsigned long nowMs) {
     if (_pet.pendingAttention != AttentionType::NONE) return;
     _pet.pendingAttention = type;
     _pet.attentionStartMs = nowMs;
+    log(JournalOp::ATTENTION, static_cast<uint32_t>(type));
+}
+
+// The player answered the call (if it was this one)
+void PetManager::resolveAttention(AttentionType type) {
+    if (_pet.pendingAttention != type) return;
+    careOf(type).answer(_nowMs - _pet.attentionStartMs);
+    _pet.pendingAttention = AttentionType::NONE;
+    log(JournalOp::RESOLVED, static_cast<uint32_t>(type));
+}
+
+void PetManager::missCall(AttentionType type) {
+    if (type == AttentionType::NONE) return;
+    if (type == AttentionType::POOP || type == AttentionType::SICK) {
+        if (!(_pet.care.timing & careBit(type))) return;
+        _pet.care.timing &= ~careBit(type);
+    }
+    careOf(type).miss();
+}
+
+// The call was taken away before it could time out. The game forgives
+// calls with a care window, so only discipline and the light, which have
+// none, count it as missed.
+void PetManager::dropCall(AttentionType type) {
+    if (type == AttentionType::DISCIPLINE || type == AttentionType::SLEEP) missCall(type);
+}
+
+// Poop and sickness never become pendingAttention; care.timing says one
+// is being timed, from sinceMs
+void PetManager::startTimed(AttentionType type) {
+    _pet.care.timing |= careBit(type);
+}
+
+void PetManager::answerTimed(AttentionType type, unsigned long sinceMs) {
+    if (!(_pet.care.timing & careBit(type))) return;
+    _pet.care.timing &= ~careBit(type);
+    careOf(type).answer(_nowMs - sinceMs);
+}
+
+void PetManager::log(JournalOp op, uint32_t a, uint32_t b) {
+    if (_journal) _journal->append(_journalSlot, _nowMs, op, a, b);
 }
 
 bool PetManager::hasAttention() const {
@@ -249,27 +535,21 @@ bool PetManager::isEvolving() const {
 }
 
 void PetManager::doEvolve(unsigned long nowMs) {
+    _nowMs = nowMs;
     _pet.readyToEvolve = false;
-    CharacterID next;
-
-    if (_pet.stage == LifeStage::EGG) {
-        next = CharacterID::BABY_CHAN;
-        _pet.stage = LifeStage::BABY;
-    } else if (_pet.stage == LifeStage::ADULT &&
-               isSecretEligible(_pet.totalCareMistakes, _pet.characterId, _pet.age)) {
-        next = CharacterID::SO_ARM;
-        // stage stays ADULT
-    } else {
-        next = resolveEvolution(_pet.characterId, _pet.careMistakes, _pet.discipline);
-        if (next == CharacterID::NONE) return;
-
-        // Advance stage
-        const auto& def = getCharacterDef(next);
-        _pet.stage = def.stage;
+    // Stage-up first; adults have none and may take their secret form
+    EvoFacts facts = evoFacts();
+    CharacterID next = resolveEvolution(_pet.characterId, facts);
+    if (next == CharacterID::NONE) next = resolveSecretEvolution(_pet.characterId, facts);
+    if (next == CharacterID::NONE) {
+        reschedule();
+        return;
     }
 
+    log(JournalOp::EVOLVE, static_cast<uint32_t>(_pet.characterId), static_cast<uint32_t>(next));
     _pet.characterId = next;
     const auto& newDef = getCharacterDef(next);
+    _pet.stage = newDef.stage;
     _pet.weight = newDef.baseWeight > 0 ? newDef.baseWeight : _pet.weight;
 
     // Reset per-stage counters
@@ -277,86 +557,99 @@ void PetManager::doEvolve(unsigned long nowMs) {
     _pet.discipline = _pet.discipline / 2;  // halve discipline on evolution
     _pet.disciplineCalls = 0;
     _pet.stageStartMs = nowMs;
+    dropCall(_pet.pendingAttention);
     _pet.pendingAttention = AttentionType::NONE;
+    _lastHour = 0xFF;  // new character, new bedtime
+    reschedule();
 }
 
 // === Player Actions ===
 
 bool PetManager::feedMeal() {
-    if (_pet.isAsleep || _pet.isDead) return false;
-    if (_pet.hunger >= MAX_HUNGER) return false;
-    if (_pet.pendingAttention == AttentionType::DISCIPLINE) return false;
+    if (_pet.isAsleep || _pet.isDead || _pet.hunger >= MAX_HUNGER ||
+        _pet.pendingAttention == AttentionType::DISCIPLINE) {
+        return logAction(JournalAction::FEED_MEAL, false);
+    }
 
     _pet.hunger++;
     _pet.weight = min((uint8_t)(_pet.weight + MEAL_WEIGHT), MAX_WEIGHT);
-    if (_pet.pendingAttention == AttentionType::HUNGRY) {
-        _pet.pendingAttention = AttentionType::NONE;
-    }
+    logAction(JournalAction::FEED_MEAL, true);
+    resolveAttention(AttentionType::HUNGRY);
+    reschedule();
     return true;
 }
 
 bool PetManager::feedSnack() {
-    if (_pet.isAsleep || _pet.isDead) return false;
-    if (_pet.happiness >= MAX_HAPPY) return false;
+    if (_pet.isAsleep || _pet.isDead || _pet.happiness >= MAX_HAPPY) {
+        return logAction(JournalAction::FEED_SNACK, false);
+    }
 
     _pet.happiness++;
     _pet.weight = min((uint8_t)(_pet.weight + SNACK_WEIGHT), MAX_WEIGHT);
-    if (_pet.pendingAttention == AttentionType::UNHAPPY) {
-        _pet.pendingAttention = AttentionType::NONE;
-    }
+    logAction(JournalAction::FEED_SNACK, true);
+    resolveAttention(AttentionType::UNHAPPY);
+    reschedule();
     return true;
 }
 
 bool PetManager::startGame() {
-    if (_pet.isAsleep || _pet.isDead) return false;
-    if (_pet.pendingAttention == AttentionType::DISCIPLINE) return false;
-    return true;
+    bool ok = !_pet.isAsleep && !_pet.isDead &&
+              _pet.pendingAttention != AttentionType::DISCIPLINE;
+    return logAction(JournalAction::GAME, ok);
 }
 
 void PetManager::onGameWin() {
     if (_pet.happiness < MAX_HAPPY) _pet.happiness++;
     if (_pet.weight > MIN_WEIGHT) _pet.weight -= GAME_WEIGHT;
-    if (_pet.pendingAttention == AttentionType::UNHAPPY) {
-        _pet.pendingAttention = AttentionType::NONE;
-    }
+    logAction(JournalAction::GAME_WIN, true);
+    resolveAttention(AttentionType::UNHAPPY);
+    reschedule();
 }
 
 void PetManager::onGameLose() {
     if (_pet.weight > MIN_WEIGHT) _pet.weight -= GAME_WEIGHT;
+    logAction(JournalAction::GAME_LOSE, true);
 }
 
 bool PetManager::discipline() {
-    if (_pet.pendingAttention != AttentionType::DISCIPLINE) return false;
+    if (_pet.pendingAttention != AttentionType::DISCIPLINE) return logAction(JournalAction::DISCIPLINE, false);
     _pet.discipline = min((uint8_t)(_pet.discipline + DISCIPLINE_INC), MAX_DISCIPLINE);
-    _pet.pendingAttention = AttentionType::NONE;
+    logAction(JournalAction::DISCIPLINE, true);
+    resolveAttention(AttentionType::DISCIPLINE);
+    reschedule();
     return true;
 }
 
 bool PetManager::giveMedicine() {
-    if (!_pet.isSick || _pet.isDead) return false;
+    if (!_pet.isSick || _pet.isDead) return logAction(JournalAction::MEDICINE, false);
     _pet.medicineGiven++;
+    logAction(JournalAction::MEDICINE, true);
     if (_pet.medicineGiven >= _pet.sicknessLevel) {
+        answerTimed(AttentionType::SICK, _pet.lastSickCheckMs);
         _pet.isSick = false;
         _pet.sicknessLevel = 0;
         _pet.medicineGiven = 0;
+        log(JournalOp::RESOLVED, static_cast<uint32_t>(AttentionType::SICK));
     }
+    reschedule();
     return true;
 }
 
 bool PetManager::clean() {
-    if (_pet.poopCount == 0 || _pet.isDead) return false;
+    if (_pet.poopCount == 0 || _pet.isDead) return logAction(JournalAction::CLEAN, false);
     _pet.poopCount = 0;  // clean all at once
-    if (_pet.pendingAttention == AttentionType::POOP) {
-        _pet.pendingAttention = AttentionType::NONE;
-    }
+    logAction(JournalAction::CLEAN, true);
+    answerTimed(AttentionType::POOP, _pet.poopSinceMs);
+    resolveAttention(AttentionType::POOP);
+    reschedule();
     return true;
 }
 
 bool PetManager::toggleLight() {
-    if (!_pet.isAsleep) return false;
+    if (!_pet.isAsleep) return logAction(JournalAction::LIGHT, false);
     _pet.lightOff = !_pet.lightOff;
-    if (_pet.lightOff && _pet.pendingAttention == AttentionType::SLEEP) {
-        _pet.pendingAttention = AttentionType::NONE;
-    }
+    logAction(JournalAction::LIGHT, true);
+    if (_pet.lightOff) resolveAttention(AttentionType::SLEEP);
+    reschedule();
     return true;
 }
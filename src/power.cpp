@@ -0,0 +1,77 @@
+#include "power.h"
+#include "config.h"
+#include <Arduino.h>
+#include <M5Unified.h>
+
+void PowerPolicy::init(unsigned long nowMs, uint8_t brightness) {
+    _level = brightness << 8;
+    _target = brightness;
+    _panelAsleep = false;
+    _lastMs = _lastLogMs = _startMs = nowMs;
+    _screenOnMs = 0;
+    _brightnessMs = 0;
+    Serial.println("[POWER],uptime_s,batt_pct,batt_mv,brightness,screen_on_s,avg_brightness");
+}
+
+void PowerPolicy::update(unsigned long nowMs, unsigned long lastInputMs,
+                         const PetData& pet, bool ambient) {
+    unsigned long dt = nowMs - _lastMs;
+    _lastMs = nowMs;
+    if (!_panelAsleep) _screenOnMs += dt;
+    _brightnessMs += (uint64_t)brightness() * dt;
+
+    unsigned long idle = nowMs - lastInputMs;
+    bool needsCare = pet.pendingAttention != AttentionType::NONE &&
+                     pet.pendingAttention != AttentionType::SLEEP;
+    uint8_t target;
+    if (ambient) {
+        bool lightsOut = pet.isAsleep && pet.lightOff;
+        target = (lightsOut && idle >= SCREEN_OFF_AFTER_MS) ? 0 : AMBIENT_BRIGHTNESS;
+    } else if (needsCare || idle < DIM_AFTER_MS) {
+        target = DISPLAY_BRIGHTNESS;
+    } else {
+        target = DIM_BRIGHTNESS;
+    }
+    if (target != _target) {
+        _target = target;
+        log(nowMs);
+    }
+
+    if (isRamping()) {
+        // Fade up quickly so input feels responsive, fade down gently
+        uint32_t rate = (_target << 8) > _level ? BRIGHTNESS_RAMP_UP : BRIGHTNESS_RAMP_DOWN;
+        unsigned long stepMs = (dt < 1000) ? dt : 1000;  // after a park, finish within a step
+        uint32_t step = rate * 256UL * stepMs / 1000UL;
+        if (step == 0) step = 1;
+        uint32_t goal = (uint32_t)_target << 8;
+        if (goal > _level) {
+            _level = (goal - _level <= step) ? goal : _level + step;
+        } else {
+            _level = (_level - goal <= step) ? goal : _level - step;
+        }
+        apply(brightness());
+    }
+
+    if (nowMs - _lastLogMs >= POWER_LOG_INTERVAL_MS) log(nowMs);
+}
+
+void PowerPolicy::apply(uint8_t value) {
+    if (value > 0 && _panelAsleep) {
+        M5.Display.wakeup();
+        _panelAsleep = false;
+    }
+    M5.Display.setBrightness(value);
+    if (value == 0 && _target == 0 && !_panelAsleep) {
+        M5.Display.sleep();  // panel off too, not just the backlight
+        _panelAsleep = true;
+    }
+}
+
+void PowerPolicy::log(unsigned long nowMs) {
+    _lastLogMs = nowMs;
+    unsigned long upMs = nowMs - _startMs;
+    unsigned long avg = upMs ? (unsigned long)(_brightnessMs / upMs) : brightness();
+    Serial.printf("[POWER],%lu,%d,%d,%u,%lu,%lu\n", upMs / 1000,
+                  (int)M5.Power.getBatteryLevel(), (int)M5.Power.getBatteryVoltage(),
+                  brightness(), (unsigned long)(_screenOnMs / 1000), avg);
+}
@@ -0,0 +1,318 @@
+#include "predictor.h"
+#include "pet_timing.h"
+#include <Arduino.h>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t  CHAR_COUNT = static_cast<uint8_t>(CharacterID::CHARACTER_COUNT);
+constexpr uint16_t OLD_AGE    = 168;  // hours; dies on this tick (see checkDeath)
+
+uint16_t mulQ15(uint32_t a, uint32_t b) { return (uint16_t)((a * b) >> 15); }
+
+SleepWindow sleepOf(CharacterID c, unsigned long nowMs, uint32_t nowWall) {
+    const auto& def = getCharacterDef(c);
+    return {def.sleep.bedHour != def.sleep.wakeHour, def.sleep.bedHour, def.sleep.wakeHour, nowMs, nowWall};
+}
+
+// Awake time in [from, to), a wall-clock hour at a time
+unsigned long awakeMs(const SleepWindow& s, unsigned long from, unsigned long to) {
+    unsigned long total = 0;
+    while ((long)(to - from) > 0) {
+        unsigned long next = from + (3600UL - s.wallAt(from) % 3600UL) * 1000UL;
+        if ((long)(next - to) > 0) next = to;
+        if (!s.asleepAt(from)) total += next - from;
+        from = next;
+    }
+    return total;
+}
+
+// Hunger and unhappy calls expected while awake for awake ms, Q8: each
+// stat calls once per full drain
+uint32_t careCallsQ8(const GameRules& rules, CharacterID c, unsigned long awake) {
+    uint64_t a = (uint64_t)awake << 8;
+    return (uint32_t)(a / ((uint64_t)rules.hungerInterval(c) * MAX_HUNGER) +
+                      a / ((uint64_t)rules.happyInterval(c) * MAX_HAPPY));
+}
+
+// Chance that none of callsQ8 calls runs out
+uint16_t noMiss(uint32_t callsQ8, uint16_t miss) {
+    uint32_t keep = Q15_ONE - miss, r = Q15_ONE;
+    for (uint32_t n = callsQ8 >> 8; n > 0 && r > 0; n--) r = (r * keep) >> 15;
+    return mulQ15(r, Q15_ONE - (((callsQ8 & 0xFF) * miss) >> 8));
+}
+
+template <size_t M>
+using Cells = uint16_t[M][MAX_DISCIPLINE + 1][2];
+
+// One call that runs out with chance q: a stage mistake, and one ever.
+// Mass only moves to states already visited, so it moves in place.
+template <size_t M>
+void missStep(Cells<M>& p, uint16_t q) {
+    if (q == 0) return;
+    for (int m = M - 1; m >= 0; m--) {
+        int to = m + 1 < (int)M ? m + 1 : m;
+        for (int d = 0; d <= MAX_DISCIPLINE; d++) {
+            for (int e = 0; e < 2; e++) {
+                if (to == m && e == 1) continue;
+                uint16_t moved = mulQ15(p[m][d][e], q);
+                p[m][d][e] -= moved;
+                p[to][d][1] += moved;
+            }
+        }
+    }
+}
+
+template <size_t M>
+void missCalls(Cells<M>& p, uint32_t callsQ8, uint16_t miss) {
+    for (uint32_t n = callsQ8 >> 8; n > 0; n--) missStep(p, miss);
+    missStep(p, (uint16_t)(((callsQ8 & 0xFF) * miss) >> 8));
+}
+
+// One discipline call answered with chance q
+template <size_t M>
+void answerStep(Cells<M>& p, uint16_t q) {
+    if (q == 0) return;
+    for (size_t m = 0; m < M; m++) {
+        for (int d = MAX_DISCIPLINE - 1; d >= 0; d--) {
+            int to = d + DISCIPLINE_INC < MAX_DISCIPLINE ? d + DISCIPLINE_INC : MAX_DISCIPLINE;
+            for (int e = 0; e < 2; e++) {
+                uint16_t moved = mulQ15(p[m][d][e], q);
+                p[m][d][e] -= moved;
+                p[m][to][e] += moved;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+CareHabits CareHabits::measured(const CareStats& care) {
+    CareHabits h;
+    const CareKindStats& hungry  = care.kind[static_cast<uint8_t>(AttentionType::HUNGRY) - 1];
+    const CareKindStats& unhappy = care.kind[static_cast<uint8_t>(AttentionType::UNHAPPY) - 1];
+    const CareKindStats& scold   = care.kind[static_cast<uint8_t>(AttentionType::DISCIPLINE) - 1];
+    uint32_t calls = hungry.recentOutcomes() + unhappy.recentOutcomes();
+    if (calls >= PREDICT_MIN_CALLS) {
+        h.missCare = (uint16_t)(((uint32_t)hungry.recentMissQ15() * hungry.recentOutcomes() +
+                                 (uint32_t)unhappy.recentMissQ15() * unhappy.recentOutcomes()) / calls);
+    }
+    if (scold.recentOutcomes() >= PREDICT_MIN_CALLS) h.answerDiscipline = Q15_ONE - scold.recentMissQ15();
+    return h;
+}
+
+uint8_t EvoOdds::ranked(CharacterID* out, uint8_t max) const {
+    uint8_t n = 0;
+    bool taken[CHAR_COUNT] = {};
+    while (n < max) {
+        uint8_t best = 0;
+        for (uint8_t c = 1; c < CHAR_COUNT; c++) {
+            if (!taken[c] && chance[c] > chance[best]) best = c;
+        }
+        if (chance[best] == 0) break;
+        taken[best] = true;
+        out[n++] = static_cast<CharacterID>(best);
+    }
+    return n;
+}
+
+bool EvolutionPredictor::Key::operator==(const Key& o) const {
+    return characterId == o.characterId && careMistakes == o.careMistakes &&
+           anyMistake == o.anyMistake && discipline == o.discipline && age == o.age &&
+           pendingAttention == o.pendingAttention && readyToEvolve == o.readyToEvolve &&
+           lastAgeTickMs == o.lastAgeTickMs && lastDisciplineMs == o.lastDisciplineMs &&
+           stageStartMs == o.stageStartMs && wallHour == o.wallHour && rules == o.rules &&
+           habits == o.habits;
+}
+
+const EvoOdds& EvolutionPredictor::predict(const PetData& pet, const GameRules& rules, unsigned long nowMs,
+                                           uint32_t nowWallSec, const CareHabits& habits) {
+    uint32_t wall = nowWallSec ? nowWallSec : (uint32_t)(12 * 3600UL + nowMs / 1000UL);
+    Key k;
+    k.characterId      = pet.isDead ? CharacterID::GHOST : pet.characterId;
+    k.careMistakes     = pet.careMistakes < MISTAKE_STATES ? pet.careMistakes : MISTAKE_STATES - 1;
+    k.anyMistake       = pet.totalCareMistakes > 0;
+    k.discipline       = pet.discipline;
+    k.age              = pet.age;
+    k.pendingAttention = pet.pendingAttention;
+    k.readyToEvolve    = pet.readyToEvolve;
+    k.lastAgeTickMs    = pet.lastAgeTickMs;
+    k.lastDisciplineMs = pet.lastDisciplineMs;
+    k.stageStartMs     = pet.stageStartMs;
+    k.wallHour         = wall / 3600UL;
+    k.rules            = &rules;
+    k.habits           = habits;
+    if (_valid && k == _key) return _odds;
+
+    unsigned long t0 = micros();
+    compute(pet, rules, nowMs, wall, habits);
+    _computeUs = micros() - t0;
+    _computes++;
+    _key = k;
+    _valid = true;
+    return _odds;
+}
+
+void EvolutionPredictor::compute(const PetData& pet, const GameRules& rules, unsigned long nowMs,
+                                 uint32_t nowWall, const CareHabits& habits) {
+    _odds = EvoOdds();
+    if (pet.isDead) return;
+
+    auto later = [](unsigned long t, unsigned long notBefore) {
+        return (long)(t - notBefore) < 0 ? notBefore : t;
+    };
+    auto ageAt = [&](unsigned long t) -> uint16_t {
+        long since = (long)(t - pet.lastAgeTickMs);
+        return pet.age + (since > 0 ? (uint16_t)((unsigned long)since / AGE_TICK_MS) : 0);
+    };
+    // Age runs through the night; its gates take effect on waking
+    auto ageTickAt = [&](uint16_t age) -> unsigned long {
+        if (pet.age >= age) return nowMs;
+        return pet.lastAgeTickMs + (unsigned long)(age - pet.age) * AGE_TICK_MS;
+    };
+
+    const uint16_t miss = habits.missCare;
+    const uint16_t answer = habits.answerDiscipline / DISCIPLINE_CALL_ONE_IN;  // per check
+
+    // A stage yet to be walked: its character, distribution and start
+    struct Branch {
+        CharacterID   who;
+        uint8_t       buf;
+        unsigned long start;
+        unsigned long lastDisc;
+    };
+    // Mass reaching an adult form, by whether a mistake was ever made
+    struct Adult {
+        uint32_t      mass[2];
+        unsigned long start;
+    };
+    Branch  queue[6];
+    uint8_t head = 0, tail = 0;
+    Adult   adults[CHAR_COUNT] = {};
+    uint8_t freeBufs = (1u << BUFFERS) - 1;
+    auto takeBuffer = [&]() -> int {
+        for (uint8_t b = 0; b < BUFFERS; b++) {
+            if (!(freeBufs & (1u << b))) continue;
+            freeBufs &= ~(1u << b);
+            memset(&_dist[b], 0, sizeof(Dist));
+            return b;
+        }
+        return -1;
+    };
+
+    const uint8_t m0 = pet.careMistakes < MISTAKE_STATES ? pet.careMistakes : MISTAKE_STATES - 1;
+    const uint8_t e0 = pet.totalCareMistakes > 0;
+    const bool careCall = pet.pendingAttention == AttentionType::HUNGRY ||
+                          pet.pendingAttention == AttentionType::UNHAPPY;
+    if (pet.stage == LifeStage::ADULT) {
+        if (pet.readyToEvolve) {
+            CharacterID secret = resolveSecretEvolution(pet.characterId,
+                                                        {pet.careMistakes, pet.discipline, pet.totalCareMistakes, pet.age});
+            if (secret != CharacterID::NONE) {
+                _odds.chance[static_cast<uint8_t>(secret)] = Q15_ONE;
+                return;
+            }
+        }
+        Adult& a = adults[static_cast<uint8_t>(pet.characterId)];
+        a.mass[e0] = Q15_ONE;
+        if (careCall && e0 == 0) {
+            uint16_t moved = mulQ15(Q15_ONE, miss);
+            a.mass[0] -= moved;
+            a.mass[1] += moved;
+        }
+        a.start = nowMs;
+    } else {
+        int b = takeBuffer();
+        _dist[b].p[m0][pet.discipline][e0] = Q15_ONE;
+        if (careCall) missStep(_dist[b].p, miss);
+        if (pet.pendingAttention == AttentionType::DISCIPLINE) answerStep(_dist[b].p, habits.answerDiscipline);
+        queue[tail++] = {pet.characterId, (uint8_t)b, nowMs, pet.lastDisciplineMs};
+    }
+
+    while (head < tail) {
+        const Branch br = queue[head++];
+        const bool current = br.who == pet.characterId;
+        const LifeStage stage = getCharacterDef(br.who).stage;
+        const SleepWindow sleep = sleepOf(br.who, nowMs, nowWall);
+        auto fire = [&](unsigned long t) { return sleep.fireTime(later(t, br.start)); };
+
+        unsigned long end;
+        if (current && pet.readyToEvolve) {
+            end = nowMs;
+        } else if (stage == LifeStage::EGG) {
+            end = later(pet.stageStartMs + EGG_HATCH_MS, nowMs);
+        } else if (stage == LifeStage::BABY) {
+            end = fire((current ? pet.stageStartMs : br.start) + BABY_EVOLVE_MS);
+        } else {
+            end = fire(ageTickAt(stage == LifeStage::CHILD ? CHILD_EVOLVE_AGE : TEEN_EVOLVE_AGE));
+        }
+
+        auto& p = _dist[br.buf].p;
+        if (stage >= LifeStage::BABY) {
+            missCalls(p, careCallsQ8(rules, br.who, awakeMs(sleep, br.start, end)), miss);
+        }
+        unsigned long lastDisc = br.lastDisc;
+        if (stage >= LifeStage::CHILD) {
+            const unsigned long iv = rules.disciplineIntervalMs;
+            for (unsigned long t = fire(lastDisc + iv); (long)(t - end) < 0; t = fire(lastDisc + iv)) {
+                answerStep(p, answer);
+                lastDisc = carry(lastDisc, iv, t);
+            }
+        }
+
+        // Every state takes the path the rules give it; mistakes reset and
+        // discipline halves, as doEvolve() does
+        const uint16_t endAge = ageAt(end);
+        for (uint8_t m = 0; m < MISTAKE_STATES; m++) {
+            for (uint8_t d = 0; d <= MAX_DISCIPLINE; d++) {
+                for (uint8_t e = 0; e < 2; e++) {
+                    uint16_t mass = p[m][d][e];
+                    if (mass == 0) continue;
+                    CharacterID next = resolveEvolution(br.who, {m, d, e, endAge});
+                    if (next == CharacterID::NONE) continue;
+                    if (getCharacterDef(next).stage == LifeStage::ADULT) {
+                        Adult& a = adults[static_cast<uint8_t>(next)];
+                        a.mass[e] += mass;
+                        a.start = end;
+                        continue;
+                    }
+                    uint8_t q = head;
+                    while (q < tail && queue[q].who != next) q++;
+                    if (q == tail) {
+                        int b = tail < sizeof(queue) / sizeof(queue[0]) ? takeBuffer() : -1;
+                        if (b < 0) continue;
+                        queue[tail++] = {next, (uint8_t)b, end, lastDisc};
+                    }
+                    _dist[queue[q].buf].p[0][d / 2][e] += mass;
+                }
+            }
+        }
+        freeBufs |= 1u << br.buf;
+    }
+
+    // Adults: the secret form rolls on each awake age tick while no
+    // mistake has ever been made (EVO_RULES' secret rules look only at
+    // total mistakes and age)
+    for (uint8_t c = 0; c < CHAR_COUNT; c++) {
+        const Adult& a = adults[c];
+        uint32_t left = a.mass[0] + a.mass[1];
+        if (left == 0) continue;
+        const CharacterID who = static_cast<CharacterID>(c);
+        const SleepWindow sleep = sleepOf(who, nowMs, nowWall);
+        uint32_t clean = a.mass[0];
+        unsigned long prev = a.start;
+        for (uint16_t age = ageAt(a.start) + 1; age < OLD_AGE && clean > 0; age++) {
+            unsigned long tick = pet.lastAgeTickMs + (unsigned long)(age - pet.age) * AGE_TICK_MS;
+            clean = mulQ15(clean, noMiss(careCallsQ8(rules, who, awakeMs(sleep, prev, tick)), miss));
+            prev = tick;
+            if (sleep.asleepAt(tick)) continue;
+            CharacterID secret = resolveSecretEvolution(who, {0, 0, 0, age});
+            if (secret == CharacterID::NONE) continue;
+            uint32_t won = clean * SECRET_EVOLVE_TENTHS / 10;
+            _odds.chance[static_cast<uint8_t>(secret)] += won;
+            clean -= won;
+            left -= won;
+        }
+        _odds.chance[c] += left;
+    }
+}
@@ -0,0 +1,61 @@
+#include "roster.h"
+#include <Arduino.h>
+
+uint8_t PetRoster::count() const {
+    uint8_t n = 0;
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        if (occupied(s)) n++;
+    }
+    return n;
+}
+
+int8_t PetRoster::firstFree() const {
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        if (!occupied(s)) return (int8_t)s;
+    }
+    return -1;
+}
+
+uint8_t PetRoster::updateBackground(unsigned long nowMs, uint8_t hour, unsigned long budgetUs) {
+    unsigned long t0 = micros();
+    uint8_t stepped = 0;
+    for (uint8_t tried = 0; tried < MAX_PETS; tried++) {
+        uint8_t s = _next;
+        _next = (uint8_t)((_next + 1) % MAX_PETS);
+        if (s == _active || !occupied(s)) continue;
+
+        PetManager& pet = _pets[s];
+        pet.update(nowMs, hour);
+        if (pet.isEvolving()) pet.doEvolve(nowMs);
+        stepped++;
+        if (micros() - t0 >= budgetUs) break;
+    }
+    return stepped;
+}
+
+bool PetRoster::nextEventMs(unsigned long nowMs, unsigned long& dueMs) const {
+    bool any = false;
+    long soonest = 0;
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        const PetManager& pet = _pets[s];
+        if (!occupied(s) || pet.data().isDead || !pet.hasScheduledEvent()) continue;
+        long until = (long)(pet.nextEventMs() - nowMs);
+        if (!any || until < soonest) soonest = until;
+        any = true;
+    }
+    if (any) dueMs = nowMs + soonest;
+    return any;
+}
+
+uint8_t PetRoster::callingMask() const {
+    uint8_t mask = 0;
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        const PetData& d = _pets[s].data();
+        if (!occupied(s) || d.isDead) continue;
+        if (d.pendingAttention != AttentionType::NONE &&
+            d.pendingAttention != AttentionType::SLEEP) {
+            mask |= (1u << s);
+        }
+    }
+    return mask;
+}
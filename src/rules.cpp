@@ -0,0 +1,14 @@
+#include "rules.h"
+
+GameRules::GameRules() {
+    for (int i = 0; i < CHARS; i++) {
+        const auto& def = getCharacterDef(static_cast<CharacterID>(i));
+        hungerDecayMul[i] = def.hungerDecayMul;
+        happyDecayMul[i]  = def.happyDecayMul;
+    }
+}
+
+const GameRules& defaultRules() {
+    static const GameRules rules;
+    return rules;
+}
@@ -0,0 +1,384 @@
+#include "tape.h"
+#include "journal_format.h"
+#include "pet_fields.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <unistd.h>
+
+static constexpr uint32_t TAPE_MAGIC   = 0x45504154;  // "TAPE"
+static constexpr uint8_t  TAPE_VERSION = 4;  // v2: PetData.lastForm/diedMs, v3: care stats, v4: UI on loop time
+
+// Frame header bits
+static constexpr uint8_t FRAME_SEEDS = 0x40;
+static constexpr uint8_t FRAME_EXTRA = 0x80;
+// Extra byte bits
+static constexpr uint8_t EXTRA_WALL  = 0x01;
+static constexpr uint8_t EXTRA_CHECK = 0x02;
+static constexpr uint8_t EXTRA_END   = 0x04;
+
+// Largest frame: header, two 64-bit varints, extra byte, wall, hash, seeds
+static constexpr size_t MAX_FRAME = 1 + 10 + 10 + 1 + 5 + 8 + 1 + MAX_PETS * 5;
+static_assert(TAPE_BUFFER_BYTES >= MAX_FRAME, "a frame must fit the write buffer");
+
+static uint64_t zigzag64(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t unzigzag64(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+uint64_t InputTape::hashU32(uint64_t h, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        h ^= (uint8_t)(v >> (8 * i));
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+uint64_t InputTape::hashPet(uint64_t h, const PetData& pet) {
+    forEachPetField(pet, [&](const auto& v) { h = hashU32(h, (uint32_t)v); });
+    return h;
+}
+
+// ===== Arming (device) =====
+
+bool InputTape::armed() {
+    Preferences prefs;
+    prefs.begin(TAPE_NVS_NAMESPACE, true);
+    bool on = prefs.getUChar("armed", 0) != 0;
+    prefs.end();
+    return on;
+}
+
+void InputTape::arm(bool on) {
+    Preferences prefs;
+    prefs.begin(TAPE_NVS_NAMESPACE, false);
+    prefs.putUChar("armed", on ? 1 : 0);
+    prefs.end();
+}
+
+// ===== Recording =====
+
+bool InputTape::record(const char* path, Clock* game, ButtonSource* buttons, StateMachine& state) {
+    close();
+    _file = fopen(path, "wb");
+    if (!_file) return false;
+
+    uint8_t* p = _buf;
+    for (int i = 0; i < 4; i++) *p++ = (uint8_t)(TAPE_MAGIC >> (8 * i));
+    *p++ = TAPE_VERSION;
+    *p++ = MAX_PETS;
+    fwrite(_buf, 1, (size_t)(p - _buf), _file);
+    _bytes = (uint32_t)(p - _buf);
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        RawSave save;
+        p = _buf;
+        bool present = state.readRaw(s, save);
+        *p++ = present ? 1 : 0;
+        if (present) {
+            *p++ = save.version;
+            p = journalPutVarint(p, save.savedMs);
+            p = journalPutVarint(p, save.savedRtc);
+            forEachPetField(save.pet, [&](auto& v) { p = journalPutVarint64(p, (uint64_t)v); });
+        }
+        fwrite(_buf, 1, (size_t)(p - _buf), _file);
+        _bytes += (uint32_t)(p - _buf);
+    }
+
+    _mode = Mode::RECORD;
+    _base = game;
+    _buttons = buttons;
+    _frame = 0;
+    _checks = 0;
+    _used = 0;
+    _prevMillis = _prevGame = 0;
+    _prevWall = 0;
+    Serial.printf("[TAPE] recording to %s\n", path);
+    return true;
+}
+
+void InputTape::writeRecord(uint8_t extra, uint64_t hash) {
+    if (_used + MAX_FRAME > sizeof(_buf)) flush(false);
+    uint8_t* p = _buf + _used;
+    int32_t dWall = (int32_t)(_wall - _prevWall);
+    if (dWall != 0) extra |= EXTRA_WALL;
+
+    uint8_t head = _bits;
+    if (_seedCount) head |= FRAME_SEEDS;
+    if (extra) head |= FRAME_EXTRA;
+    *p++ = head;
+    unsigned long dMillis = _millis - _prevMillis;
+    unsigned long dGame = _game - _prevGame;
+    p = journalPutVarint64(p, (uint64_t)dMillis);
+    p = journalPutVarint64(p, zigzag64((long)(dGame - dMillis)));  // long: signed at either width
+    if (extra) {
+        *p++ = extra;
+        if (extra & EXTRA_WALL) p = journalPutVarint(p, journalZigzag(dWall));
+        if (extra & EXTRA_CHECK) {
+            for (int i = 0; i < 8; i++) *p++ = (uint8_t)(hash >> (8 * i));
+        }
+    }
+    if (_seedCount) {
+        *p++ = _seedCount;
+        for (uint8_t i = 0; i < _seedCount; i++) p = journalPutVarint(p, _seeds[i]);
+    }
+    _used = (size_t)(p - _buf);
+    _prevMillis = _millis;
+    _prevGame = _game;
+    _prevWall = _wall;
+}
+
+void InputTape::flush(bool sync) {
+    if (!_file || _used == 0) return;
+    fwrite(_buf, 1, _used, _file);
+    _bytes += (uint32_t)_used;
+    _used = 0;
+    if (!sync) return;
+    fflush(_file);
+#ifndef STAGOTCHI_HOST
+    fsync(fileno(_file));  // a recording is only useful up to the last sync
+#endif
+}
+
+// ===== Replay =====
+
+namespace {
+
+struct TapeFrame {
+    uint8_t  bits = 0;
+    uint8_t  extra = 0;
+    uint64_t dMillis = 0;
+    int64_t  dGameOver = 0;  // game delta minus millis delta
+    int32_t  dWall = 0;
+    uint64_t hash = 0;
+    uint8_t  seedCount = 0;
+    uint32_t seeds[MAX_PETS] = {};
+};
+
+// nullptr on a torn or damaged frame
+const uint8_t* parseFrame(const uint8_t* p, const uint8_t* end, TapeFrame& f) {
+    if (p >= end) return nullptr;
+    uint8_t head = *p++;
+    f = TapeFrame();
+    f.bits = head & 0x3F;
+    uint64_t v;
+    if (!(p = journalGetVarint(p, end, f.dMillis))) return nullptr;
+    if (!(p = journalGetVarint(p, end, v))) return nullptr;
+    f.dGameOver = unzigzag64(v);
+    if (head & FRAME_EXTRA) {
+        if (p >= end) return nullptr;
+        f.extra = *p++;
+        if (f.extra & EXTRA_WALL) {
+            if (!(p = journalGetVarint(p, end, v))) return nullptr;
+            f.dWall = journalUnzigzag((uint32_t)v);
+        }
+        if (f.extra & EXTRA_CHECK) {
+            if (end - p < 8) return nullptr;
+            for (int i = 0; i < 8; i++) f.hash |= (uint64_t)*p++ << (8 * i);
+        }
+    }
+    if (head & FRAME_SEEDS) {
+        if (p >= end || *p > MAX_PETS) return nullptr;
+        f.seedCount = *p++;
+        for (uint8_t i = 0; i < f.seedCount; i++) {
+            if (!(p = journalGetVarint(p, end, v))) return nullptr;
+            f.seeds[i] = (uint32_t)v;
+        }
+    }
+    return p;
+}
+
+}  // namespace
+
+bool InputTape::replay(const char* path, StateMachine& state) {
+    close();
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    _data = size > 0 ? (uint8_t*)malloc((size_t)size) : nullptr;
+    bool ok = _data && fread(_data, 1, (size_t)size, f) == (size_t)size;
+    fclose(f);
+    _size = ok ? (size_t)size : 0;
+
+    const uint8_t* p = _data;
+    const uint8_t* end = _data + _size;
+    uint32_t magic = 0;
+    if (ok && _size >= 6) {
+        for (int i = 0; i < 4; i++) magic |= (uint32_t)p[i] << (8 * i);
+        ok = magic == TAPE_MAGIC && p[4] == TAPE_VERSION && p[5] == MAX_PETS;
+        p += 6;
+    } else {
+        ok = false;
+    }
+
+    // The saves the recording started from
+    RawSave saves[MAX_PETS];
+    bool present[MAX_PETS] = {};
+    for (uint8_t s = 0; ok && s < MAX_PETS; s++) {
+        present[s] = p < end && *p++ == 1;
+        if (!present[s]) continue;
+        uint64_t v;
+        ok = p < end;
+        if (ok) saves[s].version = *p++;
+        if (ok && (p = journalGetVarint(p, end, v))) saves[s].savedMs = (uint32_t)v;
+        if (p && (p = journalGetVarint(p, end, v))) saves[s].savedRtc = (uint32_t)v;
+        ok = p != nullptr;
+        forEachPetField(saves[s].pet, [&](auto& field) {
+            if (!p || !(p = journalGetVarint(p, end, v))) return;
+            field = static_cast<std::remove_reference_t<decltype(field)>>(v);
+        });
+        ok = ok && p != nullptr;
+    }
+    if (!ok) {
+        close();
+        return false;
+    }
+    state.clearSave();
+    for (uint8_t s = 0; s < MAX_PETS; s++) {
+        if (present[s]) state.writeRaw(s, saves[s]);
+    }
+
+    _mode = Mode::REPLAY;
+    _pos = (size_t)(p - _data);
+    _frame = 0;
+    _checks = 0;
+    _diverged = false;
+    _prevMillis = _prevGame = 0;
+    _prevWall = 0;
+    return true;
+}
+
+bool InputTape::finished() const {
+    if (_mode != Mode::REPLAY) return false;
+    TapeFrame f;
+    const uint8_t* p = parseFrame(_data + _pos, _data + _size, f);
+    return !p || (f.extra & EXTRA_END);
+}
+
+void InputTape::compare(uint64_t hash) {
+    _checks++;
+    if (hash == _check || _diverged) return;
+    _diverged = true;
+    _divergedAt = _frame;
+    Serial.printf("[TAPE] state differs from the recording at frame %lu\n", (unsigned long)_frame);
+}
+
+// ===== Frames =====
+
+unsigned long InputTape::beginFrame() {
+    _seedCount = 0;
+    _seedNext = 0;
+    if (_mode == Mode::RECORD) {
+        _millis = millis();
+        _game = _base->nowMs();
+        _wall = _base->wallSeconds();
+    } else if (_mode == Mode::REPLAY) {
+        TapeFrame f;
+        const uint8_t* p = parseFrame(_data + _pos, _data + _size, f);
+        _hasCheck = false;
+        if (p && !(f.extra & EXTRA_END)) {
+            _pos = (size_t)(p - _data);
+            _millis = _prevMillis + (unsigned long)f.dMillis;
+            _game = _prevGame + (unsigned long)f.dMillis + (unsigned long)f.dGameOver;
+            _wall = _prevWall + (uint32_t)f.dWall;
+            _bits = f.bits;
+            _seedCount = f.seedCount;
+            memcpy(_seeds, f.seeds, sizeof(_seeds));
+            _hasCheck = f.extra & EXTRA_CHECK;
+            _check = f.hash;
+            _prevMillis = _millis;
+            _prevGame = _game;
+            _prevWall = _wall;
+        }
+    } else {
+        return millis();
+    }
+    if (_frame == 0) _millis0 = _millis;
+    return _millis;
+}
+
+void InputTape::endFrame(uint64_t (*hash)()) {
+    if (_mode == Mode::RECORD && _file) {
+        bool check = _frame % TAPE_CHECK_FRAMES == 0;
+        writeRecord(check ? EXTRA_CHECK : 0, check ? hash() : 0);
+        if (check) flush(true);
+        if (_bytes + _used + 2 * MAX_FRAME > TAPE_MAX_BYTES) {
+            Serial.printf("[TAPE] full after %lu frames\n", (unsigned long)_frame + 1);
+            _frame++;
+            end(hash);
+            return;
+        }
+    } else if (_mode == Mode::REPLAY && _hasCheck) {
+        compare(hash());
+    }
+    if (_mode != Mode::OFF) _frame++;
+}
+
+void InputTape::end(uint64_t (*hash)()) {
+    if (_mode == Mode::RECORD && _file) {
+        _bits = 0;
+        _seedCount = 0;
+        _prevMillis = _millis;  // the END record carries no time
+        _prevGame = _game;
+        _prevWall = _wall;
+        writeRecord(EXTRA_CHECK | EXTRA_END, hash());
+        flush(true);
+        fclose(_file);
+        _file = nullptr;
+        Serial.printf("[TAPE] %lu frames, %lu bytes\n", (unsigned long)_frame, (unsigned long)_bytes);
+    } else if (_mode == Mode::REPLAY) {
+        TapeFrame f;
+        const uint8_t* p = parseFrame(_data + _pos, _data + _size, f);
+        if (p && (f.extra & EXTRA_END)) {
+            _check = f.hash;
+            compare(hash());
+        }
+    }
+}
+
+uint32_t InputTape::seed(uint32_t drawn) {
+    if (_mode == Mode::RECORD) {
+        if (_seedCount < MAX_PETS) _seeds[_seedCount++] = drawn;
+    } else if (_mode == Mode::REPLAY) {
+        if (_seedNext < _seedCount) return _seeds[_seedNext++];
+        if (!_diverged) {
+            _diverged = true;
+            _divergedAt = _frame;
+            Serial.printf("[TAPE] frame %lu hatched an egg the recording did not\n", (unsigned long)_frame);
+        }
+    }
+    return drawn;
+}
+
+unsigned long InputTape::realMs(unsigned long gameMs) const {
+    return _base ? _base->realMs(gameMs) : 0;
+}
+
+void InputTape::read(bool pressed[3], bool held[3]) {
+    if (_mode == Mode::RECORD) {
+        _buttons->read(pressed, held);
+        _bits = 0;
+        for (int i = 0; i < 3; i++) {
+            if (pressed[i]) _bits |= 1 << i;
+            if (held[i]) _bits |= 8 << i;
+        }
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        pressed[i] = _bits & (1 << i);
+        held[i] = _bits & (8 << i);
+    }
+}
+
+void InputTape::close() {
+    if (_file) {
+        flush(true);
+        fclose(_file);
+        _file = nullptr;
+    }
+    free(_data);
+    _data = nullptr;
+    _size = _pos = 0;
+    _mode = Mode::OFF;
+}
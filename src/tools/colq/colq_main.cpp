@@ -0,0 +1,364 @@
+// =============================================
+//  Column file query (colq env)
+//  Maps a simulator result file (sim --out) and counts, groups and
+//  averages rows under simple filters, decoding only the columns the
+//  query names and skipping chunks whose min/max rule them out. --csv
+//  runs the same query over the CSV of the same lives for comparison.
+// =============================================
+
+#include "columnar.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s FILE.scol [--where EXPR]... [--group COL] [--stat COL] [--csv FILE] [--info]\n"
+            "  EXPR: COL=V COL!=V COL<V COL<=V COL>V COL>=V (strings: = and != only)\n",
+            argv0);
+}
+
+enum class Op : uint8_t { EQ, NE, LT, LE, GT, GE };
+
+struct Filter {
+    std::string column;
+    Op op;
+    std::string value;
+    // Resolved against the column file
+    int      col = -1;
+    bool     string = false;
+    uint32_t v = 0;
+    bool     known = true;  // string value present in the dictionary
+
+    bool test(uint32_t x) const {
+        switch (op) {
+        case Op::EQ: return x == v;
+        case Op::NE: return x != v;
+        case Op::LT: return x < v;
+        case Op::LE: return x <= v;
+        case Op::GT: return x > v;
+        case Op::GE: return x >= v;
+        }
+        return false;
+    }
+    // Whether any value in [lo, hi] can pass
+    bool possible(uint32_t lo, uint32_t hi) const {
+        switch (op) {
+        case Op::EQ: return lo <= v && v <= hi;
+        case Op::NE: return !(lo == v && hi == v);
+        case Op::LT: return lo < v;
+        case Op::LE: return lo <= v;
+        case Op::GT: return hi > v;
+        case Op::GE: return hi >= v;
+        }
+        return true;
+    }
+};
+
+static bool parseFilter(const char* expr, Filter& f) {
+    static const struct { const char* text; Op op; } OPS[] = {
+        {"!=", Op::NE}, {"<=", Op::LE}, {">=", Op::GE}, {"=", Op::EQ}, {"<", Op::LT}, {">", Op::GT},
+    };
+    for (const char* p = expr; *p; p++) {
+        for (const auto& o : OPS) {
+            size_t n = strlen(o.text);
+            if (strncmp(p, o.text, n) != 0) continue;
+            f.column.assign(expr, (size_t)(p - expr));
+            f.op = o.op;
+            f.value = p + n;
+            return !f.column.empty() && !f.value.empty();
+        }
+    }
+    return false;
+}
+
+struct Agg {
+    uint64_t count = 0;
+    double   sum = 0;
+    uint32_t min = UINT32_MAX, max = 0;
+
+    void add(uint32_t x) {
+        count++;
+        sum += x;
+        if (x < min) min = x;
+        if (x > max) max = x;
+    }
+    bool operator==(const Agg& o) const {
+        return count == o.count && sum == o.sum && min == o.min && max == o.max;
+    }
+};
+
+// Results by group label ("" without --group)
+using Result = std::map<std::string, Agg>;
+
+static void printResult(const Result& r, const char* group, const char* stat) {
+    printf("%-20s %12s", group ? group : "", "rows");
+    if (stat) printf(" %12s %10s %10s", "mean", "min", "max");
+    printf("\n");
+    for (const auto& e : r) {
+        printf("%-20s %12llu", e.first.c_str(), (unsigned long long)e.second.count);
+        if (stat) {
+            printf(" %12.3f %10u %10u", e.second.count ? e.second.sum / e.second.count : 0.0,
+                   e.second.count ? e.second.min : 0, e.second.max);
+        }
+        printf("\n");
+    }
+}
+
+static const char* const ENCODING_NAMES[] = {"bitpack", "rle", "dict"};
+
+static void printInfo(const ColumnFile& f) {
+    printf("%llu rows in %zu groups, %zu columns, %.2f MB\n", (unsigned long long)f.rows(), f.groups(),
+           f.columns(), f.size() / 1e6);
+    printf("%-14s %-7s %12s %8s   chunks by encoding\n", "column", "type", "bytes", "bits/row");
+    for (size_t c = 0; c < f.columns(); c++) {
+        uint64_t bytes = 0;
+        size_t used[3] = {};
+        for (size_t g = 0; g < f.groups(); g++) {
+            bytes += f.chunkBytes(g, c);
+            used[static_cast<int>(f.encoding(g, c))]++;
+        }
+        printf("%-14s %-7s %12llu %8.2f  ", f.name(c).c_str(),
+               f.type(c) == ColumnType::STRING ? "string" : "uint", (unsigned long long)bytes,
+               f.rows() ? bytes * 8.0 / f.rows() : 0.0);
+        for (int e = 0; e < 3; e++) {
+            if (used[e]) printf(" %s %zu", ENCODING_NAMES[e], used[e]);
+        }
+        if (f.type(c) == ColumnType::STRING) printf("  (%zu strings)", f.dictionary(c).size());
+        printf("\n");
+    }
+}
+
+static std::string label(const ColumnFile& f, int col, uint32_t v) {
+    if (f.type(col) == ColumnType::STRING) {
+        return v < f.dictionary(col).size() ? f.dictionary(col)[v] : "?";
+    }
+    return std::to_string(v);
+}
+
+static bool queryColumns(const ColumnFile& f, std::vector<Filter>& filters, int groupCol, int statCol,
+                         Result& out, uint64_t& skipped) {
+    std::vector<uint32_t> cells(COLUMN_GROUP_ROWS), groupCells, statCells;
+    std::vector<uint8_t> selected;
+    std::map<uint32_t, Agg> byKey;
+    skipped = 0;
+    for (size_t g = 0; g < f.groups(); g++) {
+        uint32_t n = f.groupRows(g);
+        bool any = true;
+        for (const Filter& flt : filters) {
+            any = any && flt.known && flt.possible(f.min(g, flt.col), f.max(g, flt.col));
+        }
+        if (!any) {
+            skipped++;
+            continue;
+        }
+        if (cells.size() < n) cells.resize(n);
+        selected.assign(n, 1);
+        for (const Filter& flt : filters) {
+            if (!f.decode(g, flt.col, cells.data())) return false;
+            for (uint32_t i = 0; i < n; i++) selected[i] &= flt.test(cells[i]);
+        }
+        groupCells.resize(n);
+        statCells.resize(n);
+        if (groupCol >= 0 && !f.decode(g, groupCol, groupCells.data())) return false;
+        if (statCol >= 0 && !f.decode(g, statCol, statCells.data())) return false;
+        if (groupCol < 0) groupCells.assign(n, 0);
+        if (statCol < 0) statCells.assign(n, 0);
+        for (uint32_t i = 0; i < n; i++) {
+            if (selected[i]) byKey[groupCells[i]].add(statCells[i]);
+        }
+    }
+    for (const auto& e : byKey) out[groupCol >= 0 ? label(f, groupCol, e.first) : ""] = e.second;
+    return true;
+}
+
+// The same query over the CSV the simulator writes (no quoting: the
+// values never contain commas)
+static bool queryCsv(const char* path, const std::vector<Filter>& filters, const char* group,
+                     const char* stat, Result& out, size_t& bytes) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    bytes = (size_t)st.st_size;
+    const char* data = (const char*)mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    const char* end = data + bytes;
+
+    // Header: which field each filter, the group and the stat read
+    const char* p = data;
+    std::vector<int> filterField(filters.size(), -1);
+    int groupField = -1, statField = -1, fields = 0;
+    while (p < end && *p != '\n') {
+        const char* q = p;
+        while (q < end && *q != ',' && *q != '\n') q++;
+        std::string name(p, (size_t)(q - p));
+        for (size_t i = 0; i < filters.size(); i++) {
+            if (filters[i].column == name) filterField[i] = fields;
+        }
+        if (group && name == group) groupField = fields;
+        if (stat && name == stat) statField = fields;
+        fields++;
+        p = q < end && *q == ',' ? q + 1 : q;
+    }
+    p++;
+
+    std::vector<const char*> starts(fields), stops(fields);
+    std::map<std::string, Agg> result;
+    std::string key;
+    while (p < end) {
+        // Split the whole row; a row store has no way to read less
+        int f = 0;
+        const char* q = p;
+        while (q < end && *q != '\n') {
+            if (f < fields) starts[f] = q;
+            while (q < end && *q != ',' && *q != '\n') q++;
+            if (f < fields) stops[f] = q;
+            f++;
+            if (q < end && *q == ',') q++;
+        }
+        bool pass = f == fields;
+        for (size_t i = 0; pass && i < filters.size(); i++) {
+            const Filter& flt = filters[i];
+            int fi = filterField[i];
+            if (flt.string) {
+                bool eq = (size_t)(stops[fi] - starts[fi]) == flt.value.size() &&
+                          memcmp(starts[fi], flt.value.data(), flt.value.size()) == 0;
+                pass = flt.op == Op::EQ ? eq : !eq;
+            } else {
+                pass = flt.test((uint32_t)strtoul(starts[fi], nullptr, 10));
+            }
+        }
+        if (pass) {
+            key.assign(groupField >= 0 ? starts[groupField] : "", groupField >= 0 ? stops[groupField] - starts[groupField] : 0);
+            result[key].add(statField >= 0 ? (uint32_t)strtoul(starts[statField], nullptr, 10) : 0);
+        }
+        p = q + 1;
+    }
+    munmap((void*)data, bytes);
+    out = result;
+    return true;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    const char* csvPath = nullptr;
+    const char* group = nullptr;
+    const char* stat = nullptr;
+    bool info = false;
+    std::vector<Filter> filters;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--where") == 0 && i + 1 < argc) {
+            Filter f;
+            if (!parseFilter(argv[++i], f)) {
+                usage(argv[0]);
+                return 2;
+            }
+            filters.push_back(f);
+        } else if (strcmp(argv[i], "--group") == 0 && i + 1 < argc) {
+            group = argv[++i];
+        } else if (strcmp(argv[i], "--stat") == 0 && i + 1 < argc) {
+            stat = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (strcmp(argv[i], "--info") == 0) {
+            info = true;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!path) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    ColumnFile file;
+    std::string error;
+    if (!file.open(path, error)) {
+        fprintf(stderr, "stagotchi_colq: %s\n", error.c_str());
+        return 1;
+    }
+    if (info) printInfo(file);
+
+    // Resolve names; string filters compare dictionary ids
+    auto columnOf = [&](const std::string& name) {
+        int c = file.find(name);
+        if (c < 0) fprintf(stderr, "stagotchi_colq: no column %s\n", name.c_str());
+        return c;
+    };
+    for (Filter& f : filters) {
+        if ((f.col = columnOf(f.column)) < 0) return 2;
+        f.string = file.type(f.col) == ColumnType::STRING;
+        if (f.string) {
+            if (f.op != Op::EQ && f.op != Op::NE) {
+                usage(argv[0]);
+                return 2;
+            }
+            const auto& dict = file.dictionary(f.col);
+            f.known = false;
+            for (size_t i = 0; i < dict.size(); i++) {
+                if (dict[i] == f.value) {
+                    f.v = (uint32_t)i;
+                    f.known = true;
+                }
+            }
+            // Absent from the dictionary: "!=" passes every row
+            if (!f.known && f.op == Op::NE) {
+                f.known = true;
+                f.v = UINT32_MAX;
+            }
+        } else {
+            f.v = (uint32_t)strtoul(f.value.c_str(), nullptr, 10);
+        }
+    }
+    int groupCol = group ? columnOf(group) : -1;
+    int statCol = stat ? columnOf(stat) : -1;
+    if ((group && groupCol < 0) || (stat && statCol < 0)) return 2;
+
+    Result result;
+    uint64_t skipped = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!queryColumns(file, filters, groupCol, statCol, result, skipped)) {
+        fprintf(stderr, "stagotchi_colq: %s: damaged chunk\n", path);
+        return 1;
+    }
+    double secs = secondsSince(t0);
+    if (info) printf("\n");
+    printResult(result, group, stat);
+    printf("\ncolumnar %.2f MB, %.1f ms (%llu of %zu groups skipped)\n", file.size() / 1e6, secs * 1e3,
+           (unsigned long long)skipped, file.groups());
+
+    if (csvPath) {
+        Result csvResult;
+        size_t csvBytes = 0;
+        t0 = std::chrono::steady_clock::now();
+        if (!queryCsv(csvPath, filters, group, stat, csvResult, csvBytes)) {
+            fprintf(stderr, "stagotchi_colq: cannot read %s\n", csvPath);
+            return 1;
+        }
+        double csvSecs = secondsSince(t0);
+        printf("CSV      %.2f MB, %.1f ms; columnar is %.1fx smaller, %.1fx faster, %s\n", csvBytes / 1e6,
+               csvSecs * 1e3, file.size() ? (double)csvBytes / file.size() : 0.0,
+               secs > 0 ? csvSecs / secs : 0.0, csvResult == result ? "same result" : "** results differ **");
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+// =============================================
+//  Graveyard reader (graves env)
+//  Reads a lifetime archive copied off the device (graves.bin and, if
+//  present, graves.bin.idx). The summary comes from the index without
+//  touching the log; --last reads only the records it prints; --check
+//  scans the whole log and compares the index it builds with the stored one.
+// =============================================
+
+#include "character.h"
+#include "graveyard_format.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--last N | --dump | --check] graves.bin\n"
+            "  default: totals from the index, the best life and the last 5\n",
+            argv0);
+}
+
+static const char* const DEATH_NAMES[] = {"neglect", "sickness", "old age"};
+static_assert(sizeof(DEATH_NAMES) / sizeof(DEATH_NAMES[0]) == GRAVE_CAUSES, "one name per cause");
+
+static const char* characterName(CharacterID id) {
+    return id == CharacterID::NONE ? "?" : getCharacterDef(id).nameEN;
+}
+
+static std::string date(uint32_t wall) {
+    if (wall == 0) return "-";
+    time_t t = (time_t)wall;
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", localtime(&t));
+    return buf;
+}
+
+static void print(uint32_t n, const GraveRecord& r, bool ok) {
+    if (!ok) {
+        printf("#%-5u damaged\n", n + 1);
+        return;
+    }
+    std::string path;
+    for (CharacterID c : r.path) {
+        if (c == CharacterID::NONE) break;
+        if (!path.empty()) path += " > ";
+        path += characterName(c);
+    }
+    printf("#%-5u %-16s %4u h %02u m  %-8s  mistakes %-3u discipline %3u%%  weight %2ug\n"
+           "        %s .. %s\n        %s\n",
+           n + 1, characterName(r.finalForm()), r.minutes / 60, r.minutes % 60,
+           r.deathCause < GRAVE_CAUSES ? DEATH_NAMES[r.deathCause] : "?", r.careMistakes,
+           r.discipline, r.weight, date(r.startWall).c_str(), date(r.endWall).c_str(),
+           path.empty() ? "(path not recorded)" : path.c_str());
+}
+
+struct Archive {
+    FILE*    log = nullptr;
+    uint32_t records = 0;  // whole records in the log
+
+    bool read(uint32_t n, GraveRecord& r) {
+        uint8_t rec[GRAVE_RECORD_BYTES];
+        fseek(log, (long)n * GRAVE_RECORD_BYTES, SEEK_SET);
+        return fread(rec, 1, sizeof(rec), log) == sizeof(rec) && graveDecode(rec, r);
+    }
+};
+
+static GraveIndex scan(Archive& a) {
+    GraveIndex ix;
+    GraveRecord r;
+    for (uint32_t n = 0; n < a.records; n++) {
+        if (a.read(n, r)) {
+            ix.add(r);
+        } else {
+            ix.addDamaged();
+        }
+    }
+    return ix;
+}
+
+static bool sameIndex(const GraveIndex& a, const GraveIndex& b) {
+    uint8_t x[GRAVE_INDEX_BYTES], y[GRAVE_INDEX_BYTES];
+    graveIndexEncode(a, x);
+    graveIndexEncode(b, y);
+    return memcmp(x, y, sizeof(x)) == 0;
+}
+
+static void report(const GraveIndex& ix, Archive& a) {
+    printf("%u lives", ix.count);
+    if (ix.damaged) printf(" (%u damaged)", ix.damaged);
+    uint32_t good = ix.count - ix.damaged;
+    if (good) printf(", mean life %.1f h", (double)ix.totalMinutes / good / 60.0);
+    printf("\n");
+    if (ix.count == 0) return;
+
+    printf("\nby cause\n");
+    for (int i = 0; i < GRAVE_CAUSES; i++) {
+        if (ix.byCause[i]) printf("  %-16s %8u\n", DEATH_NAMES[i], ix.byCause[i]);
+    }
+    printf("\nby final form\n");
+    for (int i = 0; i < GRAVE_FORMS; i++) {
+        if (ix.byForm[i]) printf("  %-16s %8u\n", characterName(static_cast<CharacterID>(i)), ix.byForm[i]);
+    }
+
+    GraveRecord r;
+    if (ix.best != GRAVE_NONE) {
+        printf("\nlongest life\n");
+        print(ix.best, r, a.read(ix.best, r));
+    }
+}
+
+int main(int argc, char** argv) {
+    int last = -1;
+    bool dumpAll = false, check = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--last") == 0 && i + 1 < argc) {
+            last = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--dump") == 0) {
+            dumpAll = true;
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        } else if (argv[i][0] == '-' || path) {
+            usage(argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path || last == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Archive a;
+    a.log = fopen(path, "rb");
+    if (!a.log) {
+        fprintf(stderr, "stagotchi_graves: cannot read %s\n", path);
+        return 1;
+    }
+    fseek(a.log, 0, SEEK_END);
+    long size = ftell(a.log);
+    a.records = (uint32_t)(size / (long)GRAVE_RECORD_BYTES);
+    if (size % (long)GRAVE_RECORD_BYTES) {
+        fprintf(stderr, "stagotchi_graves: %s: torn record at the end, %ld bytes skipped\n",
+                path, size % (long)GRAVE_RECORD_BYTES);
+    }
+
+    // The device writes the index after each record; it can lag by one
+    std::string idxPath = std::string(path) + ".idx";
+    GraveIndex stored;
+    bool haveIndex = false;
+    if (FILE* f = fopen(idxPath.c_str(), "rb")) {
+        uint8_t buf[GRAVE_INDEX_BYTES + 1];
+        size_t got = fread(buf, 1, sizeof(buf), f);
+        fclose(f);
+        haveIndex = graveIndexDecode(buf, got, stored) && stored.count == a.records;
+    }
+
+    int status = 0;
+    GraveRecord r;
+    if (check) {
+        GraveIndex built = scan(a);
+        bool same = haveIndex && sameIndex(stored, built);
+        printf("%s: %u records, index %s\n", path, a.records,
+               same ? "matches the log" : haveIndex ? "DIFFERS from the log" : "missing or behind the log");
+        report(built, a);
+        status = same ? 0 : 3;
+    } else if (dumpAll) {
+        for (uint32_t n = 0; n < a.records; n++) print(n, r, a.read(n, r));
+    } else {
+        if (!haveIndex) {
+            fprintf(stderr, "stagotchi_graves: %s missing or behind the log; scanning\n", idxPath.c_str());
+            stored = scan(a);
+        }
+        if (last < 0) report(stored, a);
+        uint32_t n = last < 0 ? 5 : (uint32_t)last;
+        if (n > a.records) n = a.records;
+        if (n) printf("\nlast %u, newest first\n", n);
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t at = a.records - 1 - i;
+            print(at, r, a.read(at, r));
+        }
+    }
+    fclose(a.log);
+    return status;
+}
@@ -0,0 +1,286 @@
+// =============================================
+//  Event journal reader (journal env)
+//  Maps one or more journal files (oldest first, e.g. journal.bin.old
+//  journal.bin) and either dumps the records or summarises them: lives,
+//  deaths, evolutions, care mistakes and how long each kind of call for
+//  care waited for an answer.
+// =============================================
+
+#include "character.h"
+#include "journal_format.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--dump] [--pet SLOT] FILE...\n"
+            "  files are read in the order given, so list the .old file first\n",
+            argv0);
+}
+
+static const char* const OP_NAMES[] = {
+    "SESSION", "PET", "EGG", "AGE", "HUNGER", "HAPPINESS", "POOP", "SICK",
+    "SLEEP", "ATTENTION", "RESOLVED", "MISTAKE", "ACTION", "EVOLVE", "DEATH",
+};
+static_assert(sizeof(OP_NAMES) / sizeof(OP_NAMES[0]) == static_cast<size_t>(JournalOp::COUNT), "one name per op");
+
+static const char* const ACTION_NAMES[] = {
+    "meal", "snack", "game", "game win", "game lose", "discipline", "medicine", "clean", "light",
+};
+static_assert(sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]) == static_cast<size_t>(JournalAction::COUNT),
+              "one name per action");
+
+// Indexed by AttentionType
+static const char* const ATTENTION_NAMES[] = {"none", "hungry", "unhappy", "discipline", "sick", "poop", "sleep"};
+constexpr int ATTENTION_TYPES = sizeof(ATTENTION_NAMES) / sizeof(ATTENTION_NAMES[0]);
+
+static const char* const DEATH_NAMES[] = {"neglect", "sickness", "old age"};
+constexpr int DEATH_CAUSES = sizeof(DEATH_NAMES) / sizeof(DEATH_NAMES[0]);
+
+constexpr int SLOTS = 8;  // more than MAX_PETS; the reader does not need config.h
+
+static const char* characterName(uint32_t id) {
+    if (id >= static_cast<uint32_t>(CharacterID::CHARACTER_COUNT)) return "?";
+    return getCharacterDef(static_cast<CharacterID>(id)).nameEN;
+}
+
+static const char* nameOf(const char* const* names, int count, uint32_t i) {
+    return i < (uint32_t)count ? names[i] : "?";
+}
+
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+static bool mapFile(const char* path, MappedFile& m) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    m.size = ok ? (size_t)st.st_size : 0;
+    if (ok && m.size > 0) {
+        void* p = mmap(nullptr, m.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ok = p != MAP_FAILED;
+        if (ok) {
+            madvise(p, m.size, MADV_SEQUENTIAL);
+            m.data = (const uint8_t*)p;
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+struct Summary {
+    uint64_t records = 0, sessions = 0;
+    uint64_t ops[static_cast<int>(JournalOp::COUNT)] = {};
+    uint64_t lives = 0, deaths[DEATH_CAUSES] = {};
+    double   lifeMsTotal = 0;
+    uint64_t lifeCount = 0;  // lives seen from egg to death
+    uint64_t evolvedTo[static_cast<int>(CharacterID::CHARACTER_COUNT)] = {};
+    uint64_t calls[ATTENTION_TYPES] = {}, answered[ATTENTION_TYPES] = {}, missed[ATTENTION_TYPES] = {};
+    double   waitMsTotal[ATTENTION_TYPES] = {};
+    uint32_t waitMsMax[ATTENTION_TYPES] = {};
+    uint64_t actions[static_cast<int>(JournalAction::COUNT)][2] = {};
+};
+
+// What the summary needs to remember per slot between records
+struct SlotTrack {
+    bool     alive = false;
+    uint32_t eggMs = 0;
+    bool     calling[ATTENTION_TYPES] = {};
+    uint32_t calledMs[ATTENTION_TYPES] = {};
+};
+
+static void tally(Summary& s, SlotTrack& t, const JournalRecord& r) {
+    s.ops[static_cast<int>(r.op)]++;
+    switch (r.op) {
+    case JournalOp::EGG:
+        s.lives++;
+        t = SlotTrack();
+        t.alive = true;
+        t.eggMs = r.ms;
+        break;
+    case JournalOp::ATTENTION:
+        if (r.a < (uint32_t)ATTENTION_TYPES) {
+            s.calls[r.a]++;
+            t.calling[r.a] = true;
+            t.calledMs[r.a] = r.ms;
+        }
+        break;
+    case JournalOp::RESOLVED:
+        if (r.a < (uint32_t)ATTENTION_TYPES && t.calling[r.a]) {
+            uint32_t wait = r.ms - t.calledMs[r.a];
+            s.answered[r.a]++;
+            s.waitMsTotal[r.a] += wait;
+            if (wait > s.waitMsMax[r.a]) s.waitMsMax[r.a] = wait;
+            t.calling[r.a] = false;
+        }
+        break;
+    case JournalOp::MISTAKE:
+        if (r.a < (uint32_t)ATTENTION_TYPES) {
+            s.missed[r.a]++;
+            t.calling[r.a] = false;
+        }
+        break;
+    case JournalOp::ACTION:
+        if (r.a < static_cast<uint32_t>(JournalAction::COUNT)) s.actions[r.a][r.b ? 1 : 0]++;
+        break;
+    case JournalOp::EVOLVE:
+        if (r.b < static_cast<uint32_t>(CharacterID::CHARACTER_COUNT)) s.evolvedTo[r.b]++;
+        break;
+    case JournalOp::DEATH:
+        if (r.a < (uint32_t)DEATH_CAUSES) s.deaths[r.a]++;
+        if (t.alive) {
+            s.lifeMsTotal += (double)(uint32_t)(r.ms - t.eggMs);
+            s.lifeCount++;
+        }
+        t.alive = false;
+        break;
+    default:
+        break;
+    }
+}
+
+static void dump(const JournalRecord& r) {
+    printf("%u %10u %-9s", r.slot, r.ms, OP_NAMES[static_cast<int>(r.op)]);
+    switch (r.op) {
+    case JournalOp::SESSION:
+        printf(" wall=%u\n", r.b);
+        break;
+    case JournalOp::ATTENTION:
+    case JournalOp::RESOLVED:
+    case JournalOp::MISTAKE:
+        printf(" %s\n", nameOf(ATTENTION_NAMES, ATTENTION_TYPES, r.a));
+        break;
+    case JournalOp::ACTION:
+        printf(" %s%s\n", nameOf(ACTION_NAMES, static_cast<int>(JournalAction::COUNT), r.a),
+               r.b ? "" : " (refused)");
+        break;
+    case JournalOp::EVOLVE:
+        printf(" %s -> %s\n", characterName(r.a), characterName(r.b));
+        break;
+    case JournalOp::DEATH:
+        printf(" %s\n", nameOf(DEATH_NAMES, DEATH_CAUSES, r.a));
+        break;
+    default:
+        printf(" %u\n", r.a);
+        break;
+    }
+}
+
+static void report(const Summary& s, size_t bytes, double secs) {
+    printf("%llu records in %llu sessions, %.1f MB; decoded at %.1f M records/s (%.0f MB/s)\n",
+           (unsigned long long)s.records, (unsigned long long)s.sessions, bytes / 1e6,
+           s.records / secs / 1e6, bytes / secs / 1e6);
+
+    printf("\nrecords by op\n");
+    for (int i = 0; i < static_cast<int>(JournalOp::COUNT); i++) {
+        if (s.ops[i]) printf("  %-10s %12llu\n", OP_NAMES[i], (unsigned long long)s.ops[i]);
+    }
+
+    uint64_t dead = 0;
+    for (int i = 0; i < DEATH_CAUSES; i++) dead += s.deaths[i];
+    printf("\nlives %llu, deaths %llu", (unsigned long long)s.lives, (unsigned long long)dead);
+    if (s.lifeCount) printf(", mean life %.2f days", s.lifeMsTotal / s.lifeCount / 86400000.0);
+    printf("\n");
+    for (int i = 0; i < DEATH_CAUSES; i++) {
+        if (s.deaths[i]) printf("  %-10s %12llu\n", DEATH_NAMES[i], (unsigned long long)s.deaths[i]);
+    }
+
+    printf("\nevolutions\n");
+    for (int i = 0; i < static_cast<int>(CharacterID::CHARACTER_COUNT); i++) {
+        if (s.evolvedTo[i]) printf("  %-16s %10llu\n", characterName(i), (unsigned long long)s.evolvedTo[i]);
+    }
+
+    printf("\n%-11s %10s %10s %10s %12s %12s\n", "care", "calls", "answered", "mistakes", "mean wait s", "max wait s");
+    for (int i = 1; i < ATTENTION_TYPES; i++) {
+        if (!s.calls[i] && !s.missed[i]) continue;
+        double mean = s.answered[i] ? s.waitMsTotal[i] / s.answered[i] / 1000.0 : 0;
+        printf("%-11s %10llu %10llu %10llu %12.1f %12.1f\n", ATTENTION_NAMES[i],
+               (unsigned long long)s.calls[i], (unsigned long long)s.answered[i],
+               (unsigned long long)s.missed[i], mean, s.waitMsMax[i] / 1000.0);
+    }
+
+    printf("\n%-11s %10s %10s\n", "action", "accepted", "refused");
+    for (int i = 0; i < static_cast<int>(JournalAction::COUNT); i++) {
+        if (!s.actions[i][0] && !s.actions[i][1]) continue;
+        printf("%-11s %10llu %10llu\n", ACTION_NAMES[i],
+               (unsigned long long)s.actions[i][1], (unsigned long long)s.actions[i][0]);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool dumpAll = false;
+    int petFilter = -1;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dump") == 0) {
+            dumpAll = true;
+        } else if (strcmp(argv[i], "--pet") == 0 && i + 1 < argc) {
+            petFilter = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || petFilter >= SLOTS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<MappedFile> files(paths.size());
+    size_t bytes = 0;
+    for (size_t f = 0; f < paths.size(); f++) {
+        if (!mapFile(paths[f], files[f])) {
+            fprintf(stderr, "stagotchi_journal: cannot read %s\n", paths[f]);
+            return 1;
+        }
+        bytes += files[f].size;
+    }
+
+    Summary* sum = new Summary();
+    SlotTrack track[SLOTS];
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < files.size(); f++) {
+        JournalCursor cur(files[f].data, files[f].size);
+        JournalRecord r;
+        while (cur.next(r)) {
+            if (r.op == JournalOp::SESSION) {
+                // millis() restarted, so waits across a reboot are not
+                // measurable; applies to every slot whichever is filtered
+                for (SlotTrack& t : track) {
+                    for (bool& c : t.calling) c = false;
+                }
+                sum->records++;
+                sum->sessions++;
+                sum->ops[0]++;
+                if (dumpAll) dump(r);
+                continue;
+            }
+            if (r.op == JournalOp::PET || r.slot >= SLOTS) continue;
+            if (petFilter >= 0 && r.slot != petFilter) continue;
+            sum->records++;
+            if (dumpAll) dump(r);
+            else tally(*sum, track[r.slot], r);
+        }
+        // The device may die mid-write; a torn last record is expected there
+        if (!cur.ok()) {
+            fprintf(stderr, "stagotchi_journal: %s: stopped at a damaged record, %zu bytes skipped\n",
+                    paths[f], cur.remaining());
+        }
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!dumpAll) report(*sum, bytes, secs > 0 ? secs : 1e-9);
+    delete sum;
+    return 0;
+}
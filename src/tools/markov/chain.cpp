@@ -0,0 +1,414 @@
+#include "chain.h"
+#include "work_pool.h"
+#include "minigame.h"
+#include "clock.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+// ===== State encoding =====
+
+namespace {
+
+class Packer {
+public:
+    explicit Packer(uint8_t* p) : _p(p) {}
+    void u8(uint8_t v) { *_p++ = v; }
+    void u16(uint16_t v) { u8(v & 0xFF); u8(v >> 8); }
+    void u32(uint32_t v) { u16(v & 0xFFFF); u16(v >> 16); }
+
+private:
+    uint8_t* _p;
+};
+
+class Unpacker {
+public:
+    explicit Unpacker(const uint8_t* p) : _p(p) {}
+    uint8_t  u8() { return *_p++; }
+    uint16_t u16() { uint16_t lo = u8(); return lo | (uint16_t)(u8() << 8); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | ((uint32_t)u16() << 16); }
+
+private:
+    const uint8_t* _p;
+};
+
+bool attentionTimed(AttentionType a) {
+    // SLEEP and DISCIPLINE calls never time out or kill
+    return a != AttentionType::NONE && a != AttentionType::SLEEP &&
+           a != AttentionType::DISCIPLINE;
+}
+
+}  // namespace
+
+PetState PetState::encode(const PetData& d, uint16_t reached, unsigned long nowMs) {
+    PetState s;
+    s.reached = reached;
+    Packer p(s.bytes.data());
+    p.u8(static_cast<uint8_t>(d.characterId));
+    p.u8(static_cast<uint8_t>(d.stage));
+    p.u8(d.hunger);
+    p.u8(d.happiness);
+    p.u8(d.discipline);
+    p.u16(d.age);
+    p.u8(d.poopCount);
+    p.u8(d.isSick);
+    p.u8(d.sicknessLevel);
+    p.u8(d.medicineGiven);
+    p.u8(d.isAsleep);
+    p.u8(d.lightOff);
+    p.u8(d.careMistakes);
+    p.u16(d.totalCareMistakes);
+    p.u8(static_cast<uint8_t>(d.pendingAttention));
+    p.u8(d.readyToEvolve);
+
+    auto ago = [nowMs](unsigned long t) { return (uint32_t)(nowMs - t); };
+    // Only read while a timed call is pending; set when one starts
+    p.u32(attentionTimed(d.pendingAttention) ? ago(d.attentionStartMs) : 0);
+    p.u32(ago(d.lastHungerDecayMs));
+    p.u32(ago(d.lastHappyDecayMs));
+    p.u32(ago(d.lastPoopMs));
+    p.u32(ago(d.lastAgeTickMs));
+    // Only read while sick or at 3+ poops; set when either starts
+    p.u32(d.isSick || d.poopCount >= 3 ? ago(d.lastSickCheckMs) : 0);
+    p.u32(ago(d.lastDisciplineMs));
+    // Only the egg and baby timers run from the stage start
+    p.u32(d.stage <= LifeStage::BABY ? ago(d.stageStartMs) : 0);
+    return s;
+}
+
+PetData PetState::decode(unsigned long nowMs) const {
+    PetData d;
+    Unpacker u(bytes.data());
+    d.characterId   = static_cast<CharacterID>(u.u8());
+    d.stage         = static_cast<LifeStage>(u.u8());
+    d.hunger        = u.u8();
+    d.happiness     = u.u8();
+    d.discipline    = u.u8();
+    d.age           = u.u16();
+    d.poopCount     = u.u8();
+    d.isSick        = u.u8();
+    d.sicknessLevel = u.u8();
+    d.medicineGiven = u.u8();
+    d.isAsleep      = u.u8();
+    d.lightOff      = u.u8();
+    d.careMistakes  = u.u8();
+    d.totalCareMistakes = u.u16();
+    d.pendingAttention  = static_cast<AttentionType>(u.u8());
+    d.readyToEvolve     = u.u8();
+    d.attentionStartMs  = nowMs - u.u32();
+    d.lastHungerDecayMs = nowMs - u.u32();
+    d.lastHappyDecayMs  = nowMs - u.u32();
+    d.lastPoopMs        = nowMs - u.u32();
+    d.lastAgeTickMs     = nowMs - u.u32();
+    d.lastSickCheckMs   = nowMs - u.u32();
+    d.lastDisciplineMs  = nowMs - u.u32();
+    d.stageStartMs      = nowMs - u.u32();
+    d.totalAge = d.age;
+    return d;
+}
+
+size_t PetStateHash::operator()(const PetState& s) const {
+    // FNV-1a, then a final mix for the low bits unordered_map uses
+    uint64_t h = 0xCBF29CE484222325ULL ^ s.reached;
+    for (uint8_t b : s.bytes) h = (h ^ b) * 0x100000001B3ULL;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return (size_t)(h ^ (h >> 32));
+}
+
+// ===== Minigame odds =====
+
+double gameWinChance(bool guessWell) {
+    // p[n][w]: chance of showing n with w wins so far; the next number is
+    // any of the other eight, and a good guess bets on the larger side
+    double p[10][6] = {};
+    for (int n = 1; n <= 9; n++) p[n][0] = 1.0 / 9;
+    for (int round = 0; round < 5; round++) {
+        double q[10][6] = {};
+        for (int n = 1; n <= 9; n++) {
+            double right = guessWell ? std::max(9 - n, n - 1) / 8.0 : 0.5;
+            for (int w = 0; w <= round; w++) {
+                if (p[n][w] == 0) continue;
+                for (int m = 1; m <= 9; m++) {
+                    if (m == n) continue;
+                    // Blind guesses are right half the time whatever m is
+                    bool hit = guessWell ? (n < 5 ? m > n : n > 5 ? m < n : m > n) : false;
+                    double toM = p[n][w] / 8.0;
+                    if (guessWell) {
+                        q[m][w + (hit ? 1 : 0)] += toM;
+                    } else {
+                        q[m][w + 1] += toM * right;
+                        q[m][w] += toM * (1 - right);
+                    }
+                }
+            }
+        }
+        memcpy(p, q, sizeof(p));
+    }
+    double win = 0;
+    for (int n = 1; n <= 9; n++) {
+        for (int w = 3; w <= 5; w++) win += p[n][w];
+    }
+    return win;
+}
+
+// ===== Roll enumeration =====
+
+namespace {
+
+// Answers the pet's rolls along one path of choices at a time and steps
+// to the next path in depth-first order. Runs are deterministic, so the
+// same prefix of answers always meets the same next roll.
+class RollPaths : public RngOracle {
+public:
+    void begin() { _pos = 0; }
+
+    uint32_t next() override { return 0; }  // only seeds minigames, which are not replayed
+    uint32_t below(uint32_t n) override { return take(n, -1.0); }
+    bool chance(double p) { return take(2, p) == 0; }
+
+    double weight() const {
+        double w = 1;
+        for (const Roll& r : _path) {
+            w *= r.p < 0 ? 1.0 / r.count : (r.taken == 0 ? r.p : 1 - r.p);
+        }
+        return w;
+    }
+
+    bool advance() {
+        while (!_path.empty()) {
+            if (++_path.back().taken < _path.back().count) return true;
+            _path.pop_back();
+        }
+        return false;
+    }
+
+private:
+    struct Roll {
+        uint32_t taken, count;
+        double   p;  // < 0: uniform over count
+    };
+    std::vector<Roll> _path;
+    size_t            _pos = 0;
+
+    uint32_t take(uint32_t n, double p) {
+        if (_pos == _path.size()) _path.push_back({0, n, p});
+        return _path[_pos++].taken;
+    }
+};
+
+// Plays minigames by their odds instead of by the pet's stream
+class ExactCareSession : public CareSession {
+public:
+    ExactCareSession(PetManager& pet, MiniGame& game, Clock& clock, Rng& rng, RollPaths& paths,
+                     const double* winChance)
+        : CareSession(pet, game, clock, rng), _paths(paths), _winChance(winChance) {}
+
+protected:
+    bool playGame(bool guessWell) override {
+        if (!_pet.startGame()) return false;
+        _pet.nextRandom();  // the device seeds the game from the pet's stream
+        if (_paths.chance(_winChance[guessWell ? 1 : 0])) {
+            _pet.onGameWin();
+        } else {
+            _pet.onGameLose();
+        }
+        return true;
+    }
+
+private:
+    RollPaths&    _paths;
+    const double* _winChance;
+};
+
+using StateMap = std::unordered_map<PetState, double, PetStateHash>;
+
+// Per-thread results of one step
+struct Worker {
+    StateMap    next;
+    ChainResult ended;
+    double      mistakeSum = 0;
+    uint64_t    transitions = 0;
+    RollPaths   paths;
+};
+
+void recordEnd(ChainResult& r, double& mistakeSum, const PetData& d, uint16_t reached,
+               CharacterID form, uint8_t cause, double p) {
+    r.death[cause] += p;
+    r.finalForm[static_cast<int>(form)] += p;
+    for (int c = 0; c < ChainResult::CHARS; c++) {
+        if (reached & (1u << c)) r.reached[c] += p;
+    }
+    size_t age = std::min<size_t>(d.age, r.ageAtEnd.size() - 1);
+    r.ageAtEnd[age] += p;
+    mistakeSum += p * d.totalCareMistakes;
+}
+
+bool sameRng(const Rng& a, const Rng& b) {
+    return memcmp(a.s, b.s, sizeof(a.s)) == 0;
+}
+
+}  // namespace
+
+// ===== Solver =====
+
+bool ChainSolver::solve(ChainResult& out, std::string& error) {
+    const uint32_t startWall = SIM_EPOCH + _opt.startHour * 3600UL;
+    const unsigned long limitMs = _opt.maxDays * 86400000UL;
+    const double winChance[2] = {gameWinChance(false), gameWinChance(true)};
+    const size_t ageBuckets = _opt.maxDays * 24UL + 1;
+    out = ChainResult();
+    out.ageAtEnd.assign(ageBuckets, 0);
+
+    WorkStealingPool pool(_threads);
+    std::vector<Worker> workers(pool.threads());
+    for (auto& w : workers) w.ended.ageAtEnd.assign(ageBuckets, 0);
+    std::atomic<bool> usedChance(false);
+
+    // The policy's own stream must stay untouched for the answer to be exact
+    const Rng untouched;
+    Rng policyRng;
+
+    std::vector<std::pair<PetState, double>> cur;
+    {
+        PetManager pet;
+        pet.setRules(_opt.rules);
+        pet.initNewEgg(0, 0);
+        uint16_t eggBit = 1u << static_cast<int>(CharacterID::EGG);
+        cur.push_back({PetState::encode(pet.data(), eggBit, 0), 1.0});
+    }
+
+    unsigned long t = 0;
+    while (!cur.empty() && t < limitMs) {
+        uint32_t wall = startWall + t / 1000;
+        uint32_t next = _policy.nextCheck(wall, policyRng);
+        if (!sameRng(policyRng, untouched)) usedChance = true;
+        uint64_t until = t - t % 1000 + (uint64_t)(next - wall) * 1000ULL;
+        const bool checkIn = until < limitMs;
+        const unsigned long stepEnd = checkIn ? (unsigned long)until : limitMs;
+
+        pool.run(cur.size(), 64, [&](unsigned wi, uint64_t begin, uint64_t end) {
+            Worker& w = workers[wi];
+            MiniGame game;
+            Rng sessionRng;
+            for (uint64_t i = begin; i < end; i++) {
+                const PetState& from = cur[i].first;
+                const double p = cur[i].second;
+                w.paths = RollPaths();
+                do {
+                    w.paths.begin();
+                    PetManager pet;
+                    pet.setRules(_opt.rules);
+                    pet.loadFromSave(from.decode(t));
+                    RngOverride& ov = rngOverride();
+                    ov.rng = &pet.data().rng;
+                    ov.oracle = &w.paths;
+
+                    VirtualClock clock(startWall);
+                    clock.advance(t);
+                    LifeOutcome life;
+                    life.reached = from.reached;
+                    life.finalForm = pet.data().characterId;
+                    liveUntil(pet, clock, stepEnd, life);
+                    if (checkIn && !pet.data().isDead) {
+                        ExactCareSession s(pet, game, clock, sessionRng, w.paths, winChance);
+                        _policy.care(s);
+                    }
+                    ov = RngOverride();
+                    w.transitions++;
+
+                    double q = p * w.paths.weight();
+                    if (q == 0) continue;
+                    const PetData& d = pet.data();
+                    if (d.isDead) {
+                        uint8_t cause = d.deathCause < DEATH_CAUSES ? d.deathCause : 0;
+                        recordEnd(w.ended, w.mistakeSum, d, (uint16_t)life.reached,
+                                  life.finalForm, cause, q);
+                    } else {
+                        w.next[PetState::encode(d, (uint16_t)life.reached, stepEnd)] += q;
+                    }
+                } while (w.paths.advance());
+            }
+            if (!sameRng(sessionRng, untouched)) usedChance = true;
+        });
+        if (usedChance) {
+            error = std::string("policy '") + _policy.name() +
+                    "' leaves things to chance; the exact solver needs a fixed schedule";
+            return false;
+        }
+
+        // Merge the workers' next states; a sorted vector keeps the next
+        // step's work order independent of how this one was split up
+        StateMap merged;
+        for (auto& w : workers) {
+            for (const auto& kv : w.next) merged[kv.first] += kv.second;
+            w.next.clear();
+        }
+        cur.assign(merged.begin(), merged.end());
+        std::sort(cur.begin(), cur.end(),
+                  [](const std::pair<PetState, double>& a, const std::pair<PetState, double>& b) {
+                      return a.first < b.first;
+                  });
+        out.peakStates = std::max<uint64_t>(out.peakStates, cur.size());
+        out.steps++;
+        t = stepEnd;
+    }
+
+    // Whatever is left was still alive at the cutoff
+    double mistakeSum = 0;
+    for (const auto& sp : cur) {
+        PetData d = sp.first.decode(t);
+        recordEnd(out, mistakeSum, d, sp.first.reached, d.characterId, STILL_ALIVE, sp.second);
+    }
+    for (const auto& w : workers) {
+        for (int i = 0; i <= DEATH_CAUSES; i++) out.death[i] += w.ended.death[i];
+        for (int c = 0; c < ChainResult::CHARS; c++) {
+            out.finalForm[c] += w.ended.finalForm[c];
+            out.reached[c] += w.ended.reached[c];
+        }
+        for (size_t a = 0; a < ageBuckets; a++) out.ageAtEnd[a] += w.ended.ageAtEnd[a];
+        mistakeSum += w.mistakeSum;
+        out.transitions += w.transitions;
+    }
+    out.meanMistakes = mistakeSum;
+    return true;
+}
+
+void ChainResult::print(FILE* out, const char* title) const {
+    double total = 0, mean = 0;
+    for (size_t a = 0; a < ageAtEnd.size(); a++) {
+        total += ageAtEnd[a];
+        mean += a * ageAtEnd[a];
+    }
+    auto quantile = [&](double q) {
+        double seen = 0;
+        for (size_t a = 0; a < ageAtEnd.size(); a++) {
+            seen += ageAtEnd[a];
+            if (seen >= q * total - 1e-12) return a;
+        }
+        return ageAtEnd.size() - 1;
+    };
+
+    fprintf(out, "== %s: exact (total probability %.12f)\n", title, total);
+    fprintf(out, "  age at end     mean %6.1f h   p10 %zu  median %zu  p90 %zu\n",
+            mean, quantile(0.1), quantile(0.5), quantile(0.9));
+    fprintf(out, "  care mistakes  mean %6.2f\n", meanMistakes);
+
+    static const char* const CAUSES[DEATH_CAUSES + 1] = {"hunger", "sickness", "old age", "alive at cutoff"};
+    fprintf(out, "  end of life\n");
+    for (int i = 0; i <= DEATH_CAUSES; i++) {
+        fprintf(out, "    %-16s %10.6f%%\n", CAUSES[i], 100.0 * death[i]);
+    }
+    fprintf(out, "  reached / last form\n");
+    for (int c = static_cast<int>(CharacterID::BABY_CHAN); c < CHARS; c++) {
+        if (c == static_cast<int>(CharacterID::GHOST)) continue;
+        fprintf(out, "    %-16s %10.6f%%   %10.6f%%\n",
+                getCharacterDef(static_cast<CharacterID>(c)).nameEN,
+                100.0 * reached[c], 100.0 * finalForm[c]);
+    }
+    fprintf(out, "  %llu steps, %llu state transitions, peak %llu states\n",
+            (unsigned long long)steps, (unsigned long long)transitions,
+            (unsigned long long)peakStates);
+}
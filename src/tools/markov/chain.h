@@ -0,0 +1,70 @@
+#pragma once
+#include "lifecycle.h"
+#include "pet.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Everything in PetData that can still change how a life goes, packed
+// into a hashable key. Timers are stored as "ms ago" relative to the
+// step time, so pets with the same history in different steps compare
+// equal. Fields the rules never read again (weight, disciplineCalls,
+// totalAge, the rng, timers that are rewritten before their next use)
+// are dropped, which merges states that can only lead to the same
+// futures.
+struct PetState {
+    std::array<uint8_t, 52> bytes{};
+    uint16_t reached = 0;  // forms so far, bit per CharacterID
+
+    bool operator==(const PetState& o) const { return bytes == o.bytes && reached == o.reached; }
+    bool operator<(const PetState& o) const {
+        return bytes != o.bytes ? bytes < o.bytes : reached < o.reached;
+    }
+
+    static PetState encode(const PetData& d, uint16_t reached, unsigned long nowMs);
+    PetData decode(unsigned long nowMs) const;
+};
+
+struct PetStateHash {
+    size_t operator()(const PetState& s) const;
+};
+
+// Exact outcome distribution of one policy
+struct ChainResult {
+    static constexpr int CHARS = static_cast<int>(CharacterID::CHARACTER_COUNT);
+
+    double death[DEATH_CAUSES + 1] = {};  // last entry: alive at the cutoff
+    double finalForm[CHARS] = {};
+    double reached[CHARS]   = {};
+    std::vector<double> ageAtEnd;         // probability per hour of age
+    double meanMistakes = 0;
+
+    uint64_t steps = 0;        // check-in intervals solved
+    uint64_t transitions = 0;  // (state, roll path) pairs simulated
+    uint64_t peakStates = 0;
+
+    void print(FILE* out, const char* title) const;
+};
+
+// Forward-propagates the probability of every distinct pet state from
+// one check-in to the next. Each state is expanded by re-running the real
+// PetManager once per combination of its chance rolls (taken over with
+// an RngOracle), and the results are merged by key. Needs a policy whose
+// check-in times and choices involve no chance (perfect, replay:FILE);
+// minigames are counted by their exact win probability.
+class ChainSolver {
+public:
+    ChainSolver(const CarePolicy& policy, const SimOptions& opt, unsigned threads)
+        : _policy(policy), _opt(opt), _threads(threads) {}
+
+    // False (with error set) if the policy turned out to use chance
+    bool solve(ChainResult& out, std::string& error);
+
+private:
+    const CarePolicy& _policy;
+    SimOptions        _opt;
+    unsigned          _threads;
+};
+
+// Chance that one minigame ends in a win (3 of 5 guesses right)
+double gameWinChance(bool guessWell);
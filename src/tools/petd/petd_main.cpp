@@ -0,0 +1,199 @@
+// =============================================
+//  Pet hosting daemon (petd env, Linux)
+//  Keeps many pets alive on the firmware's own rules, sharded over
+//  worker threads, and serves actions and queries on a Unix socket
+//  (wire format in protocol.h).
+// =============================================
+
+#include "shard.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t gStop = 0;
+
+static void onSignal(int) { gStop = 1; }
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--socket PATH] [--shards N] [--tick-ms MS] [--time-scale X]\n"
+            "  --tick-ms 0 steps the pets as fast as the shards can go\n"
+            "  game time is 32-bit millis() as on the device: restart within\n"
+            "  49 days / X of uptime\n",
+            argv0);
+}
+
+// Threads started with SIGINT/SIGTERM blocked, so only main sees them
+template <typename Fn>
+static std::thread quietThread(Fn fn) {
+    sigset_t all, old;
+    sigemptyset(&all);
+    sigaddset(&all, SIGINT);
+    sigaddset(&all, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    std::thread t(fn);
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+    return t;
+}
+
+// Reads requests off one client and hands them to the shards, one batch
+// per shard per read()
+static void serve(std::shared_ptr<Connection> conn, std::vector<std::unique_ptr<Shard>>& shards,
+                  std::atomic<uint32_t>& nextShard) {
+    const unsigned count = (unsigned)shards.size();
+    std::vector<std::vector<PendingRequest>> batches(count);
+    std::vector<uint8_t> buf(64 * 1024);
+    size_t have = 0;
+    for (;;) {
+        ssize_t n = recv(conn->fd(), buf.data() + have, buf.size() - have, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        have += (size_t)n;
+
+        size_t used = 0;
+        for (; have - used >= REQUEST_SIZE; used += REQUEST_SIZE) {
+            WireRequest r = decodeRequest(buf.data() + used);
+            if (r.op == WireOp::STATS || r.op >= WireOp::COUNT) {
+                WireResponse out;
+                out.tag = r.tag;
+                out.op = r.op;
+                if (r.op == WireOp::STATS) {
+                    for (auto& s : shards) s->addStats(out.stats);
+                } else {
+                    out.status = WireStatus::BAD_OP;
+                }
+                uint8_t bytes[RESPONSE_SIZE];
+                encodeResponse(out, bytes);
+                conn->send(bytes, sizeof(bytes));
+                continue;
+            }
+            unsigned s = r.op == WireOp::CREATE ? nextShard++ % count : r.pet % count;
+            batches[s].push_back({r, conn});
+        }
+        memmove(buf.data(), buf.data() + used, have - used);
+        have -= used;
+        for (unsigned s = 0; s < count; s++) {
+            if (!batches[s].empty()) shards[s]->submit(batches[s]);
+        }
+    }
+}
+
+// One client and the thread reading it; done is set as the thread leaves.
+// The thread (and requests in flight) own the connection, so its fd
+// closes as soon as the client has gone.
+struct Reader {
+    std::weak_ptr<Connection>          conn;
+    std::shared_ptr<std::atomic<bool>> done;
+    std::thread                        thread;
+};
+
+// Joins the readers whose clients have gone, so their threads and fds
+// don't pile up for the life of the daemon
+static void reap(std::vector<Reader>& readers) {
+    size_t kept = 0;
+    for (size_t i = 0; i < readers.size(); i++) {
+        if (readers[i].done->load()) {
+            readers[i].thread.join();
+        } else {
+            if (kept != i) readers[kept] = std::move(readers[i]);
+            kept++;
+        }
+    }
+    readers.resize(kept);
+}
+
+int main(int argc, char** argv) {
+    std::string path = PETD_SOCKET;
+    unsigned shardCount = std::thread::hardware_concurrency();
+    unsigned tickMs = 100;
+    uint32_t timeScale = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+            shardCount = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            tickMs = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--time-scale") == 0 && i + 1 < argc) {
+            timeScale = (uint32_t)atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (shardCount == 0) shardCount = 1;
+    if (timeScale == 0) timeScale = 1;
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (listener < 0 || path.size() >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "stagotchi_petd: bad socket path %s\n", path.c_str());
+        return 1;
+    }
+    strcpy(addr.sun_path, path.c_str());
+    unlink(path.c_str());
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listener, 64) < 0) {
+        fprintf(stderr, "stagotchi_petd: cannot listen on %s: %s\n", path.c_str(), strerror(errno));
+        return 1;
+    }
+
+    // No SA_RESTART: a signal must get accept() to return
+    struct sigaction sa = {};
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    RealClock real;
+    ScaledClock scaled(real, timeScale);
+    Clock& clock = timeScale > 1 ? (Clock&)scaled : (Clock&)real;
+    clock.nowMs();  // ScaledClock starts on first read; do that before the shards share it
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    for (unsigned s = 0; s < shardCount; s++) {
+        shards.emplace_back(new Shard(s, shardCount, clock, tickMs));
+    }
+    sigset_t quiet, old;
+    sigemptyset(&quiet);
+    sigaddset(&quiet, SIGINT);
+    sigaddset(&quiet, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &quiet, &old);
+    for (auto& s : shards) s->start();
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+    fprintf(stderr, "stagotchi_petd: %u shards on %s, %u ms ticks, time x%u\n", shardCount,
+            path.c_str(), tickMs, timeScale);
+
+    std::atomic<uint32_t> nextShard{0};
+    std::vector<Reader> readers;
+    while (!gStop) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;  // EINTR on shutdown
+        reap(readers);
+        std::shared_ptr<Connection> c = std::make_shared<Connection>(fd);
+        std::shared_ptr<std::atomic<bool>> done = std::make_shared<std::atomic<bool>>(false);
+        Reader r;
+        r.conn = c;
+        r.done = done;
+        r.thread = quietThread([c, done, &shards, &nextShard] {
+            serve(c, shards, nextShard);
+            done->store(true);
+        });
+        readers.push_back(std::move(r));
+    }
+
+    fprintf(stderr, "stagotchi_petd: shutting down\n");
+    close(listener);
+    unlink(path.c_str());
+    for (auto& r : readers) {
+        if (std::shared_ptr<Connection> c = r.conn.lock()) shutdown(c->fd(), SHUT_RDWR);  // wakes it
+    }
+    for (auto& r : readers) r.thread.join();
+    for (auto& s : shards) s->stop();
+    return 0;
+}
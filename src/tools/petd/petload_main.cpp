@@ -0,0 +1,266 @@
+// =============================================
+//  Load generator for the pet daemon (petload env, Linux)
+//  Grows the hosted population step by step and, at each size, keeps a
+//  fixed number of random actions in flight per connection. Reports
+//  action latency percentiles and the daemon's pet ticks per second.
+// =============================================
+
+#include "protocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using SteadyClock = std::chrono::steady_clock;
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--socket PATH] [--pets N,N,...] [--seconds S]\n"
+            "          [--connections C] [--inflight K] [--seed S]\n"
+            "  defaults: 1000,10000,100000 pets, 5 s each, 4 connections x 64 in flight\n",
+            argv0);
+}
+
+// Queries and the player actions, roughly as often as people use them
+static const WireOp ACTION_MIX[] = {
+    WireOp::QUERY, WireOp::QUERY, WireOp::QUERY, WireOp::QUERY,
+    WireOp::FEED_MEAL, WireOp::FEED_SNACK, WireOp::CLEAN, WireOp::MEDICINE,
+    WireOp::DISCIPLINE, WireOp::LIGHT, WireOp::GAME_WIN, WireOp::GAME_LOSE,
+};
+
+static int connectTo(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool sendAll(int fd, const uint8_t* p, size_t n) {
+    while (n > 0) {
+        ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+static uint32_t xorshift(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+// Keeps `inflight` requests outstanding on one connection until the
+// deadline. Tags are slots in the window, so a response tells which
+// send time to measure from.
+class Client {
+public:
+    Client(int fd, uint32_t seed) : _fd(fd), _rng(seed | 1) {}
+
+    // Sends make() for count requests with at most inflight outstanding;
+    // returns the responses in order of arrival (or empty on error)
+    template <typename Make>
+    std::vector<WireResponse> pipeline(uint32_t count, uint32_t inflight, Make make,
+                                       SteadyClock::time_point deadline = SteadyClock::time_point::max());
+
+    std::vector<uint32_t>& latenciesUs() { return _latUs; }
+    uint32_t& rng() { return _rng; }
+
+private:
+    int      _fd;
+    uint32_t _rng;
+    std::vector<uint32_t> _latUs;
+};
+
+template <typename Make>
+std::vector<WireResponse> Client::pipeline(uint32_t count, uint32_t inflight, Make make,
+                                           SteadyClock::time_point deadline) {
+    std::vector<WireResponse> got;
+    std::vector<SteadyClock::time_point> sentAt(inflight);
+    std::vector<uint8_t> out, in(64 * 1024);
+    size_t have = 0;
+    uint32_t sent = 0, outstanding = 0;
+    bool stopSending = false;
+
+    auto queue = [&](uint32_t slot) {
+        WireRequest r = make(sent);
+        r.tag = slot;
+        out.resize(out.size() + REQUEST_SIZE);
+        encodeRequest(r, out.data() + out.size() - REQUEST_SIZE);
+        sentAt[slot] = SteadyClock::now();
+        sent++;
+        outstanding++;
+    };
+    for (uint32_t slot = 0; slot < inflight && sent < count; slot++) queue(slot);
+
+    while (outstanding > 0) {
+        if (!out.empty()) {
+            if (!sendAll(_fd, out.data(), out.size())) return {};
+            out.clear();
+        }
+        ssize_t n = recv(_fd, in.data() + have, in.size() - have, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return {};
+        have += (size_t)n;
+        auto now = SteadyClock::now();
+        if (now >= deadline) stopSending = true;
+
+        size_t used = 0;
+        for (; have - used >= RESPONSE_SIZE; used += RESPONSE_SIZE) {
+            WireResponse r = decodeResponse(in.data() + used);
+            got.push_back(r);
+            outstanding--;
+            if (r.tag < inflight) {
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - sentAt[r.tag]);
+                _latUs.push_back((uint32_t)us.count());
+                if (!stopSending && sent < count) queue(r.tag);
+            }
+        }
+        memmove(in.data(), in.data() + used, have - used);
+        have -= used;
+    }
+    return got;
+}
+
+static bool queryStats(int fd, DaemonStats& s) {
+    Client c(fd, 1);
+    auto r = c.pipeline(1, 1, [](uint32_t) {
+        WireRequest q;
+        q.op = WireOp::STATS;
+        return q;
+    });
+    if (r.size() != 1) return false;
+    s = r[0].stats;
+    return true;
+}
+
+static uint32_t percentile(std::vector<uint32_t>& v, double q) {
+    if (v.empty()) return 0;
+    size_t k = std::min(v.size() - 1, (size_t)(q * v.size()));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+int main(int argc, char** argv) {
+    std::string path = PETD_SOCKET;
+    std::vector<uint32_t> steps = {1000, 10000, 100000};
+    double seconds = 5;
+    unsigned connections = 4;
+    uint32_t inflight = 64;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--pets") == 0 && i + 1 < argc) {
+            steps.clear();
+            for (char* p = argv[++i]; *p;) {
+                steps.push_back((uint32_t)strtoul(p, &p, 10));
+                if (*p == ',') p++;
+                else if (*p) break;
+            }
+            std::sort(steps.begin(), steps.end());
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            connections = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--inflight") == 0 && i + 1 < argc) {
+            inflight = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (steps.empty() || connections == 0 || inflight == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<int> fds;
+    for (unsigned c = 0; c < connections; c++) {
+        int fd = connectTo(path);
+        if (fd < 0) {
+            fprintf(stderr, "stagotchi_petload: cannot connect to %s: %s\n", path.c_str(), strerror(errno));
+            return 1;
+        }
+        fds.push_back(fd);
+    }
+
+    printf("%8s %12s %9s %9s %14s %11s\n", "pets", "actions/s", "p50 us", "p99 us", "pet ticks/s", "shard load");
+    std::vector<uint32_t> pets;
+    for (uint32_t target : steps) {
+        // Grow the population to this step
+        if (target > pets.size()) {
+            Client c(fds[0], seed);
+            uint32_t base = (uint32_t)pets.size();
+            auto made = c.pipeline(target - base, 256, [&](uint32_t k) {
+                WireRequest r;
+                r.op = WireOp::CREATE;
+                r.pet = seed * 0x9E3779B9u + base + k;
+                return r;
+            });
+            for (const auto& r : made) pets.push_back(r.pet);
+            if (pets.size() != target) {
+                fprintf(stderr, "stagotchi_petload: lost the daemon while creating pets\n");
+                return 1;
+            }
+        }
+
+        DaemonStats before, after;
+        if (!queryStats(fds[0], before)) return 1;
+        auto t0 = SteadyClock::now();
+        auto deadline = t0 + std::chrono::duration_cast<SteadyClock::duration>(
+                                 std::chrono::duration<double>(seconds));
+        std::vector<Client> clients;
+        for (unsigned c = 0; c < connections; c++) clients.emplace_back(fds[c], seed * 7919u + c + target);
+        std::vector<std::thread> threads;
+        std::vector<size_t> done(connections);
+        for (unsigned c = 0; c < connections; c++) {
+            threads.emplace_back([&, c] {
+                Client& cl = clients[c];
+                auto got = cl.pipeline(UINT32_MAX, inflight, [&](uint32_t) {
+                    WireRequest r;
+                    uint32_t x = xorshift(cl.rng());
+                    r.op = ACTION_MIX[x % (sizeof(ACTION_MIX) / sizeof(ACTION_MIX[0]))];
+                    r.pet = pets[(x >> 8) % pets.size()];
+                    return r;
+                }, deadline);
+                done[c] = got.size();
+            });
+        }
+        for (auto& t : threads) t.join();
+        double secs = std::chrono::duration<double>(SteadyClock::now() - t0).count();
+        if (!queryStats(fds[0], after)) return 1;
+
+        std::vector<uint32_t> lat;
+        size_t actions = 0;
+        for (unsigned c = 0; c < connections; c++) {
+            actions += done[c];
+            lat.insert(lat.end(), clients[c].latenciesUs().begin(), clients[c].latenciesUs().end());
+        }
+        double ticks = (double)(after.petTicks - before.petTicks) / secs;
+        double load = (double)(after.busyUs - before.busyUs) / (secs * 1e6);
+        printf("%8u %12.0f %9u %9u %14.0f %10.2fx\n", target, actions / secs,
+               percentile(lat, 0.50), percentile(lat, 0.99), ticks, load);
+        fflush(stdout);
+    }
+    for (int fd : fds) close(fd);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Wire format of the pet daemon's Unix socket. Everything is fixed size
+// and little-endian. A client may pipeline as many requests as it likes;
+// each gets exactly one response carrying its tag. Responses for pets on
+// different shards can overtake each other.
+constexpr const char* PETD_SOCKET = "/tmp/stagotchi.sock";
+
+enum class WireOp : uint8_t {
+    CREATE = 0,  // new egg, pet field is the seed; answers with the new id
+    QUERY,
+    FEED_MEAL,
+    FEED_SNACK,
+    CLEAN,
+    MEDICINE,
+    DISCIPLINE,
+    LIGHT,
+    GAME_WIN,    // a finished minigame, as the device reports it
+    GAME_LOSE,
+    STATS,       // daemon counters instead of a pet
+    COUNT
+};
+
+enum class WireStatus : uint8_t {
+    OK = 0,
+    REFUSED,  // the pet would not (asleep, full, nothing to clean, ...)
+    NO_PET,
+    BAD_OP,
+};
+
+// op u8, tag u32, pet u32
+struct WireRequest {
+    WireOp   op  = WireOp::QUERY;
+    uint32_t tag = 0;
+    uint32_t pet = 0;
+};
+constexpr size_t REQUEST_SIZE = 9;
+
+// The pet afterwards, as the status screen shows it
+struct PetSnapshot {
+    enum : uint8_t { SICK = 1, ASLEEP = 2, LIGHT_OFF = 4, EVOLVING = 8, DEAD = 16 };
+    uint8_t  character = 0, stage = 0;
+    uint8_t  hunger = 0, happiness = 0, discipline = 0, weight = 0;
+    uint8_t  poop = 0, attention = 0, careMistakes = 0, flags = 0;
+    uint16_t age = 0;
+};
+
+// Counters summed over all shards (STATS)
+struct DaemonStats {
+    uint32_t pets = 0;
+    uint64_t petTicks = 0;  // pets stepped, summed over ticks
+    uint64_t busyUs = 0;    // shard time spent ticking and answering
+};
+
+// tag u32, status u8, op u8, pet u32, then 14 bytes: PetSnapshot (12) for
+// pet ops or petTicks u64 + busyUs u48 for STATS (pets in the pet field)
+struct WireResponse {
+    uint32_t    tag = 0;
+    WireStatus  status = WireStatus::OK;
+    WireOp      op = WireOp::QUERY;
+    uint32_t    pet = 0;
+    PetSnapshot state;
+    DaemonStats stats;
+};
+constexpr size_t RESPONSE_SIZE = 24;
+
+inline void wirePut16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+inline void wirePut32(uint8_t* p, uint32_t v) { wirePut16(p, v); wirePut16(p + 2, v >> 16); }
+inline uint16_t wireGet16(const uint8_t* p) { return p[0] | (uint16_t)(p[1] << 8); }
+inline uint32_t wireGet32(const uint8_t* p) { return wireGet16(p) | ((uint32_t)wireGet16(p + 2) << 16); }
+
+inline void encodeRequest(const WireRequest& r, uint8_t* p) {
+    p[0] = static_cast<uint8_t>(r.op);
+    wirePut32(p + 1, r.tag);
+    wirePut32(p + 5, r.pet);
+}
+
+inline WireRequest decodeRequest(const uint8_t* p) {
+    WireRequest r;
+    r.op  = static_cast<WireOp>(p[0]);
+    r.tag = wireGet32(p + 1);
+    r.pet = wireGet32(p + 5);
+    return r;
+}
+
+inline void encodeResponse(const WireResponse& r, uint8_t* p) {
+    wirePut32(p, r.tag);
+    p[4] = static_cast<uint8_t>(r.status);
+    p[5] = static_cast<uint8_t>(r.op);
+    wirePut32(p + 6, r.op == WireOp::STATS ? r.stats.pets : r.pet);
+    uint8_t* q = p + 10;
+    if (r.op == WireOp::STATS) {
+        wirePut32(q, (uint32_t)r.stats.petTicks);
+        wirePut32(q + 4, (uint32_t)(r.stats.petTicks >> 32));
+        wirePut32(q + 8, (uint32_t)r.stats.busyUs);
+        wirePut16(q + 12, (uint16_t)(r.stats.busyUs >> 32));
+        return;
+    }
+    const PetSnapshot& s = r.state;
+    const uint8_t bytes[10] = {s.character, s.stage, s.hunger, s.happiness, s.discipline,
+                               s.weight, s.poop, s.attention, s.careMistakes, s.flags};
+    for (int i = 0; i < 10; i++) q[i] = bytes[i];
+    wirePut16(q + 10, s.age);
+    wirePut16(q + 12, 0);
+}
+
+inline WireResponse decodeResponse(const uint8_t* p) {
+    WireResponse r;
+    r.tag    = wireGet32(p);
+    r.status = static_cast<WireStatus>(p[4]);
+    r.op     = static_cast<WireOp>(p[5]);
+    r.pet    = wireGet32(p + 6);
+    const uint8_t* q = p + 10;
+    if (r.op == WireOp::STATS) {
+        r.stats.pets     = r.pet;
+        r.stats.petTicks = wireGet32(q) | ((uint64_t)wireGet32(q + 4) << 32);
+        r.stats.busyUs   = wireGet32(q + 8) | ((uint64_t)wireGet16(q + 12) << 32);
+        return r;
+    }
+    PetSnapshot& s = r.state;
+    s.character = q[0];
+    s.stage = q[1];
+    s.hunger = q[2];
+    s.happiness = q[3];
+    s.discipline = q[4];
+    s.weight = q[5];
+    s.poop = q[6];
+    s.attention = q[7];
+    s.careMistakes = q[8];
+    s.flags = q[9];
+    s.age = wireGet16(q + 10);
+    return r;
+}
+
@@ -0,0 +1,186 @@
+#include "shard.h"
+#include <cerrno>
+#include <chrono>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// ===== Connection =====
+
+Connection::~Connection() {
+    close(_fd);
+}
+
+bool Connection::send(const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> g(_lock);
+    while (size > 0 && !_broken) {
+        ssize_t n = ::send(_fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            _broken = true;
+            break;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return !_broken;
+}
+
+// ===== Shard =====
+
+Shard::Shard(unsigned index, unsigned count, Clock& clock, unsigned tickMs)
+    : _index(index), _count(count), _clock(clock), _tickMs(tickMs) {}
+
+Shard::~Shard() {
+    stop();
+}
+
+void Shard::start() {
+    _running = true;
+    _thread = std::thread(&Shard::run, this);
+}
+
+void Shard::stop() {
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        if (!_running) return;
+        _running = false;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+void Shard::submit(std::vector<PendingRequest>& batch) {
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        wasEmpty = _inbox.empty();
+        if (wasEmpty) {
+            _inbox.swap(batch);
+        } else {
+            for (auto& p : batch) _inbox.push_back(std::move(p));
+        }
+    }
+    batch.clear();
+    if (wasEmpty) _wake.notify_one();
+}
+
+void Shard::addStats(DaemonStats& s) const {
+    s.pets += _pets.load(std::memory_order_relaxed);
+    s.petTicks += _petTicks.load(std::memory_order_relaxed);
+    s.busyUs += _busyUs.load(std::memory_order_relaxed);
+}
+
+void Shard::run() {
+    using SteadyClock = std::chrono::steady_clock;
+    std::vector<PendingRequest> batch;
+    // Responses grouped per client, so a batch costs one write each
+    std::vector<std::pair<Connection*, std::vector<uint8_t>>> out;
+    auto nextTick = SteadyClock::now();
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> g(_lock);
+            _wake.wait_until(g, nextTick, [&] { return !_running || !_inbox.empty(); });
+            if (!_running) return;
+            batch.swap(_inbox);
+        }
+        auto t0 = SteadyClock::now();
+        tick();
+        if (t0 >= nextTick) {
+            nextTick += std::chrono::milliseconds(_tickMs);
+            if (nextTick < t0) nextTick = t0;  // overloaded: don't try to catch up
+        }
+
+        for (const PendingRequest& p : batch) {
+            size_t c = 0;
+            while (c < out.size() && out[c].first != p.from.get()) c++;
+            if (c == out.size()) out.push_back({p.from.get(), {}});
+            std::vector<uint8_t>& buf = out[c].second;
+            buf.resize(buf.size() + RESPONSE_SIZE);
+            encodeResponse(apply(p.req), buf.data() + buf.size() - RESPONSE_SIZE);
+        }
+        for (auto& o : out) o.first->send(o.second.data(), o.second.size());
+        out.clear();
+        batch.clear();  // drops the connection references after the writes
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - t0);
+        _busyUs.fetch_add((uint64_t)us.count(), std::memory_order_relaxed);
+    }
+}
+
+void Shard::tick() {
+    _nowMs = _clock.nowMs();
+    _pool.update((uint32_t)_nowMs, _clock.hour());
+    // Evolve right away, as the device does once the animation is done
+    for (uint32_t i : _pool.touched()) {
+        if (_pool.isEvolving(i)) _pool.withPet(i, [this](PetManager& m) { m.doEvolve(_nowMs); });
+    }
+    _petTicks.fetch_add(_pool.size(), std::memory_order_relaxed);
+}
+
+WireResponse Shard::apply(const WireRequest& r) {
+    WireResponse out;
+    out.tag = r.tag;
+    out.op = r.op;
+    out.pet = r.pet;
+
+    size_t local;
+    if (r.op == WireOp::CREATE) {
+        PetManager egg;
+        egg.initNewEgg(_nowMs, r.pet);
+        local = _pool.add(egg.data());
+        _pets.store((uint32_t)_pool.size(), std::memory_order_relaxed);
+        out.pet = (uint32_t)(local * _count + _index);
+    } else {
+        local = r.pet / _count;
+        if (r.pet % _count != _index || local >= _pool.size()) {
+            out.status = WireStatus::NO_PET;
+            return out;
+        }
+    }
+
+    bool ok = true;
+    _pool.withPet(local, [&](PetManager& m) {
+        switch (r.op) {
+            case WireOp::CREATE:
+            case WireOp::QUERY:      break;
+            case WireOp::FEED_MEAL:  ok = m.feedMeal(); break;
+            case WireOp::FEED_SNACK: ok = m.feedSnack(); break;
+            case WireOp::CLEAN:      ok = m.clean(); break;
+            case WireOp::MEDICINE:   ok = m.giveMedicine(); break;
+            case WireOp::DISCIPLINE: ok = m.discipline(); break;
+            case WireOp::LIGHT:      ok = m.toggleLight(); break;
+            case WireOp::GAME_WIN:
+            case WireOp::GAME_LOSE:
+                ok = m.startGame();
+                if (ok && r.op == WireOp::GAME_WIN) m.onGameWin();
+                if (ok && r.op == WireOp::GAME_LOSE) m.onGameLose();
+                break;
+            default:
+                out.status = WireStatus::BAD_OP;
+                return;
+        }
+        if (!ok) out.status = WireStatus::REFUSED;
+    });
+    if (out.status != WireStatus::BAD_OP) out.state = snapshot(local);
+    return out;
+}
+
+PetSnapshot Shard::snapshot(size_t local) const {
+    PetData d = _pool.get(local);
+    PetSnapshot s;
+    s.character    = static_cast<uint8_t>(d.characterId);
+    s.stage        = static_cast<uint8_t>(d.stage);
+    s.hunger       = d.hunger;
+    s.happiness    = d.happiness;
+    s.discipline   = d.discipline;
+    s.weight       = d.weight;
+    s.poop         = d.poopCount;
+    s.attention    = static_cast<uint8_t>(d.pendingAttention);
+    s.careMistakes = d.careMistakes;
+    s.age          = d.age;
+    s.flags = (d.isSick ? PetSnapshot::SICK : 0) | (d.isAsleep ? PetSnapshot::ASLEEP : 0) |
+              (d.lightOff ? PetSnapshot::LIGHT_OFF : 0) |
+              (d.readyToEvolve ? PetSnapshot::EVOLVING : 0) | (d.isDead ? PetSnapshot::DEAD : 0);
+    return s;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "pet_pool.h"
+#include "protocol.h"
+#include "clock.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One client socket. Any shard may answer on it, so writes are locked.
+class Connection {
+public:
+    explicit Connection(int fd) : _fd(fd) {}
+    ~Connection();
+    int fd() const { return _fd; }
+
+    // Writes all of it; false once the client has gone
+    bool send(const uint8_t* data, size_t size);
+
+private:
+    int        _fd;
+    std::mutex _lock;
+    bool       _broken = false;
+};
+
+struct PendingRequest {
+    WireRequest                 req;
+    std::shared_ptr<Connection> from;
+};
+
+// A slice of the hosted pets with its own thread and PetPool. Pet ids
+// interleave the shards: id = local index * shard count + shard index.
+//
+// The thread sleeps until the next tick or until requests arrive. Each
+// wake-up steps the pool to the current game time first, then answers
+// everything queued since the last one as a batch, one write per client.
+class Shard {
+public:
+    Shard(unsigned index, unsigned count, Clock& clock, unsigned tickMs);
+    ~Shard();
+
+    void start();
+    void stop();
+
+    // Takes the whole batch with one lock and one wake-up
+    void submit(std::vector<PendingRequest>& batch);
+
+    // Adds this shard's counters
+    void addStats(DaemonStats& s) const;
+
+private:
+    const unsigned _index, _count;
+    Clock&         _clock;
+    const unsigned _tickMs;
+
+    PetPool       _pool;  // touched by the shard thread only
+    unsigned long _nowMs = 0;
+
+    std::mutex                  _lock;
+    std::condition_variable     _wake;
+    std::vector<PendingRequest> _inbox;
+    bool                        _running = false;
+    std::thread                 _thread;
+
+    std::atomic<uint32_t> _pets{0};
+    std::atomic<uint64_t> _petTicks{0};
+    std::atomic<uint64_t> _busyUs{0};
+
+    void run();
+    void tick();
+    WireResponse apply(const WireRequest& r);
+    PetSnapshot snapshot(size_t local) const;
+};
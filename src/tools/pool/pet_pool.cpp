@@ -0,0 +1,232 @@
+#include "pet_pool.h"
+#include "config.h"
+#include <cstring>
+
+// The helpers below never cross a translation unit, so the vector
+// calling convention they would use without AVX does not matter
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace {
+
+// One vector of LANES pets. GCC/Clang vector extensions: SSE/NEON on the
+// host, wider with -march=native.
+typedef uint32_t u32v __attribute__((vector_size(PetPool::LANES * 4)));
+typedef int32_t  i32v __attribute__((vector_size(PetPool::LANES * 4)));
+typedef uint8_t  u8v  __attribute__((vector_size(PetPool::LANES)));
+
+u32v load(const uint32_t* p) {
+    u32v v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void store(uint32_t* p, u32v v) { memcpy(p, &v, sizeof(v)); }
+
+u32v widen(const uint8_t* p) {
+    u8v v;
+    memcpy(&v, p, sizeof(v));
+    return __builtin_convertvector(v, u32v);
+}
+
+void narrow(uint8_t* p, u32v v) {
+    u8v n = __builtin_convertvector(v, u8v);
+    memcpy(p, &n, sizeof(n));
+}
+
+// Wrap-safe "has nowMs reached due" per lane
+i32v reached(u32v now, u32v due) { return (i32v)(now - due) >= 0; }
+
+bool anyLane(i32v m) {
+    int32_t r = 0;
+    for (unsigned j = 0; j < PetPool::LANES; j++) r |= m[j];
+    return r != 0;
+}
+
+// Vector form of pet.cpp's carry(): the next due time after a timer
+// fired, keeping the schedule unless a whole interval was missed
+u32v carryDue(u32v due, u32v interval, u32v now) {
+    return (now - due < interval) ? due + interval : now + interval;
+}
+
+// Earlier of two due times per lane (wrap-safe)
+u32v earlier(u32v a, u32v b) { return (i32v)(a - b) < 0 ? a : b; }
+
+// nextDue for a lane with nothing armed: not due for 24 days, and then
+// only a harmless trip through PetManager::update()
+constexpr uint32_t IDLE_MS = 0x7FFFFFFF;
+
+// Everything that runs in the PetManager rather than the kernel
+const PetEvent SLOW_EVENTS[] = {
+    PetEvent::AGE, PetEvent::SICKNESS, PetEvent::DISCIPLINE,
+    PetEvent::CARE_WINDOW, PetEvent::EVOLUTION, PetEvent::DEATH,
+};
+
+}  // namespace
+
+PetPool::PetPool(const GameRules* rules) : _rules(rules ? rules : &defaultRules()) {}
+
+void PetPool::grow() {
+    size_t n = _hunger.size() + LANES;
+    _nextDue.resize(n, _nowMs + IDLE_MS);
+    _hunger.resize(n, 0);
+    _happy.resize(n, 0);
+    _poop.resize(n, 0);
+    _flags.resize(n, DEAD);  // padding lanes never do anything
+    _lastHour.resize(n, 0xFF);
+    _hungerDue.resize(n, 0);
+    _happyDue.resize(n, 0);
+    _poopDue.resize(n, 0);
+    _hungerInt.resize(n, 0);
+    _happyInt.resize(n, 0);
+    _poopInt.resize(n, 0);
+    _slowDue.resize(n, 0);
+}
+
+size_t PetPool::add(const PetData& d) {
+    if (_count == _hunger.size()) grow();
+    _cold.emplace_back();
+    _cold.back().setRules(_rules);
+    set(_count, d);
+    return _count++;
+}
+
+void PetPool::set(size_t i, const PetData& d) {
+    _cold[i].loadFromSave(d);
+    pullHot(i);
+}
+
+PetData PetPool::get(size_t i) const {
+    PetData d = _cold[i].data();
+    d.hunger    = _hunger[i];
+    d.happiness = _happy[i];
+    d.poopCount = _poop[i];
+    if (_flags[i] & DECAYING) {
+        d.lastHungerDecayMs = _hungerDue[i] - _hungerInt[i];
+        d.lastHappyDecayMs  = _happyDue[i] - _happyInt[i];
+        d.lastPoopMs        = _poopDue[i] - _poopInt[i];
+    }
+    return d;
+}
+
+void PetPool::pushHot(size_t i) {
+    PetManager& m = _cold[i];
+    m.data() = get(i);
+    m.reschedule();
+}
+
+void PetPool::pullHot(size_t i) {
+    const PetManager& m = _cold[i];
+    const PetData& d = m.data();
+    _hunger[i] = d.hunger;
+    _happy[i]  = d.happiness;
+    _poop[i]   = d.poopCount;
+    _lastHour[i] = m.lastHour();
+
+    uint8_t flags = 0;
+    unsigned long hunger, happy, poop;
+    // The three are armed together (hatched and awake)
+    if (m.dueTime(PetEvent::HUNGER, hunger) && m.dueTime(PetEvent::HAPPINESS, happy) &&
+        m.dueTime(PetEvent::POOP, poop)) {
+        flags |= DECAYING;
+        _hungerDue[i] = hunger;
+        _happyDue[i]  = happy;
+        _poopDue[i]   = poop;
+        _hungerInt[i] = hunger - d.lastHungerDecayMs;
+        _happyInt[i]  = happy - d.lastHappyDecayMs;
+        _poopInt[i]   = poop - d.lastPoopMs;
+    }
+    for (PetEvent ev : SLOW_EVENTS) {
+        unsigned long due;
+        if (!m.dueTime(ev, due)) continue;
+        if (!(flags & SLOW) || (int32_t)((uint32_t)due - _slowDue[i]) < 0) _slowDue[i] = due;
+        flags |= SLOW;
+    }
+    if (d.readyToEvolve) flags |= EVOLVING;
+    if (d.isDead) flags |= DEAD;
+    _flags[i] = flags;
+
+    uint32_t next = _nowMs + IDLE_MS;
+    auto consider = [&](uint32_t due) {
+        if ((int32_t)(due - next) < 0) next = due;
+    };
+    if (flags & DECAYING) {
+        consider(_hungerDue[i]);
+        consider(_happyDue[i]);
+        consider(_poopDue[i]);
+    }
+    if (flags & SLOW) consider(_slowDue[i]);
+    // Bedtime changed (evolved, reloaded): re-checked on the next update,
+    // as PetManager does
+    if (!d.isDead && _lastHour[i] != _hour) next = _nowMs;
+    _nextDue[i] = next;
+}
+
+size_t PetPool::update(uint32_t nowMs, uint8_t currentHour) {
+    _touched.clear();
+    const bool newHour = currentHour != _hour;
+    _nowMs = nowMs;
+    _hour = currentHour;
+    const u32v now  = (u32v){} + nowMs;
+    const u32v hour = (u32v){} + (uint32_t)currentHour;
+    const u32v idle = now + IDLE_MS;
+
+    for (size_t b = 0; b < _count; b += LANES) {
+        if (!newHour && !anyLane(reached(now, load(&_nextDue[b])))) continue;
+
+        u32v flags = widen(&_flags[b]);
+        i32v live     = (flags & (uint32_t)DEAD) == 0;
+        i32v decaying = (flags & (uint32_t)DECAYING) != 0;
+        i32v slow     = (flags & (uint32_t)SLOW) != 0;
+        u32v hungerDue = load(&_hungerDue[b]);
+        u32v happyDue  = load(&_happyDue[b]);
+        u32v poopDue   = load(&_poopDue[b]);
+        u32v slowDue   = load(&_slowDue[b]);
+
+        i32v hungerHit = decaying & reached(now, hungerDue);
+        i32v happyHit  = decaying & reached(now, happyDue);
+        i32v poopHit   = decaying & reached(now, poopDue);
+        i32v slowHit   = live & ((slow & reached(now, slowDue)) | (widen(&_lastHour[b]) != hour));
+        if (!anyLane(hungerHit | happyHit | poopHit | slowHit)) continue;
+
+        // A need reaching 0 or the third poop changes what else is armed,
+        // and the first poop starts its care timing, so those lanes take
+        // the PetManager path with everything else
+        u32v hunger = widen(&_hunger[b]);
+        u32v happy  = widen(&_happy[b]);
+        u32v poop   = widen(&_poop[b]);
+        i32v scalar = slowHit | (hungerHit & (hunger < 2)) | (happyHit & (happy < 2)) |
+                      (poopHit & ((poop == 0) | (poop == 2)));
+        hungerHit &= ~scalar;
+        happyHit  &= ~scalar;
+        poopHit   &= ~scalar;
+
+        hunger -= (u32v)hungerHit & 1;
+        happy  -= (u32v)happyHit & 1;
+        poop   += (u32v)(poopHit & (poop < MAX_POOP)) & 1;
+        hungerDue = hungerHit ? carryDue(hungerDue, load(&_hungerInt[b]), now) : hungerDue;
+        happyDue  = happyHit ? carryDue(happyDue, load(&_happyInt[b]), now) : happyDue;
+        poopDue   = poopHit ? carryDue(poopDue, load(&_poopInt[b]), now) : poopDue;
+        narrow(&_hunger[b], hunger);
+        narrow(&_happy[b], happy);
+        narrow(&_poop[b], poop);
+        store(&_hungerDue[b], hungerDue);
+        store(&_happyDue[b], happyDue);
+        store(&_poopDue[b], poopDue);
+
+        u32v next = decaying ? earlier(hungerDue, earlier(happyDue, poopDue)) : idle;
+        next = slow ? earlier(next, slowDue) : next;
+        store(&_nextDue[b], next);
+
+        // Scalar lanes redo their own nextDue in pullHot()
+        if (!anyLane(scalar)) continue;
+        for (unsigned j = 0; j < LANES; j++) {
+            if (!scalar[j]) continue;
+            size_t i = b + j;
+            pushHot(i);
+            _cold[i].update(nowMs, currentHour);
+            pullHot(i);
+            _touched.push_back((uint32_t)i);
+        }
+    }
+    return _touched.size();
+}
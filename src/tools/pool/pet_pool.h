@@ -0,0 +1,83 @@
+#pragma once
+#include "pet.h"
+#include <cstdint>
+#include <vector>
+
+// Many pets in structure-of-arrays form for hosting them in bulk.
+//
+// The fields touched every frame (need levels, decay/poop due times and
+// intervals, the earliest other due time, the hour last seen) live in
+// their own arrays, LANES pets per vector. Everything else stays in a
+// cold PetManager per pet, which remains the only implementation of the
+// rules. update() compares whole vectors of pets at once and applies the
+// common case (a need or the poop count ticking without crossing a
+// threshold) with vector selects; a pet with anything else due (a need
+// reaching 0, the third poop, care window, age tick, evolution, death,
+// an hour change) is handed to its PetManager for that frame.
+//
+// Pets stepped by update() end up exactly where PetManager::update()
+// would have put them. Times are millis()-style uint32 and wrap safely.
+class PetPool {
+public:
+    static constexpr unsigned LANES = 4;
+
+    // Timing to live by; must outlive the pool (default: config.h)
+    explicit PetPool(const GameRules* rules = nullptr);
+
+    size_t size() const { return _count; }
+
+    // Round trip to PetData; add() returns the new pet's index
+    size_t add(const PetData& d);
+    PetData get(size_t i) const;
+    void set(size_t i, const PetData& d);
+
+    // Advances every pet to nowMs, as PetManager::update() on each.
+    // Returns how many pets went through their PetManager.
+    size_t update(uint32_t nowMs, uint8_t currentHour);
+
+    // Pets that went through their PetManager in the last update(); only
+    // these can have started evolving, died or called for attention
+    const std::vector<uint32_t>& touched() const { return _touched; }
+
+    bool isEvolving(size_t i) const { return _flags[i] & EVOLVING; }
+    bool isDead(size_t i) const { return _flags[i] & DEAD; }
+
+    // Player actions and evolution: runs fn(PetManager&) on pet i with its
+    // state brought up to date, then takes the result back into the pool
+    template <typename Fn>
+    void withPet(size_t i, Fn fn) {
+        pushHot(i);
+        fn(_cold[i]);
+        pullHot(i);
+    }
+
+private:
+    enum : uint8_t {
+        DECAYING = 1 << 0,  // hunger/happiness/poop timers armed
+        SLOW     = 1 << 1,  // slowDue is valid
+        EVOLVING = 1 << 2,
+        DEAD     = 1 << 3,
+    };
+
+    const GameRules* _rules;
+    size_t _count = 0;
+
+    // Hot, padded to a whole number of LANES. nextDue is the earliest of
+    // the others, so a frame with nothing due costs one compare per vector.
+    std::vector<uint32_t> _nextDue;
+    std::vector<uint8_t>  _hunger, _happy, _poop, _flags, _lastHour;
+    std::vector<uint32_t> _hungerDue, _happyDue, _poopDue;
+    std::vector<uint32_t> _hungerInt, _happyInt, _poopInt;
+    std::vector<uint32_t> _slowDue;
+    uint32_t _nowMs = 0;     // time of the last update()
+    uint8_t  _hour  = 0xFF;  // hour of the last update()
+
+    // Cold: the rest of each pet; hot fields in here are stale
+    std::vector<PetManager> _cold;
+
+    std::vector<uint32_t> _touched;
+
+    void pushHot(size_t i);  // hot -> PetManager, rescheduled
+    void pullHot(size_t i);  // PetManager -> hot
+    void grow();
+};
@@ -0,0 +1,149 @@
+// =============================================
+//  PetPool benchmark (pool env)
+//  Steps the same pets through PetPool::update and through one
+//  PetManager::update per pet, reports pets updated per second for
+//  each and checks that both end in the same state.
+// =============================================
+
+#include "pet_pool.h"
+#include "config.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--pets N] [--hours H] [--step-ms MS] [--seed S]\n"
+            "  defaults: 4096 pets, 48 game hours in 1000 ms frames\n",
+            argv0);
+}
+
+static uint32_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return (uint32_t)(x ^ (x >> 31));
+}
+
+// Hourly check-in for three pets in four, so some still sicken and die
+static void care(PetManager& m) {
+    const PetData& d = m.data();
+    if (d.isDead) return;
+    while (d.isSick && m.giveMedicine()) {}
+    m.clean();
+    while (d.hunger < MAX_HUNGER && m.feedMeal()) {}
+    m.discipline();
+    while (d.happiness < MAX_HAPPY && m.startGame()) m.onGameWin();
+    if (d.isAsleep && !d.lightOff) m.toggleLight();
+}
+
+static bool sameCare(const CareStats& a, const CareStats& b) {
+    for (uint8_t k = 0; k < CARE_KINDS; k++) {
+        const CareKindStats& x = a.kind[k];
+        const CareKindStats& y = b.kind[k];
+        if (x.ewmaMs != y.ewmaMs || x.answered != y.answered || x.missed != y.missed ||
+            x.recent != y.recent || x.recentCount != y.recentCount ||
+            memcmp(x.hist, y.hist, sizeof(x.hist)) != 0)
+            return false;
+    }
+    return a.timing == b.timing;
+}
+
+static bool samePet(const PetData& a, const PetData& b) {
+    return a.characterId == b.characterId && a.stage == b.stage && a.hunger == b.hunger &&
+           a.happiness == b.happiness && a.discipline == b.discipline && a.weight == b.weight &&
+           a.age == b.age && a.poopCount == b.poopCount && a.isSick == b.isSick &&
+           a.sicknessLevel == b.sicknessLevel && a.medicineGiven == b.medicineGiven &&
+           a.isAsleep == b.isAsleep && a.lightOff == b.lightOff &&
+           a.careMistakes == b.careMistakes && a.disciplineCalls == b.disciplineCalls &&
+           a.totalCareMistakes == b.totalCareMistakes && a.totalAge == b.totalAge &&
+           a.pendingAttention == b.pendingAttention && a.attentionStartMs == b.attentionStartMs &&
+           a.lastHungerDecayMs == b.lastHungerDecayMs && a.lastHappyDecayMs == b.lastHappyDecayMs &&
+           a.lastPoopMs == b.lastPoopMs && a.lastAgeTickMs == b.lastAgeTickMs &&
+           a.lastSickCheckMs == b.lastSickCheckMs && a.lastDisciplineMs == b.lastDisciplineMs &&
+           a.stageStartMs == b.stageStartMs && a.readyToEvolve == b.readyToEvolve &&
+           a.isDead == b.isDead && a.deathCause == b.deathCause &&
+           a.lastForm == b.lastForm && a.diedMs == b.diedMs && a.poopSinceMs == b.poopSinceMs &&
+           sameCare(a.care, b.care) && memcmp(a.rng.s, b.rng.s, sizeof(a.rng.s)) == 0;
+}
+
+int main(int argc, char** argv) {
+    size_t pets = 4096;
+    uint32_t hours = 48;
+    uint32_t stepMs = 1000;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pets") == 0 && i + 1 < argc) {
+            pets = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+            hours = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--step-ms") == 0 && i + 1 < argc) {
+            stepMs = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (pets == 0 || stepMs == 0 || hours == 0 || hours > 24 * 45) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Eggs laid over the day before the run, so events don't line up
+    const uint32_t startMs = 86400000UL;
+    std::vector<PetManager> managers(pets);
+    PetPool pool;
+    for (size_t i = 0; i < pets; i++) {
+        managers[i].initNewEgg(startMs - mix(seed * 0x10001 + i) % 86400000UL, mix(seed + i));
+        pool.add(managers[i].data());
+    }
+
+    using Clock = std::chrono::steady_clock;
+    double poolSecs = 0, loopSecs = 0;
+    uint64_t scalar = 0;
+    const uint32_t endMs = startMs + hours * 3600000UL;
+    uint32_t nextCare = startMs;
+    for (uint32_t t = startMs; t < endMs; t += stepMs) {
+        uint8_t hour = (uint8_t)((8 + t / 3600000UL) % 24);
+
+        auto t0 = Clock::now();
+        for (auto& m : managers) {
+            m.update(t, hour);
+            if (m.isEvolving()) m.doEvolve(t);
+        }
+        auto t1 = Clock::now();
+        scalar += pool.update(t, hour);
+        for (uint32_t i : pool.touched()) {
+            if (pool.isEvolving(i)) pool.withPet(i, [t](PetManager& m) { m.doEvolve(t); });
+        }
+        auto t2 = Clock::now();
+        loopSecs += std::chrono::duration<double>(t1 - t0).count();
+        poolSecs += std::chrono::duration<double>(t2 - t1).count();
+
+        if (t >= nextCare) {
+            nextCare += 3600000UL;
+            for (size_t i = 0; i < pets; i++) {
+                if (mix(t ^ (i << 32)) % 4 == 0) continue;
+                care(managers[i]);
+                pool.withPet(i, care);
+            }
+        }
+    }
+
+    size_t mismatches = 0, dead = 0;
+    for (size_t i = 0; i < pets; i++) {
+        if (!samePet(pool.get(i), managers[i].data())) mismatches++;
+        if (managers[i].data().isDead) dead++;
+    }
+    double updates = (double)pets * ((endMs - startMs + stepMs - 1) / stepMs);
+    printf("%zu pets, %u h in %u ms frames (%zu dead by the end)\n", pets, hours, stepMs, dead);
+    printf("  PetManager loop  %8.1f M pets/s\n", updates / loopSecs / 1e6);
+    printf("  PetPool          %8.1f M pets/s  (x%.1f, %.3f%% through PetManager)\n",
+           updates / poolSecs / 1e6, loopSecs / poolSecs, 100.0 * scalar / updates);
+    printf("  final state: %s\n", mismatches ? "MISMATCH" : "identical");
+    if (mismatches) printf("  %zu pets differ\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+#include "care_policy.h"
+#include "lifecycle.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// ===== Player actions =====
+
+void CareSession::tendAll(uint8_t attendPct, bool guessWell) {
+    auto attend = [&] { return attendPct >= 100 || _rng.below(100) < attendPct; };
+    if (_pet.data().isDead) return;
+    // Discipline first: a pending call blocks meals and games
+    if (attend()) scold();
+    if (attend()) heal();
+    if (attend()) clean();
+    if (attend()) feed();
+    if (attend()) cheerUp(guessWell);
+    if (attend()) lightsOut();
+}
+
+void CareSession::scold() {
+    if (_pet.data().pendingAttention == AttentionType::DISCIPLINE) _pet.discipline();
+}
+
+void CareSession::heal() {
+    while (_pet.data().isSick && _pet.giveMedicine()) {}
+}
+
+void CareSession::clean() {
+    _pet.clean();
+}
+
+void CareSession::feed() {
+    while (_pet.data().hunger < MAX_HUNGER && _pet.feedMeal()) {}
+}
+
+void CareSession::cheerUp(bool guessWell) {
+    for (int tries = 0; tries < 6 && _pet.data().happiness < MAX_HAPPY; tries++) {
+        if (!playGame(guessWell)) break;
+    }
+    // Out of patience for games: a snack always works
+    while (_pet.data().happiness < MAX_HAPPY && _pet.feedSnack()) {}
+}
+
+void CareSession::lightsOut() {
+    if (_pet.data().isAsleep && !_pet.data().lightOff) _pet.toggleLight();
+}
+
+bool CareSession::playGame(bool guessWell) {
+    if (!_pet.startGame()) return false;
+    _game.start(_pet.nextRandom());
+    unsigned long t = _clock.nowMs();
+    while (!_game.isFinished()) {
+        uint8_t n = _game.currentNumber();
+        bool higher = (guessWell && n != 5) ? n < 5 : _rng.below(2) == 0;
+        if (higher) {
+            _game.guessHigher();
+        } else {
+            _game.guessLower();
+        }
+        t += 1300;  // past the result display
+        _game.update(t);
+    }
+    if (_game.isWin()) {
+        _pet.onGameWin();
+    } else {
+        _pet.onGameLose();
+    }
+    return true;
+}
+
+// ===== Schedules =====
+
+namespace {
+
+uint8_t hourOf(uint32_t wallSec) { return (wallSec / 3600UL) % 24; }
+
+// Earliest of several daily times (minutes after midnight) strictly after
+// wallSec, pushed back by up to jitterSec. Slots must be further apart
+// than the jitter so a late check never lands before its own slot.
+uint32_t nextDaily(uint32_t wallSec, const std::vector<uint16_t>& minutes,
+                   uint32_t jitterSec, Rng& rng) {
+    uint32_t midnight = wallSec - wallSec % 86400UL;
+    uint32_t best = UINT32_MAX;
+    for (uint16_t m : minutes) {
+        uint32_t t = midnight + m * 60UL;
+        if (t <= wallSec) t += 86400UL;
+        best = std::min(best, t);
+    }
+    if (best == UINT32_MAX) return best;
+    return best + (jitterSec ? rng.below(jitterSec) : 0);
+}
+
+// Exponential gap with the given mean, at least one second
+uint32_t expGap(uint32_t meanSec, Rng& rng) {
+    double u = (rng.next() + 0.5) / 4294967296.0;
+    return (uint32_t)(-std::log(u) * meanSec) + 1;
+}
+
+// Looks in every ten minutes, day and night
+class PerfectPolicy : public CarePolicy {
+public:
+    const char* name() const override { return "perfect"; }
+    uint32_t nextCheck(uint32_t wallSec, Rng&) const override { return wallSec + 600; }
+};
+
+// Four glances a day around meals and bedtime, each up to an hour late
+class LazyPolicy : public CarePolicy {
+public:
+    const char* name() const override { return "lazy"; }
+    uint32_t nextCheck(uint32_t wallSec, Rng& rng) const override {
+        static const std::vector<uint16_t> SLOTS = {7 * 60 + 30, 12 * 60, 18 * 60 + 30, 22 * 60 + 30};
+        return nextDaily(wallSec, SLOTS, 3600, rng);
+    }
+};
+
+// Works 07:00-16:00 and sleeps through the pet's mornings; checks every
+// twenty minutes while home
+class NightShiftPolicy : public CarePolicy {
+public:
+    const char* name() const override { return "night"; }
+    uint32_t nextCheck(uint32_t wallSec, Rng& rng) const override {
+        uint32_t next = wallSec + 1200;
+        uint8_t h = hourOf(next);
+        if (h >= 7 && h < 16) {
+            uint32_t midnight = next - next % 86400UL;
+            next = midnight + 16 * 3600UL + rng.below(1800);
+        }
+        return next;
+    }
+};
+
+// Looks in at random (every 90 min on average, 07:00-24:00), answers
+// seven needs in ten and guesses the minigame blindly
+class RandomPolicy : public CarePolicy {
+public:
+    const char* name() const override { return "random"; }
+    uint32_t nextCheck(uint32_t wallSec, Rng& rng) const override {
+        uint32_t next = wallSec + expGap(90 * 60, rng);
+        if (hourOf(next) < 7) {
+            uint32_t midnight = next - next % 86400UL;
+            next = midnight + 7 * 3600UL + expGap(90 * 60, rng);
+        }
+        return next;
+    }
+    void care(CareSession& s) const override { s.tendAll(70, false); }
+};
+
+// Check-in times taken from a real player's log, one per line:
+//   08:15      every day
+//   2 13:40    on day 2 only (the egg is laid on day 0)
+// Lines starting with '#' are ignored. Each check-in is full care.
+class ReplayPolicy : public CarePolicy {
+public:
+    const char* name() const override { return _name.c_str(); }
+
+    bool load(const std::string& path, std::string& error) {
+        _name = "replay:" + path;
+        FILE* f = fopen(path.c_str(), "r");
+        if (!f) {
+            error = "cannot read " + path;
+            return false;
+        }
+        char line[128];
+        int lineNo = 0;
+        while (fgets(line, sizeof(line), f)) {
+            lineNo++;
+            unsigned day, hh, mm;
+            char c;
+            if (sscanf(line, " %c", &c) != 1 || c == '#') continue;
+            if (sscanf(line, "%u %u:%u", &day, &hh, &mm) == 3 && hh < 24 && mm < 60) {
+                _dated.push_back(SIM_EPOCH + day * 86400UL + hh * 3600UL + mm * 60UL);
+            } else if (sscanf(line, "%u:%u", &hh, &mm) == 2 && hh < 24 && mm < 60) {
+                _daily.push_back((uint16_t)(hh * 60 + mm));
+            } else {
+                error = path + ":" + std::to_string(lineNo) + ": expected HH:MM or DAY HH:MM";
+                fclose(f);
+                return false;
+            }
+        }
+        fclose(f);
+        if (_daily.empty() && _dated.empty()) {
+            error = path + ": no check-in times";
+            return false;
+        }
+        std::sort(_dated.begin(), _dated.end());
+        return true;
+    }
+
+    uint32_t nextCheck(uint32_t wallSec, Rng& rng) const override {
+        uint32_t next = _daily.empty() ? UINT32_MAX : nextDaily(wallSec, _daily, 0, rng);
+        auto it = std::upper_bound(_dated.begin(), _dated.end(), wallSec);
+        if (it != _dated.end()) next = std::min(next, *it);
+        return next;
+    }
+
+private:
+    std::string           _name;
+    std::vector<uint16_t> _daily;
+    std::vector<uint32_t> _dated;
+};
+
+}  // namespace
+
+const char* const BUILTIN_POLICIES[] = {"perfect", "lazy", "night", "random"};
+const int BUILTIN_POLICY_COUNT = sizeof(BUILTIN_POLICIES) / sizeof(BUILTIN_POLICIES[0]);
+
+std::unique_ptr<CarePolicy> makePolicy(const std::string& spec, std::string& error) {
+    if (spec == "perfect") return std::unique_ptr<CarePolicy>(new PerfectPolicy());
+    if (spec == "lazy")    return std::unique_ptr<CarePolicy>(new LazyPolicy());
+    if (spec == "night")   return std::unique_ptr<CarePolicy>(new NightShiftPolicy());
+    if (spec == "random")  return std::unique_ptr<CarePolicy>(new RandomPolicy());
+    if (spec.compare(0, 7, "replay:") == 0) {
+        std::unique_ptr<ReplayPolicy> p(new ReplayPolicy());
+        if (!p->load(spec.substr(7), error)) return nullptr;
+        return std::unique_ptr<CarePolicy>(p.release());
+    }
+    error = "unknown policy '" + spec + "'";
+    return nullptr;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "pet.h"
+#include "minigame.h"
+#include "clock.h"
+#include "rng.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// What a player can do at one check-in. Actions take no game time; the
+// minigame is the real MiniGame, seeded from the pet's stream exactly as
+// the device does it.
+class CareSession {
+public:
+    CareSession(PetManager& pet, MiniGame& game, Clock& clock, Rng& rng)
+        : _pet(pet), _game(game), _clock(clock), _rng(rng) {}
+    virtual ~CareSession() = default;
+
+    // Answers each need with probability attendPct; guessWell plays the
+    // minigame by odds instead of by coin flip
+    void tendAll(uint8_t attendPct = 100, bool guessWell = true);
+
+    void scold();
+    void heal();
+    void clean();
+    void feed();
+    void cheerUp(bool guessWell);
+    void lightsOut();
+
+    Rng& rng() { return _rng; }
+
+protected:
+    PetManager& _pet;
+    MiniGame&   _game;
+    Clock&      _clock;
+    Rng&        _rng;
+
+    // One round of the minigame; false if the pet won't play
+    virtual bool playGame(bool guessWell);
+};
+
+// When a player looks at the device and what they do then. Policies are
+// shared by all worker threads, so they keep no per-run state: anything
+// random comes from the run's Rng.
+class CarePolicy {
+public:
+    virtual ~CarePolicy() = default;
+    virtual const char* name() const = 0;
+    // Wall time (seconds) of the next check-in, strictly after wallSec
+    virtual uint32_t nextCheck(uint32_t wallSec, Rng& rng) const = 0;
+    virtual void care(CareSession& s) const { s.tendAll(); }
+};
+
+// "perfect", "lazy", "night", "random" or "replay:<file>".
+// Returns nullptr and fills error if the spec or the file is bad.
+std::unique_ptr<CarePolicy> makePolicy(const std::string& spec, std::string& error);
+
+// The built-in policies, for --policy all
+extern const char* const BUILTIN_POLICIES[];
+extern const int BUILTIN_POLICY_COUNT;
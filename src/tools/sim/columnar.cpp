@@ -0,0 +1,377 @@
+#include "columnar.h"
+#include "journal_format.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint8_t MAGIC[4] = {'S', 'C', 'O', 'L'};
+constexpr uint8_t VERSION = 1;
+constexpr uint32_t MAX_DICT = 256;  // larger dictionaries never beat bit-packing here
+
+uint8_t bitWidth(uint32_t v) {
+    uint8_t w = 0;
+    while (v) {
+        w++;
+        v >>= 1;
+    }
+    return w;
+}
+
+size_t varintSize(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    uint8_t buf[10];
+    out.insert(out.end(), buf, journalPutVarint64(buf, v));
+}
+
+// value(i) - base in width bits each, least significant bit first
+template <typename Value>
+void packBits(std::vector<uint8_t>& out, size_t n, uint8_t width, Value value) {
+    uint64_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc |= (uint64_t)value(i) << bits;
+        bits += width;
+        while (bits >= 8) {
+            out.push_back((uint8_t)acc);
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits > 0) out.push_back((uint8_t)acc);
+}
+
+// Inverse of packBits; false if the bits run past end
+template <typename Store>
+bool unpackBits(const uint8_t* p, const uint8_t* end, size_t n, uint8_t width, Store store) {
+    if (width > 32) return false;
+    if ((uint64_t)(end - p) * 8 < (uint64_t)n * width) return false;
+    if (width == 0) {
+        for (size_t i = 0; i < n; i++) store(i, 0);
+        return true;
+    }
+    const uint64_t mask = (1ULL << width) - 1;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t bit = (uint64_t)i * width;
+        const uint8_t* q = p + (bit >> 3);
+        uint64_t word = 0;
+        // Whole 8-byte loads except at the very end of the chunk
+        if (end - q >= 8) {
+            memcpy(&word, q, 8);
+        } else {
+            memcpy(&word, q, (size_t)(end - q));
+        }
+        store(i, (uint32_t)((word >> (bit & 7)) & mask));
+    }
+    return true;
+}
+
+}  // namespace
+
+// ===== Writer =====
+
+bool ColumnWriter::open(const char* path, const std::vector<std::string>& names,
+                        const std::vector<ColumnType>& types, uint32_t groupRows) {
+    close();
+    if (names.size() != types.size() || names.empty()) return false;
+    _file = fopen(path, "wb");
+    if (!_file) return false;
+    _ok = true;
+    _groupRows = groupRows ? groupRows : COLUMN_GROUP_ROWS;
+    _rows = _bytes = 0;
+    _columns.clear();
+    for (size_t c = 0; c < names.size(); c++) {
+        _columns.push_back({names[c], types[c], {}, {}});
+        _columns.back().cells.reserve(_groupRows);
+    }
+    _groupSizes.clear();
+    _chunks.clear();
+    write(MAGIC, sizeof(MAGIC));
+    write(&VERSION, 1);
+    return true;
+}
+
+uint32_t ColumnWriter::intern(size_t c, const std::string& s) {
+    auto& dict = _columns[c].dictionary;
+    for (size_t i = 0; i < dict.size(); i++) {
+        if (dict[i] == s) return (uint32_t)i;
+    }
+    dict.push_back(s);
+    return (uint32_t)(dict.size() - 1);
+}
+
+void ColumnWriter::addRow(const uint32_t* cells) {
+    for (size_t c = 0; c < _columns.size(); c++) _columns[c].cells.push_back(cells[c]);
+    _rows++;
+    if (_columns[0].cells.size() >= _groupRows) flushGroup();
+}
+
+void ColumnWriter::write(const uint8_t* data, size_t size) {
+    if (size && fwrite(data, 1, size, _file) != size) _ok = false;
+    _bytes += size;
+}
+
+void ColumnWriter::flushGroup() {
+    size_t n = _columns[0].cells.size();
+    if (n == 0) return;
+    for (Column& col : _columns) {
+        const std::vector<uint32_t>& v = col.cells;
+        uint32_t lo = *std::min_element(v.begin(), v.end());
+        uint32_t hi = *std::max_element(v.begin(), v.end());
+
+        // Size of each encoding, without building it
+        uint8_t width = bitWidth(hi - lo);
+        size_t packSize = varintSize(lo) + 1 + (n * width + 7) / 8;
+        size_t rleSize = 0;
+        for (size_t i = 0; i < n;) {
+            size_t j = i + 1;
+            while (j < n && v[j] == v[i]) j++;
+            rleSize += varintSize(v[i]) + varintSize(j - i);
+            i = j;
+        }
+        std::vector<uint32_t> dict;
+        size_t dictSize = SIZE_MAX;
+        if (width > 1) {
+            dict = v;
+            std::sort(dict.begin(), dict.end());
+            dict.erase(std::unique(dict.begin(), dict.end()), dict.end());
+            if (dict.size() <= MAX_DICT) {
+                dictSize = varintSize(dict.size()) + 1 + (n * bitWidth((uint32_t)dict.size() - 1) + 7) / 8;
+                for (uint32_t d : dict) dictSize += varintSize(d);
+            }
+        }
+
+        _buf.clear();
+        ChunkEncoding enc;
+        if (rleSize <= packSize && rleSize <= dictSize) {
+            enc = ChunkEncoding::RLE;
+            for (size_t i = 0; i < n;) {
+                size_t j = i + 1;
+                while (j < n && v[j] == v[i]) j++;
+                putVarint(_buf, v[i]);
+                putVarint(_buf, j - i);
+                i = j;
+            }
+        } else if (dictSize < packSize) {
+            enc = ChunkEncoding::DICT;
+            putVarint(_buf, dict.size());
+            for (uint32_t d : dict) putVarint(_buf, d);
+            uint8_t iw = bitWidth((uint32_t)dict.size() - 1);
+            _buf.push_back(iw);
+            packBits(_buf, n, iw, [&](size_t i) {
+                return (uint32_t)(std::lower_bound(dict.begin(), dict.end(), v[i]) - dict.begin());
+            });
+        } else {
+            enc = ChunkEncoding::BITPACK;
+            putVarint(_buf, lo);
+            _buf.push_back(width);
+            packBits(_buf, n, width, [&](size_t i) { return v[i] - lo; });
+        }
+        _chunks.push_back({enc, _bytes, _buf.size(), lo, hi});
+        write(_buf.data(), _buf.size());
+        col.cells.clear();
+    }
+    _groupSizes.push_back((uint32_t)n);
+}
+
+bool ColumnWriter::close() {
+    if (!_file) return _ok;
+    flushGroup();
+
+    _buf.clear();
+    putVarint(_buf, _columns.size());
+    for (const Column& col : _columns) {
+        putVarint(_buf, col.name.size());
+        _buf.insert(_buf.end(), col.name.begin(), col.name.end());
+        _buf.push_back(static_cast<uint8_t>(col.type));
+        if (col.type == ColumnType::STRING) {
+            putVarint(_buf, col.dictionary.size());
+            for (const std::string& s : col.dictionary) {
+                putVarint(_buf, s.size());
+                _buf.insert(_buf.end(), s.begin(), s.end());
+            }
+        }
+    }
+    putVarint(_buf, _groupSizes.size());
+    for (size_t g = 0; g < _groupSizes.size(); g++) {
+        putVarint(_buf, _groupSizes[g]);
+        for (size_t c = 0; c < _columns.size(); c++) {
+            const ColumnChunk& k = _chunks[g * _columns.size() + c];
+            _buf.push_back(static_cast<uint8_t>(k.encoding));
+            putVarint(_buf, k.offset);
+            putVarint(_buf, k.size);
+            putVarint(_buf, k.min);
+            putVarint(_buf, k.max);
+        }
+    }
+    uint32_t footer = (uint32_t)_buf.size();
+    uint8_t tail[8];
+    memcpy(tail, &footer, 4);  // little-endian hosts only, like the rest of the tools
+    memcpy(tail + 4, MAGIC, 4);
+    _buf.insert(_buf.end(), tail, tail + 8);
+    write(_buf.data(), _buf.size());
+
+    if (fclose(_file) != 0) _ok = false;
+    _file = nullptr;
+    return _ok;
+}
+
+// ===== Reader =====
+
+bool ColumnFile::open(const char* path, std::string& error) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        error = std::string("cannot read ") + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 13) {
+        ::close(fd);
+        error = std::string(path) + ": not a column file";
+        return false;
+    }
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        error = std::string("cannot map ") + path;
+        return false;
+    }
+    _data = (const uint8_t*)p;
+    _size = (size_t)st.st_size;
+
+    uint32_t footer;
+    memcpy(&footer, _data + _size - 8, 4);
+    bool ok = memcmp(_data, MAGIC, 4) == 0 && _data[4] == VERSION &&
+              memcmp(_data + _size - 4, MAGIC, 4) == 0 && footer <= _size - 13;
+    const uint8_t* q = ok ? _data + _size - 8 - footer : nullptr;
+    const uint8_t* end = _data + _size - 8;
+    uint64_t v = 0;
+    auto get = [&]() {
+        if (q) q = journalGetVarint(q, end, v);
+        return q != nullptr;
+    };
+    auto getString = [&](std::string& s) {
+        if (!get() || v > (uint64_t)(end - q)) {
+            q = nullptr;
+            return false;
+        }
+        s.assign((const char*)q, (size_t)v);
+        q += v;
+        return true;
+    };
+
+    if (get()) _columns.resize((size_t)std::min<uint64_t>(v, 1024));
+    for (Column& col : _columns) {
+        if (!getString(col.name) || q >= end) break;
+        col.type = static_cast<ColumnType>(*q++);
+        if (col.type != ColumnType::STRING) continue;
+        if (!get()) break;
+        uint64_t count = v;
+        for (uint64_t i = 0; i < count && q; i++) {
+            std::string s;
+            if (getString(s)) col.dictionary.push_back(s);
+        }
+    }
+    if (get()) _groupSizes.resize((size_t)std::min<uint64_t>(v, _size));
+    for (size_t g = 0; g < _groupSizes.size() && q; g++) {
+        if (!get()) break;
+        _groupSizes[g] = (uint32_t)v;
+        _rows += v;
+        for (size_t c = 0; c < _columns.size() && q; c++) {
+            ColumnChunk k;
+            if (q >= end) {
+                q = nullptr;
+                break;
+            }
+            k.encoding = static_cast<ChunkEncoding>(*q++);
+            if (get()) k.offset = v;
+            if (get()) k.size = v;
+            if (get()) k.min = (uint32_t)v;
+            if (get()) k.max = (uint32_t)v;
+            if (q && (k.offset > _size || k.size > _size - k.offset)) q = nullptr;
+            _chunks.push_back(k);
+        }
+    }
+    if (!q || _columns.empty()) {
+        close();
+        error = std::string(path) + ": damaged or not a column file";
+        return false;
+    }
+    return true;
+}
+
+void ColumnFile::close() {
+    if (_data) munmap((void*)_data, _size);
+    _data = nullptr;
+    _size = 0;
+    _rows = 0;
+    _columns.clear();
+    _groupSizes.clear();
+    _chunks.clear();
+}
+
+int ColumnFile::find(const std::string& name) const {
+    for (size_t c = 0; c < _columns.size(); c++) {
+        if (_columns[c].name == name) return (int)c;
+    }
+    return -1;
+}
+
+bool ColumnFile::decode(size_t g, size_t c, uint32_t* out) const {
+    const ColumnChunk& k = chunk(g, c);
+    const uint8_t* p = _data + k.offset;
+    const uint8_t* end = p + k.size;
+    const size_t n = _groupSizes[g];
+    uint64_t v = 0;
+
+    switch (k.encoding) {
+    case ChunkEncoding::BITPACK: {
+        if (!(p = journalGetVarint(p, end, v)) || p >= end) return false;
+        uint32_t base = (uint32_t)v;
+        uint8_t width = *p++;
+        return unpackBits(p, end, n, width, [&](size_t i, uint32_t x) { out[i] = base + x; });
+    }
+    case ChunkEncoding::RLE: {
+        size_t i = 0;
+        while (i < n) {
+            uint64_t run;
+            if (!(p = journalGetVarint(p, end, v)) || !(p = journalGetVarint(p, end, run))) return false;
+            if (run > n - i) return false;
+            std::fill(out + i, out + i + run, (uint32_t)v);
+            i += (size_t)run;
+        }
+        return true;
+    }
+    case ChunkEncoding::DICT: {
+        uint32_t dict[MAX_DICT];
+        if (!(p = journalGetVarint(p, end, v)) || v == 0 || v > MAX_DICT) return false;
+        uint32_t count = (uint32_t)v;
+        for (uint32_t i = 0; i < count; i++) {
+            if (!(p = journalGetVarint(p, end, v))) return false;
+            dict[i] = (uint32_t)v;
+        }
+        if (p >= end) return false;
+        uint8_t width = *p++;
+        bool inRange = true;
+        bool ok = unpackBits(p, end, n, width, [&](size_t i, uint32_t x) {
+            inRange &= x < count;
+            out[i] = dict[x < count ? x : 0];
+        });
+        return ok && inRange;
+    }
+    }
+    return false;
+}
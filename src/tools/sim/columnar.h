@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Column-oriented result files for very many simulated lives. Rows are
+// cut into groups; each group stores every column as its own chunk, so a
+// query reads only the columns it uses. Every cell is a uint32_t; string
+// columns keep one dictionary per column and store ids. Each chunk is
+// encoded the smallest of three ways:
+//
+//   BITPACK  varint base, byte width, (value - base) in width bits each
+//   RLE      (varint value, varint run) pairs
+//   DICT     varint k, k varint values, byte width, indices in width bits
+//
+// File:   "SCOL", version byte, chunks, footer, u32 footer size, "SCOL"
+// Footer: varint columns, per column the name, type byte and (strings)
+//         the dictionary; varint groups, per group varint rows and per
+//         column the chunk's encoding byte, offset, size, min and max
+//         (varints). Min/max let a filter skip whole chunks.
+enum class ColumnType : uint8_t { UINT, STRING };
+enum class ChunkEncoding : uint8_t { BITPACK, RLE, DICT };
+
+constexpr uint32_t COLUMN_GROUP_ROWS = 65536;
+
+// Where one column of one group lives in the file
+struct ColumnChunk {
+    ChunkEncoding encoding;
+    uint64_t offset, size;
+    uint32_t min, max;
+};
+
+class ColumnWriter {
+public:
+    ~ColumnWriter() { close(); }
+
+    bool open(const char* path, const std::vector<std::string>& names,
+              const std::vector<ColumnType>& types, uint32_t groupRows = COLUMN_GROUP_ROWS);
+    // Id of a string in column c's dictionary, added on first use
+    uint32_t intern(size_t c, const std::string& s);
+    // One cell per column
+    void addRow(const uint32_t* cells);
+    // Writes the last group and the footer; false if any write failed
+    bool close();
+
+    uint64_t rows() const { return _rows; }
+    uint64_t bytes() const { return _bytes; }
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType  type;
+        std::vector<std::string> dictionary;
+        std::vector<uint32_t> cells;  // the open group
+    };
+
+    FILE*    _file = nullptr;
+    bool     _ok = true;
+    uint32_t _groupRows = COLUMN_GROUP_ROWS;
+    uint64_t _rows = 0, _bytes = 0;
+    std::vector<Column> _columns;
+    std::vector<uint32_t> _groupSizes;
+    std::vector<ColumnChunk> _chunks;  // group-major
+    std::vector<uint8_t> _buf;
+
+    void write(const uint8_t* data, size_t size);
+    void flushGroup();
+};
+
+// Read side: maps the file and decodes single chunks on demand
+class ColumnFile {
+public:
+    ~ColumnFile() { close(); }
+
+    bool open(const char* path, std::string& error);
+    void close();
+
+    size_t size() const { return _size; }
+    uint64_t rows() const { return _rows; }
+    size_t columns() const { return _columns.size(); }
+    int find(const std::string& name) const;  // -1 if absent
+    const std::string& name(size_t c) const { return _columns[c].name; }
+    ColumnType type(size_t c) const { return _columns[c].type; }
+    const std::vector<std::string>& dictionary(size_t c) const { return _columns[c].dictionary; }
+
+    size_t groups() const { return _groupSizes.size(); }
+    uint32_t groupRows(size_t g) const { return _groupSizes[g]; }
+    uint32_t min(size_t g, size_t c) const { return chunk(g, c).min; }
+    uint32_t max(size_t g, size_t c) const { return chunk(g, c).max; }
+    ChunkEncoding encoding(size_t g, size_t c) const { return chunk(g, c).encoding; }
+    uint64_t chunkBytes(size_t g, size_t c) const { return chunk(g, c).size; }
+    // Writes groupRows(g) cells; false if the chunk is damaged
+    bool decode(size_t g, size_t c, uint32_t* out) const;
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType  type;
+        std::vector<std::string> dictionary;
+    };
+
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    uint64_t _rows = 0;
+    std::vector<Column> _columns;
+    std::vector<uint32_t> _groupSizes;
+    std::vector<ColumnChunk> _chunks;  // group-major
+
+    const ColumnChunk& chunk(size_t g, size_t c) const { return _chunks[g * _columns.size() + c]; }
+};
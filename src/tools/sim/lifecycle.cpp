@@ -0,0 +1,142 @@
+#include "lifecycle.h"
+#include "pet.h"
+#include "minigame.h"
+#include "clock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 95% Wilson score interval of k successes in n
+void wilson(uint64_t k, uint64_t n, double& lo, double& hi) {
+    const double z = 1.96;
+    if (n == 0) { lo = hi = 0; return; }
+    double p = (double)k / n;
+    double d = 1 + z * z / n;
+    double c = (p + z * z / (2.0 * n)) / d;
+    double h = z * std::sqrt(p * (1 - p) / n + z * z / (4.0 * n * n)) / d;
+    lo = std::max(0.0, c - h);
+    hi = std::min(1.0, c + h);
+}
+
+// Half width of the 95% normal interval of a mean
+double meanHalfWidth(double sum, double sq, uint64_t n) {
+    if (n < 2) return 0;
+    double mean = sum / n;
+    double var = (sq - n * mean * mean) / (n - 1);
+    return 1.96 * std::sqrt(var > 0 ? var : 0) / std::sqrt((double)n);
+}
+
+}  // namespace
+
+uint32_t runSeed(uint64_t batchSeed, uint64_t index) {
+    // splitmix64 of the pair
+    uint64_t z = batchSeed * 0x9E3779B97F4A7C15ULL + index + 1;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+LifeOutcome runLifecycle(const CarePolicy& policy, uint32_t seed, const SimOptions& opt) {
+    VirtualClock clock(SIM_EPOCH + opt.startHour * 3600UL);
+    PetManager pet;
+    MiniGame   game;
+    game.setClock(&clock);
+
+    // The player's choices get their own stream, 2^64 steps away from the pet's
+    Rng rng;
+    rng.seed(seed);
+    rng.jump();
+
+    pet.setRules(opt.rules);
+    pet.initNewEgg(clock.nowMs(), seed);
+    CareSession session(pet, game, clock, rng);
+
+    LifeOutcome out;
+    out.reach(CharacterID::EGG);
+    uint32_t nextCheck = 0;
+    CheckInHooks hooks;
+    liveCheckIns(policy, session, pet, clock, rng, nextCheck, opt.maxDays * 86400000UL, out, hooks);
+
+    const PetData& p = pet.data();
+    if (p.isDead) out.deathCause = p.deathCause < DEATH_CAUSES ? p.deathCause : 0;
+    out.ageHours = p.age;
+    out.careMistakes = p.totalCareMistakes;
+    return out;
+}
+
+// ===== Statistics =====
+
+OutcomeStats::OutcomeStats(uint16_t maxDays) : _ageHist(maxDays * 24UL + 1, 0) {}
+
+void OutcomeStats::add(const LifeOutcome& o) {
+    _runs++;
+    for (int c = 0; c < CHARS; c++) {
+        if (o.reached & (1UL << c)) _reached[c]++;
+    }
+    _final[static_cast<int>(o.finalForm)]++;
+    _death[o.deathCause]++;
+    _ageSum += o.ageHours;
+    _ageSq += (double)o.ageHours * o.ageHours;
+    _mistakeSum += o.careMistakes;
+    _mistakeSq += (double)o.careMistakes * o.careMistakes;
+    _ageHist[std::min<size_t>(o.ageHours, _ageHist.size() - 1)]++;
+}
+
+void OutcomeStats::merge(const OutcomeStats& other) {
+    _runs += other._runs;
+    for (int c = 0; c < CHARS; c++) {
+        _reached[c] += other._reached[c];
+        _final[c] += other._final[c];
+    }
+    for (int i = 0; i <= DEATH_CAUSES; i++) _death[i] += other._death[i];
+    _ageSum += other._ageSum;
+    _ageSq += other._ageSq;
+    _mistakeSum += other._mistakeSum;
+    _mistakeSq += other._mistakeSq;
+    if (_ageHist.size() < other._ageHist.size()) _ageHist.resize(other._ageHist.size(), 0);
+    for (size_t i = 0; i < other._ageHist.size(); i++) _ageHist[i] += other._ageHist[i];
+}
+
+uint16_t OutcomeStats::ageQuantile(double q) const {
+    uint64_t want = (uint64_t)std::ceil(q * _runs);
+    if (want == 0) want = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < _ageHist.size(); i++) {
+        seen += _ageHist[i];
+        if (seen >= want) return (uint16_t)i;
+    }
+    return (uint16_t)(_ageHist.size() - 1);
+}
+
+void OutcomeStats::print(FILE* out, const char* title) const {
+    fprintf(out, "== %s: %llu lives\n", title, (unsigned long long)_runs);
+    if (_runs == 0) return;
+
+    double n = (double)_runs;
+    fprintf(out, "  age at end     mean %6.1f h +-%.1f   p10 %u  median %u  p90 %u\n",
+            _ageSum / n, meanHalfWidth(_ageSum, _ageSq, _runs),
+            ageQuantile(0.1), ageQuantile(0.5), ageQuantile(0.9));
+    fprintf(out, "  care mistakes  mean %6.2f   +-%.2f\n",
+            _mistakeSum / n, meanHalfWidth(_mistakeSum, _mistakeSq, _runs));
+
+    static const char* const CAUSES[DEATH_CAUSES + 1] = {"hunger", "sickness", "old age", "alive at cutoff"};
+    fprintf(out, "  end of life\n");
+    for (int i = 0; i <= DEATH_CAUSES; i++) {
+        double lo, hi;
+        wilson(_death[i], _runs, lo, hi);
+        fprintf(out, "    %-16s %6.2f%%  [%6.2f, %6.2f]\n", CAUSES[i],
+                100.0 * _death[i] / n, 100.0 * lo, 100.0 * hi);
+    }
+
+    fprintf(out, "  reached / last form\n");
+    for (int c = static_cast<int>(CharacterID::BABY_CHAN); c < CHARS; c++) {
+        if (c == static_cast<int>(CharacterID::GHOST)) continue;
+        double lo, hi;
+        wilson(_reached[c], _runs, lo, hi);
+        fprintf(out, "    %-16s %6.2f%%  [%6.2f, %6.2f]   %6.2f%%\n",
+                getCharacterDef(static_cast<CharacterID>(c)).nameEN,
+                100.0 * _reached[c] / n, 100.0 * lo, 100.0 * hi, 100.0 * _final[c] / n);
+    }
+    fprintf(out, "  (95%% intervals: Wilson for rates, normal for means)\n");
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include "care_policy.h"
+#include "character.h"
+#include "clock.h"
+#include "pet.h"
+#include "rules.h"
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Midnight of the first simulated day (2024-01-01). Only the hour of day
+// matters to the pet; a fixed date keeps replay days well defined.
+constexpr uint32_t SIM_EPOCH = 1704067200UL;
+
+struct SimOptions {
+    uint8_t  startHour = 8;   // when the egg is laid
+    uint16_t maxDays   = 30;  // lives still going after this are cut off
+    const GameRules* rules = nullptr;  // nullptr: config.h defaults
+};
+
+constexpr uint8_t DEATH_CAUSES  = 3;  // PetData::deathCause values
+constexpr uint8_t STILL_ALIVE   = DEATH_CAUSES;
+
+struct LifeOutcome {
+    uint32_t    reached    = 0;  // bit per CharacterID the pet ever was
+    CharacterID finalForm  = CharacterID::EGG;  // last form before the ghost
+    uint8_t     deathCause = STILL_ALIVE;
+    uint16_t    ageHours   = 0;
+    uint16_t    careMistakes = 0;
+    // Seconds after laying when BABY..ADULT began; 0: never got there
+    uint32_t    stageSec[4] = {};
+
+    void reach(CharacterID id) {
+        reached |= 1UL << static_cast<uint8_t>(id);
+        finalForm = id;
+    }
+    void enter(LifeStage stage, unsigned long ms) {
+        uint8_t i = static_cast<uint8_t>(stage);
+        if (i >= 1 && i <= 4 && stageSec[i - 1] == 0) stageSec[i - 1] = (uint32_t)(ms / 1000UL);
+    }
+};
+
+// Advances the pet to untilMs (as PetManager::simulateOffline does),
+// noting every form it takes in out. onStep() runs after every step the
+// pet settles at, evolutions done.
+template <typename OnStep>
+void liveUntil(PetManager& pet, VirtualClock& clock, unsigned long untilMs, LifeOutcome& out,
+               OnStep&& onStep) {
+    for (;;) {
+        unsigned long t = clock.nowMs();
+        pet.update(t, clock.hour());
+        if (pet.isEvolving()) {
+            pet.doEvolve(t);
+            out.reach(pet.data().characterId);
+            out.enter(pet.data().stage, t);
+            continue;  // new stage may already have something due
+        }
+        onStep();
+        if (pet.data().isDead || t >= untilMs) return;
+
+        // Nothing changes before the next event or the next hour
+        unsigned long step = untilMs - t;
+        unsigned long toHour = (3600UL - clock.wallSeconds() % 3600UL) * 1000UL - t % 1000UL;
+        if (toHour < step) step = toHour;
+        if (pet.hasScheduledEvent() && pet.nextEventMs() - t < step) {
+            step = pet.nextEventMs() - t;
+        }
+        clock.advance(step);
+    }
+}
+
+inline void liveUntil(PetManager& pet, VirtualClock& clock, unsigned long untilMs, LifeOutcome& out) {
+    liveUntil(pet, clock, untilMs, out, [] {});
+}
+
+// Points where liveCheckIns() lets a caller look in or step in. The
+// defaults are runLifecycle()'s; a caller derives and hides what it needs.
+struct CheckInHooks {
+    void step() {}                                        // after each settled step
+    unsigned long stopAt() const { return ULONG_MAX; }    // an extra stop, game ms
+    void stop() {}                                        // reached stopAt(), pet alive
+    bool care() { return true; }                          // false: this check-in is skipped
+    void checkedIn() {}                                   // after each check-in (or the cutoff)
+};
+
+// The player's check-ins under a policy until death or limitMs.
+// nextCheck is the wall second of the coming check-in, 0 if not drawn
+// yet, so a life can be resumed between two of them.
+template <typename Hooks>
+void liveCheckIns(const CarePolicy& policy, CareSession& session, PetManager& pet, VirtualClock& clock,
+                  Rng& player, uint32_t& nextCheck, unsigned long limitMs, LifeOutcome& out, Hooks& hooks) {
+    auto onStep = [&hooks] { hooks.step(); };
+    while (!pet.data().isDead && clock.nowMs() < limitMs) {
+        uint32_t wall = clock.wallSeconds();
+        if (nextCheck == 0) nextCheck = policy.nextCheck(wall, player);
+        // Check-ins fall on whole seconds of wall time
+        uint64_t untilMs = clock.nowMs() - clock.nowMs() % 1000UL + (uint64_t)(nextCheck - wall) * 1000ULL;
+        bool checkIn = untilMs < limitMs;
+        unsigned long target = checkIn ? (unsigned long)untilMs : limitMs;
+        unsigned long stopMs = hooks.stopAt();
+        if (stopMs <= target) {
+            liveUntil(pet, clock, stopMs, out, onStep);
+            if (pet.data().isDead) return;
+            hooks.stop();
+            continue;
+        }
+        liveUntil(pet, clock, target, out, onStep);
+        if (checkIn && !pet.data().isDead && hooks.care()) policy.care(session);
+        nextCheck = 0;
+        hooks.checkedIn();
+    }
+}
+
+// One egg-to-grave life under a policy, fully determined by the seed
+LifeOutcome runLifecycle(const CarePolicy& policy, uint32_t seed, const SimOptions& opt);
+
+// Seed of run `index` of a batch; independent of how runs are split up
+uint32_t runSeed(uint64_t batchSeed, uint64_t index);
+
+// Outcome counts, merged across worker threads. Only sums and counts, so
+// the merged result does not depend on thread count or scheduling.
+class OutcomeStats {
+public:
+    explicit OutcomeStats(uint16_t maxDays = 30);
+
+    void add(const LifeOutcome& o);
+    void merge(const OutcomeStats& other);
+    void print(FILE* out, const char* title) const;
+
+    uint64_t runs() const { return _runs; }
+    double   reachedRate(CharacterID id) const { return rate(_reached[static_cast<int>(id)]); }
+    double   deathRate(uint8_t cause) const { return rate(_death[cause]); }
+    double   meanAge() const { return _runs ? _ageSum / _runs : 0; }
+    double   meanCareMistakes() const { return _runs ? _mistakeSum / _runs : 0; }
+    uint16_t ageQuantile(double q) const;
+
+private:
+    static constexpr int CHARS = static_cast<int>(CharacterID::CHARACTER_COUNT);
+
+    uint64_t _runs = 0;
+    uint64_t _reached[CHARS]  = {};
+    uint64_t _final[CHARS]    = {};
+    uint64_t _death[DEATH_CAUSES + 1] = {};
+    double   _ageSum = 0, _ageSq = 0;
+    double   _mistakeSum = 0, _mistakeSq = 0;
+    std::vector<uint64_t> _ageHist;  // one bucket per hour of age
+
+    double rate(uint64_t k) const { return _runs ? (double)k / _runs : 0; }
+};
@@ -0,0 +1,182 @@
+// =============================================
+//  Headless lifecycle simulator (sim env)
+//  Runs many seeded egg-to-grave lives of the real PetManager under
+//  scripted care policies and reports how they turn out. Each life can
+//  also be written out as a row, columnar (--out) or as CSV (--csv).
+// =============================================
+
+#include "columnar.h"
+#include "lifecycle.h"
+#include "work_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Lives are written in order in batches of this many, whatever the threads
+constexpr uint64_t ROW_BATCH = 1 << 18;
+
+static const char* const COLUMNS[] = {
+    "seed", "policy", "final_form", "death_cause", "age_hours", "care_mistakes",
+    "baby_sec", "child_sec", "teen_sec", "adult_sec",
+};
+constexpr size_t COLUMN_COUNT = sizeof(COLUMNS) / sizeof(COLUMNS[0]);
+static const char* const CAUSE_NAMES[DEATH_CAUSES + 1] = {"hunger", "sickness", "old age", "alive"};
+
+// Per-life rows, to either or both formats
+class RowOutput {
+public:
+    bool open(const char* colPath, const char* csvPath) {
+        if (colPath) {
+            std::vector<std::string> names(COLUMNS, COLUMNS + COLUMN_COUNT);
+            std::vector<ColumnType> types(COLUMN_COUNT, ColumnType::UINT);
+            types[1] = types[2] = types[3] = ColumnType::STRING;
+            if (!_col.open(colPath, names, types)) return fail(colPath);
+            _columnar = true;
+        }
+        if (csvPath) {
+            _csv = fopen(csvPath, "w");
+            if (!_csv) return fail(csvPath);
+            for (size_t c = 0; c < COLUMN_COUNT; c++) fprintf(_csv, c ? ",%s" : "%s", COLUMNS[c]);
+            fputc('\n', _csv);
+        }
+        return true;
+    }
+    bool active() const { return _columnar || _csv; }
+
+    void add(uint32_t seed, const char* policy, const LifeOutcome& o) {
+        const char* form = getCharacterDef(o.finalForm).nameEN;
+        if (_columnar) {
+            uint32_t cells[COLUMN_COUNT] = {
+                seed, _col.intern(1, policy), _col.intern(2, form), _col.intern(3, CAUSE_NAMES[o.deathCause]),
+                o.ageHours, o.careMistakes, o.stageSec[0], o.stageSec[1], o.stageSec[2], o.stageSec[3],
+            };
+            _col.addRow(cells);
+        }
+        if (_csv) {
+            fprintf(_csv, "%u,%s,%s,%s,%u,%u,%u,%u,%u,%u\n", seed, policy, form, CAUSE_NAMES[o.deathCause],
+                    o.ageHours, o.careMistakes, o.stageSec[0], o.stageSec[1], o.stageSec[2], o.stageSec[3]);
+        }
+    }
+
+    bool close() {
+        bool ok = true;
+        if (_columnar) {
+            ok = _col.close();
+            fprintf(stdout, "%llu rows, %.1f MB columnar\n", (unsigned long long)_col.rows(), _col.bytes() / 1e6);
+        }
+        if (_csv) {
+            long bytes = ftell(_csv);
+            ok = fclose(_csv) == 0 && ok;
+            fprintf(stdout, "%.1f MB CSV\n", bytes / 1e6);
+        }
+        return ok;
+    }
+
+private:
+    ColumnWriter _col;
+    bool  _columnar = false;
+    FILE* _csv = nullptr;
+
+    static bool fail(const char* path) {
+        fprintf(stderr, "stagotchi_sim: cannot write %s\n", path);
+        return false;
+    }
+};
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--policy NAME|all] [--runs N] [--seed S] [--threads T]\n"
+            "          [--start-hour H] [--max-days D] [--out FILE.scol] [--csv FILE]\n"
+            "  policies: perfect lazy night random replay:FILE (repeatable)\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> specs;
+    uint64_t runs = 100000;
+    uint64_t seed = 1;
+    unsigned threads = std::thread::hardware_concurrency();
+    SimOptions opt;
+    const char* colPath = nullptr;
+    const char* csvPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            std::string s = argv[++i];
+            if (s == "all") {
+                for (int p = 0; p < BUILTIN_POLICY_COUNT; p++) specs.push_back(BUILTIN_POLICIES[p]);
+            } else {
+                specs.push_back(s);
+            }
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--start-hour") == 0 && i + 1 < argc) {
+            opt.startHour = (uint8_t)(atoi(argv[++i]) % 24);
+        } else if (strcmp(argv[i], "--max-days") == 0 && i + 1 < argc) {
+            int d = atoi(argv[++i]);
+            opt.maxDays = (uint16_t)(d < 1 ? 1 : d > 45 ? 45 : d);  // millis() wraps at 49 days
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            colPath = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (specs.empty()) specs.push_back("perfect");
+
+    std::vector<std::unique_ptr<CarePolicy>> policies;
+    for (const auto& s : specs) {
+        std::string error;
+        auto p = makePolicy(s, error);
+        if (!p) {
+            fprintf(stderr, "stagotchi_sim: %s\n", error.c_str());
+            return 2;
+        }
+        policies.push_back(std::move(p));
+    }
+
+    RowOutput rows;
+    if (!rows.open(colPath, csvPath)) return 1;
+
+    WorkStealingPool pool(threads);
+    fprintf(stdout, "seed %llu, %llu lives per policy, %u threads, eggs laid at %02u:00\n\n",
+            (unsigned long long)seed, (unsigned long long)runs, pool.threads(), opt.startHour);
+
+    for (const auto& policy : policies) {
+        std::vector<OutcomeStats> perWorker(pool.threads(), OutcomeStats(opt.maxDays));
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<LifeOutcome> batch(rows.active() ? std::min(runs, ROW_BATCH) : 0);
+        for (uint64_t first = 0; first < runs;) {
+            uint64_t count = rows.active() ? std::min(runs - first, ROW_BATCH) : runs;
+            pool.run(count, 256, [&](unsigned worker, uint64_t begin, uint64_t end) {
+                OutcomeStats& stats = perWorker[worker];
+                for (uint64_t i = begin; i < end; i++) {
+                    LifeOutcome o = runLifecycle(*policy, runSeed(seed, first + i), opt);
+                    stats.add(o);
+                    if (rows.active()) batch[i] = o;
+                }
+            });
+            for (uint64_t i = 0; rows.active() && i < count; i++) {
+                rows.add(runSeed(seed, first + i), policy->name(), batch[i]);
+            }
+            first += count;
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        OutcomeStats total(opt.maxDays);
+        for (const auto& s : perWorker) total.merge(s);
+        total.print(stdout, policy->name());
+        fprintf(stdout, "  %.2f s, %.0f lives/s\n\n", secs, secs > 0 ? runs / secs : 0.0);
+        fflush(stdout);
+    }
+    return rows.close() ? 0 : 1;
+}
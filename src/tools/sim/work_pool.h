@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs fn(worker, begin, end) over [0, count) on a fixed set of threads.
+// The range is cut into chunks dealt round-robin onto one deque per
+// worker. A worker takes its own newest chunk and, once its deque is
+// empty, steals the oldest chunk of another worker, so lives of very
+// different length (dead on day 1 vs a full week) still balance out
+// without every thread contending on one shared queue.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads)
+        : _threads(threads > 0 ? threads : 1), _queues(new Queue[_threads]) {}
+
+    unsigned threads() const { return _threads; }
+
+    template <typename Fn>
+    void run(uint64_t count, uint32_t chunk, Fn fn) {
+        if (chunk == 0) chunk = 1;
+        unsigned w = 0;
+        for (uint64_t b = 0; b < count; b += chunk) {
+            uint64_t e = (count - b < chunk) ? count : b + chunk;
+            _queues[w].ranges.push_back({b, e});
+            w = (w + 1) % _threads;
+        }
+
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < _threads; i++) {
+            pool.emplace_back([this, i, &fn] { work(i, fn); });
+        }
+        work(0, fn);
+        for (auto& t : pool) t.join();
+    }
+
+private:
+    struct Range {
+        uint64_t begin, end;
+    };
+    struct Queue {
+        std::mutex        lock;
+        std::deque<Range> ranges;
+    };
+
+    unsigned                 _threads;
+    std::unique_ptr<Queue[]> _queues;
+
+    bool popOwn(unsigned self, Range& r) {
+        Queue& q = _queues[self];
+        std::lock_guard<std::mutex> g(q.lock);
+        if (q.ranges.empty()) return false;
+        r = q.ranges.back();
+        q.ranges.pop_back();
+        return true;
+    }
+
+    bool steal(unsigned self, Range& r) {
+        for (unsigned k = 1; k < _threads; k++) {
+            Queue& q = _queues[(self + k) % _threads];
+            std::lock_guard<std::mutex> g(q.lock);
+            if (q.ranges.empty()) continue;
+            r = q.ranges.front();
+            q.ranges.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    template <typename Fn>
+    void work(unsigned self, Fn& fn) {
+        // No task creates more work, so every deque empty means done
+        Range r;
+        while (popOwn(self, r) || steal(self, r)) {
+            fn(self, r.begin, r.end);
+        }
+    }
+};
@@ -0,0 +1,225 @@
+#include "sweep.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+const char* const CHARACTER_NAMES[] = {
+    "NONE", "EGG", "BABY_CHAN", "CHIBI_STACK", "STACK_JR", "DANBOARD_CHAN", "AI_STACK",
+    "ROSTACK", "TAKAO", "REXXCHAN", "PROPELLA", "DK_ATOM", "SO_ARM", "GHOST",
+};
+static_assert(sizeof(CHARACTER_NAMES) / sizeof(CHARACTER_NAMES[0]) ==
+              static_cast<size_t>(CharacterID::CHARACTER_COUNT),
+              "CHARACTER_NAMES needs one entry per CharacterID");
+
+struct FieldName {
+    const char*       name;
+    SweepParam::Field field;
+};
+
+const FieldName FIELD_NAMES[] = {
+    {"hunger",      SweepParam::HUNGER},
+    {"happy",       SweepParam::HAPPY},
+    {"poop",        SweepParam::POOP},
+    {"poop_young",  SweepParam::POOP_YOUNG},
+    {"care_window", SweepParam::CARE_WINDOW},
+    {"discipline",  SweepParam::DISCIPLINE},
+    {"hunger_mul",  SweepParam::HUNGER_MUL},
+    {"happy_mul",   SweepParam::HAPPY_MUL},
+};
+
+// "lo:hi" or "lo:hi:steps"
+bool parseRange(const std::string& s, double& lo, double& hi, int& steps) {
+    char* end;
+    lo = strtod(s.c_str(), &end);
+    if (*end != ':') return false;
+    hi = strtod(end + 1, &end);
+    if (*end == ':') {
+        steps = (int)strtol(end + 1, &end, 10);
+        if (steps < 1) return false;
+    }
+    return *end == '\0' && lo <= hi;
+}
+
+}  // namespace
+
+bool characterByName(const std::string& name, CharacterID& out) {
+    for (int i = 0; i < static_cast<int>(CharacterID::CHARACTER_COUNT); i++) {
+        if (name == CHARACTER_NAMES[i]) {
+            out = static_cast<CharacterID>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* characterName(CharacterID id) {
+    return CHARACTER_NAMES[static_cast<int>(id)];
+}
+
+// ===== Parameters =====
+
+bool SweepParam::parse(const std::string& text, std::string& error) {
+    spec = text;
+    size_t eq = text.find('=');
+    if (eq == std::string::npos) {
+        error = "expected NAME=LO:HI[:STEPS] in '" + text + "'";
+        return false;
+    }
+    std::string name = text.substr(0, eq);
+    std::string who;
+    size_t dot = name.find('.');
+    if (dot != std::string::npos) {
+        who = name.substr(dot + 1);
+        name = name.substr(0, dot);
+    }
+
+    bool known = false;
+    for (const auto& f : FIELD_NAMES) {
+        if (name == f.name) {
+            field = f.field;
+            known = true;
+        }
+    }
+    if (!known) {
+        error = "unknown parameter '" + name + "'";
+        return false;
+    }
+    bool perCharacter = field == HUNGER_MUL || field == HAPPY_MUL;
+    if (perCharacter) {
+        CharacterID id;
+        if (who == "all") {
+            character = -1;
+        } else if (characterByName(who, id)) {
+            character = static_cast<int>(id);
+        } else {
+            error = "'" + name + "' needs .all or .<CHARACTER>, got '" + who + "'";
+            return false;
+        }
+    } else if (!who.empty()) {
+        error = "'" + name + "' is not per character";
+        return false;
+    }
+
+    if (!parseRange(text.substr(eq + 1), lo, hi, steps) || lo <= 0 ||
+        (perCharacter && hi > 255)) {
+        error = "bad range in '" + text + "'";
+        return false;
+    }
+    return true;
+}
+
+void SweepParam::apply(double value, GameRules& rules) const {
+    unsigned long ms = (unsigned long)std::lround(value * 60.0) * 1000UL;
+    if (ms == 0) ms = 1000;
+    uint8_t mul = (uint8_t)std::max(1L, std::min(255L, std::lround(value)));
+    switch (field) {
+        case HUNGER:      rules.hungerDecayMs = ms; break;
+        case HAPPY:       rules.happyDecayMs = ms; break;
+        case POOP:        rules.poopIntervalMs = ms; break;
+        case POOP_YOUNG:  rules.poopIntervalYoungMs = ms; break;
+        case CARE_WINDOW: rules.careWindowMs = ms; break;
+        case DISCIPLINE:  rules.disciplineIntervalMs = ms; break;
+        case HUNGER_MUL:
+        case HAPPY_MUL: {
+            uint8_t* muls = field == HUNGER_MUL ? rules.hungerDecayMul : rules.happyDecayMul;
+            for (int c = 0; c < GameRules::CHARS; c++) {
+                if (character < 0 || character == c) muls[c] = mul;
+            }
+            break;
+        }
+    }
+}
+
+// ===== Targets =====
+
+bool SweepTarget::parse(const std::string& text, std::string& error) {
+    spec = text;
+    size_t eq = text.find('=');
+    char* end = nullptr;
+    if (eq != std::string::npos) goal = strtod(text.c_str() + eq + 1, &end);
+    if (eq == std::string::npos || end == text.c_str() + eq + 1 || *end != '\0') {
+        error = "expected METRIC=VALUE in '" + text + "'";
+        return false;
+    }
+    metric = text.substr(0, eq);
+    if (metric.compare(0, 6, "reach.") == 0) {
+        if (!characterByName(metric.substr(6), character)) {
+            error = "unknown character in '" + metric + "'";
+            return false;
+        }
+        metric = "reach";
+        return true;
+    }
+    if (metric == "median_days" || metric == "mean_days" || metric == "old_age" ||
+        metric == "mistakes") {
+        return true;
+    }
+    error = "unknown metric '" + metric + "'";
+    return false;
+}
+
+double SweepTarget::value(const OutcomeStats& s) const {
+    if (metric == "median_days") return s.ageQuantile(0.5) / 24.0;
+    if (metric == "mean_days")   return s.meanAge() / 24.0;
+    if (metric == "old_age")     return s.deathRate(2);
+    if (metric == "mistakes")    return s.meanCareMistakes();
+    return s.reachedRate(character);
+}
+
+double SweepTarget::error(const OutcomeStats& s) const {
+    double miss = std::fabs(value(s) - goal);
+    return goal != 0 ? miss / std::fabs(goal) : miss;
+}
+
+// ===== Sampling =====
+
+std::vector<std::vector<double>> gridSamples(const std::vector<SweepParam>& params) {
+    std::vector<std::vector<double>> rows(1);
+    for (const auto& p : params) {
+        std::vector<std::vector<double>> next;
+        for (const auto& row : rows) {
+            for (int k = 0; k < p.steps; k++) {
+                double v = p.steps == 1 ? p.lo : p.lo + (p.hi - p.lo) * k / (p.steps - 1);
+                next.push_back(row);
+                next.back().push_back(v);
+            }
+        }
+        rows.swap(next);
+    }
+    return rows;
+}
+
+std::vector<std::vector<double>> latinHypercube(const std::vector<SweepParam>& params,
+                                                int count, Rng& rng) {
+    // Every parameter's range is cut into `count` strata and each stratum
+    // is used exactly once, in an independent random order per parameter
+    std::vector<std::vector<double>> rows(count, std::vector<double>(params.size()));
+    std::vector<int> order(count);
+    for (size_t d = 0; d < params.size(); d++) {
+        for (int i = 0; i < count; i++) order[i] = i;
+        for (int i = count - 1; i > 0; i--) std::swap(order[i], order[rng.below(i + 1)]);
+        for (int i = 0; i < count; i++) {
+            double u = (order[i] + (rng.next() + 0.5) / 4294967296.0) / count;
+            rows[i][d] = params[d].lo + (params[d].hi - params[d].lo) * u;
+        }
+    }
+    return rows;
+}
+
+std::vector<bool> paretoFront(const std::vector<std::vector<double>>& errors) {
+    std::vector<bool> front(errors.size(), true);
+    for (size_t i = 0; i < errors.size(); i++) {
+        for (size_t j = 0; j < errors.size() && front[i]; j++) {
+            if (i == j) continue;
+            bool noWorse = true, better = false;
+            for (size_t k = 0; k < errors[i].size(); k++) {
+                if (errors[j][k] > errors[i][k]) noWorse = false;
+                if (errors[j][k] < errors[i][k]) better = true;
+            }
+            if (noWorse && better) front[i] = false;
+        }
+    }
+    return front;
+}
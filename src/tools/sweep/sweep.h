@@ -0,0 +1,50 @@
+#pragma once
+#include "lifecycle.h"
+#include "rules.h"
+#include "rng.h"
+#include <string>
+#include <vector>
+
+// One GameRules field to vary, from a spec like "hunger=40:90:6"
+// (minutes, lo:hi[:grid steps]) or "hunger_mul.STACK_JR=8:20" (x10).
+struct SweepParam {
+    enum Field : uint8_t {
+        HUNGER, HAPPY, POOP, POOP_YOUNG, CARE_WINDOW, DISCIPLINE,  // minutes
+        HUNGER_MUL, HAPPY_MUL,                                     // x10 per character
+    };
+    std::string spec;
+    Field    field;
+    int      character = -1;  // CharacterID for *_MUL, -1 = every character
+    double   lo = 0, hi = 0;
+    int      steps = 3;
+
+    bool parse(const std::string& text, std::string& error);
+    void apply(double value, GameRules& rules) const;
+};
+
+// A metric and the value it should have, e.g. "median_days=5" or
+// "reach.AI_STACK=0.10". Metrics: median_days, mean_days, old_age,
+// mistakes, reach.<CHARACTER>.
+struct SweepTarget {
+    std::string spec;
+    std::string metric;
+    CharacterID character = CharacterID::NONE;
+    double      goal = 0;
+
+    bool   parse(const std::string& text, std::string& error);
+    double value(const OutcomeStats& s) const;
+    // Relative miss (absolute when the goal is 0); lower is better
+    double error(const OutcomeStats& s) const;
+};
+
+// Parameter values per configuration
+std::vector<std::vector<double>> gridSamples(const std::vector<SweepParam>& params);
+std::vector<std::vector<double>> latinHypercube(const std::vector<SweepParam>& params,
+                                                int count, Rng& rng);
+
+// Rows no other row beats on every column (all minimized)
+std::vector<bool> paretoFront(const std::vector<std::vector<double>>& errors);
+
+// CharacterID from its enum name ("AI_STACK"); false if unknown
+bool characterByName(const std::string& name, CharacterID& out);
+const char* characterName(CharacterID id);
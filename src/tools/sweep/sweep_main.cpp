@@ -0,0 +1,179 @@
+// =============================================
+//  Balance sweep (sweep env)
+//  Simulates many GameRules variants under one care policy, scores each
+//  against target metrics and prints the Pareto front.
+// =============================================
+
+#include "sweep.h"
+#include "work_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s --param NAME=LO:HI[:STEPS] ... --target METRIC=VALUE ...\n"
+            "          [--lhs N] [--policy NAME] [--runs N] [--seed S] [--threads T]\n"
+            "          [--start-hour H] [--csv FILE]\n"
+            "  params (minutes): hunger happy poop poop_young care_window discipline\n"
+            "  params (x10):     hunger_mul.<CHARACTER|all> happy_mul.<CHARACTER|all>\n"
+            "  metrics:          median_days mean_days old_age mistakes reach.<CHARACTER>\n"
+            "  default is a grid over STEPS (3) values per param; --lhs samples N instead\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    std::vector<SweepParam>  params;
+    std::vector<SweepTarget> targets;
+    std::string policySpec = "random";
+    const char* csvPath = nullptr;
+    int lhs = 0;
+    uint64_t runs = 2000;
+    uint64_t seed = 1;
+    unsigned threads = std::thread::hardware_concurrency();
+    SimOptions opt;
+    std::string error;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--param") == 0 && i + 1 < argc) {
+            params.emplace_back();
+            if (!params.back().parse(argv[++i], error)) break;
+        } else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            targets.emplace_back();
+            if (!targets.back().parse(argv[++i], error)) break;
+        } else if (strcmp(argv[i], "--lhs") == 0 && i + 1 < argc) {
+            lhs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            policySpec = argv[++i];
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--start-hour") == 0 && i + 1 < argc) {
+            opt.startHour = (uint8_t)(atoi(argv[++i]) % 24);
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (error.empty() && (params.empty() || targets.empty())) error = "need at least one --param and one --target";
+    auto policy = error.empty() ? makePolicy(policySpec, error) : nullptr;
+    if (!policy) {
+        fprintf(stderr, "stagotchi_sweep: %s\n", error.c_str());
+        return 2;
+    }
+
+    // Row 0 is always the shipped config.h balance. The grid's size is
+    // checked before it is built: its rows multiply.
+    const uint64_t maxConfigs = 100000;
+    uint64_t rows = 1;
+    if (lhs > 0) {
+        rows += (uint64_t)lhs;
+    } else {
+        uint64_t grid = 1;
+        for (const auto& p : params) {
+            grid *= (uint64_t)p.steps;
+            if (grid > maxConfigs) break;  // no overflow: steps fit an int
+        }
+        rows += grid;
+    }
+    if (rows > maxConfigs) {
+        fprintf(stderr, "stagotchi_sweep: more than %llu configurations is too many\n",
+                (unsigned long long)maxConfigs);
+        return 2;
+    }
+    Rng sampler;
+    sampler.seed((uint32_t)seed);
+    std::vector<std::vector<double>> samples =
+        lhs > 0 ? latinHypercube(params, lhs, sampler) : gridSamples(params);
+    std::vector<GameRules> configs(samples.size() + 1);
+    for (size_t c = 0; c < samples.size(); c++) {
+        for (size_t d = 0; d < params.size(); d++) params[d].apply(samples[c][d], configs[c + 1]);
+    }
+
+    // Every configuration sees the same seeds, so differences between rows
+    // come from the rules and not from luck. Work is split into blocks of
+    // runs so a small sweep still uses every core.
+    const uint64_t blockRuns = 512;
+    const uint64_t blocks = (runs + blockRuns - 1) / blockRuns;
+    std::vector<OutcomeStats> results(configs.size(), OutcomeStats(opt.maxDays));
+    std::unique_ptr<std::mutex[]> locks(new std::mutex[configs.size()]);
+
+    WorkStealingPool pool(threads);
+    fprintf(stderr, "%zu configurations x %llu lives (%s), %u threads\n", configs.size(),
+            (unsigned long long)runs, policy->name(), pool.threads());
+    auto t0 = std::chrono::steady_clock::now();
+    pool.run(configs.size() * blocks, 1, [&](unsigned, uint64_t begin, uint64_t end) {
+        for (uint64_t task = begin; task < end; task++) {
+            size_t c = task / blocks;
+            uint64_t first = (task % blocks) * blockRuns;
+            uint64_t last = std::min(runs, first + blockRuns);
+            SimOptions o = opt;
+            o.rules = &configs[c];
+            OutcomeStats local(opt.maxDays);
+            for (uint64_t i = first; i < last; i++) {
+                local.add(runLifecycle(*policy, runSeed(seed, i), o));
+            }
+            std::lock_guard<std::mutex> g(locks[c]);
+            results[c].merge(local);
+        }
+    });
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::vector<std::vector<double>> errors(configs.size());
+    std::vector<double> total(configs.size(), 0);
+    for (size_t c = 0; c < configs.size(); c++) {
+        for (const auto& t : targets) {
+            errors[c].push_back(t.error(results[c]));
+            total[c] += errors[c].back();
+        }
+    }
+    std::vector<bool> front = paretoFront(errors);
+
+    auto printRow = [&](FILE* f, size_t c, const char* sep) {
+        fprintf(f, "%zu", c);
+        for (size_t d = 0; d < params.size(); d++) {
+            if (c == 0) fprintf(f, "%s%s", sep, "base");
+            else fprintf(f, "%s%.1f", sep, samples[c - 1][d]);
+        }
+        for (const auto& t : targets) fprintf(f, "%s%.3f", sep, t.value(results[c]));
+        fprintf(f, "%s%.3f%s%d\n", sep, total[c], sep, front[c] ? 1 : 0);
+    };
+    auto printHeader = [&](FILE* f, const char* sep) {
+        fprintf(f, "config");
+        for (const auto& p : params) fprintf(f, "%s%s", sep, p.spec.substr(0, p.spec.find('=')).c_str());
+        for (const auto& t : targets) fprintf(f, "%s%s", sep, t.spec.c_str());
+        fprintf(f, "%sscore%spareto\n", sep, sep);
+    };
+
+    if (csvPath) {
+        FILE* f = fopen(csvPath, "w");
+        if (!f) {
+            fprintf(stderr, "stagotchi_sweep: cannot write %s\n", csvPath);
+            return 1;
+        }
+        printHeader(f, ",");
+        for (size_t c = 0; c < configs.size(); c++) printRow(f, c, ",");
+        fclose(f);
+    }
+
+    // Front, best total miss first, with the shipped balance for reference
+    std::vector<size_t> order;
+    for (size_t c = 0; c < configs.size(); c++) {
+        if (front[c] || c == 0) order.push_back(c);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return total[a] < total[b]; });
+    printf("Pareto front (%zu of %zu configurations, score = summed relative miss):\n",
+           std::count(front.begin(), front.end(), true), configs.size());
+    printHeader(stdout, "\t");
+    for (size_t c : order) printRow(stdout, c, "\t");
+    fprintf(stderr, "%.2f s, %.0f lives/s\n", secs, secs > 0 ? configs.size() * runs / secs : 0.0);
+    return 0;
+}
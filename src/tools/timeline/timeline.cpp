@@ -0,0 +1,280 @@
+#include "timeline.h"
+#include "journal_format.h"
+#include "minigame.h"
+#include "pet_fields.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+constexpr uint8_t STATE_FIELDS = PET_FIELD_COUNT + 8;
+
+// Every LifeState field but ms, in the order the deltas number them
+template <typename State, typename F>
+void forEachStateField(State& s, F&& f) {
+    forEachPetField(s.pet, f);
+    for (auto& word : s.player.s) f(word);
+    f(s.nextCheck);
+    f(s.lastHour);
+    f(s.reached);
+    f(s.finalForm);
+}
+
+void gather(const LifeState& s, uint64_t (&v)[STATE_FIELDS]) {
+    uint8_t i = 0;
+    forEachStateField(s, [&](const auto& field) { v[i++] = (uint64_t)field; });
+}
+
+void scatter(LifeState& s, const uint64_t (&v)[STATE_FIELDS]) {
+    uint8_t i = 0;
+    forEachStateField(s, [&](auto& field) {
+        field = static_cast<std::remove_reference_t<decltype(field)>>(v[i++]);
+    });
+}
+
+uint64_t zigzag64(uint64_t delta) {
+    int64_t d = (int64_t)delta;
+    return ((uint64_t)d << 1) ^ (uint64_t)(d >> 63);
+}
+
+uint64_t unzigzag64(uint64_t z) { return (z >> 1) ^ (0 - (z & 1)); }
+
+}  // namespace
+
+// ===== Timeline =====
+
+Timeline::Timeline(uint32_t keyframeMinutes) : _keyMs((keyframeMinutes ? keyframeMinutes : 1) * 60000UL) {}
+
+void Timeline::clear() {
+    _keys.clear();
+    _deltas.clear();
+    _last = LifeState();
+    _states = 0;
+}
+
+void Timeline::append(const LifeState& s) {
+    if (_keys.empty() || s.ms / _keyMs > _last.ms / _keyMs) {
+        _keys.push_back({s, _deltas.size(), _states});
+        _last = s;
+        _states++;
+        return;
+    }
+
+    uint64_t was[STATE_FIELDS], now[STATE_FIELDS];
+    gather(_last, was);
+    gather(s, now);
+    uint8_t changed = 0;
+    for (uint8_t i = 0; i < STATE_FIELDS; i++) changed += now[i] != was[i];
+    if (changed == 0 && s.ms == _last.ms) return;
+
+    // Worst case: two varints and a 10-byte varint per field
+    uint8_t buf[2 * 5 + STATE_FIELDS * 11];
+    uint8_t* p = journalPutVarint64(buf, (uint64_t)(s.ms - _last.ms));
+    *p++ = changed;
+    for (uint8_t i = 0; i < STATE_FIELDS; i++) {
+        if (now[i] == was[i]) continue;
+        *p++ = i;
+        p = journalPutVarint64(p, zigzag64(now[i] - was[i]));
+    }
+    _deltas.insert(_deltas.end(), buf, p);
+    _last = s;
+    _states++;
+}
+
+long Timeline::keyFor(unsigned long ms) const {
+    auto it = std::upper_bound(_keys.begin(), _keys.end(), ms,
+                               [](unsigned long t, const Keyframe& k) { return t < k.state.ms; });
+    return (long)(it - _keys.begin()) - 1;
+}
+
+size_t Timeline::replay(size_t k, unsigned long ms, LifeState& s, size_t& count) const {
+    size_t end = k + 1 < _keys.size() ? _keys[k + 1].deltaBegin : _deltas.size();
+    const uint8_t* base = _deltas.data();
+    const uint8_t* p = base + _keys[k].deltaBegin;
+    uint64_t v[STATE_FIELDS];
+    gather(s, v);
+    count = 1;
+    while (p < base + end) {
+        uint64_t dt;
+        const uint8_t* q = journalGetVarint(p, base + end, dt);
+        if (s.ms + dt > ms) break;
+        uint8_t changed = *q++;
+        for (uint8_t n = 0; n < changed; n++) {
+            uint8_t i = *q++;
+            uint64_t z;
+            q = journalGetVarint(q, base + end, z);
+            v[i] += unzigzag64(z);
+        }
+        s.ms += (unsigned long)dt;
+        p = q;
+        count++;
+    }
+    scatter(s, v);
+    return (size_t)(p - base);
+}
+
+bool Timeline::seek(unsigned long ms, LifeState& out) const {
+    long k = keyFor(ms);
+    if (k < 0) return false;
+    out = _keys[k].state;
+    size_t count;
+    replay((size_t)k, ms, out, count);
+    return true;
+}
+
+bool Timeline::truncate(unsigned long ms, LifeState& out) {
+    long k = keyFor(ms);
+    if (k < 0) return false;
+    out = _keys[k].state;
+    size_t count;
+    _deltas.resize(replay((size_t)k, ms, out, count));
+    _keys.resize((size_t)k + 1);
+    _states = _keys[k].first + count;
+    _last = out;
+    return true;
+}
+
+Timeline::Memory Timeline::memory() const {
+    Memory m;
+    m.states = _states;
+    m.keyframes = _keys.size();
+    m.keyframeBytes = _keys.size() * sizeof(Keyframe);
+    m.deltaBytes = _deltas.size();
+    m.totalBytes = sizeof(*this) + _keys.capacity() * sizeof(Keyframe) + _deltas.capacity();
+    m.naiveBytes = _states * sizeof(LifeState);
+    return m;
+}
+
+// ===== Recorded lives =====
+
+namespace {
+
+const char* const CHANGE_NAMES[] = {"none", "skip", "feed", "play", "heal", "clean", "scold", "lights"};
+
+// runLifecycle() in resumable form: starts from any captured state and,
+// through liveCheckIns()'s hooks, captures one after every step of the
+// pet and every check-in
+class LifeRunner {
+public:
+    LifeRunner(const CarePolicy& policy, const SimOptions& opt, const LifeState& from, Timeline& tl)
+        : _policy(policy), _opt(opt), _clock(SIM_EPOCH + opt.startHour * 3600UL),
+          _s(from), _session(_pet, _game, _clock, _s.player), _tl(tl) {
+        _game.setClock(&_clock);
+        _pet.setRules(opt.rules);
+        _pet.loadFromSave(from.pet, from.lastHour);
+        _clock.advance(from.ms);
+        _out.reached = from.reached;
+        _out.finalForm = from.finalForm;
+    }
+
+    // Lives until death or the cutoff; change is made at changeMs. On
+    // resume the first update() repeats the captured one and changes nothing.
+    LifeOutcome run(unsigned long changeMs, Change change) {
+        Hooks hooks(*this, changeMs, change);
+        liveCheckIns(_policy, _session, _pet, _clock, _s.player, _s.nextCheck,
+                     _opt.maxDays * 86400000UL, _out, hooks);
+
+        LifeOutcome out;
+        const PetData& p = _pet.data();
+        out.reached = _s.reached;
+        out.finalForm = _s.finalForm;
+        if (p.isDead) out.deathCause = p.deathCause < DEATH_CAUSES ? p.deathCause : 0;
+        out.ageHours = p.age;
+        out.careMistakes = p.totalCareMistakes;
+        return out;
+    }
+
+private:
+    struct Hooks : CheckInHooks {
+        LifeRunner&   r;
+        unsigned long changeMs;
+        Change        change;
+        bool          skip = false;
+
+        Hooks(LifeRunner& runner, unsigned long ms, Change c) : r(runner), changeMs(ms), change(c) {}
+
+        void step() { r.capture(); }
+        unsigned long stopAt() const { return change != Change::NONE ? changeMs : ULONG_MAX; }
+        void stop() {
+            skip = change == Change::SKIP;
+            r.make(change);
+            change = Change::NONE;
+            r.capture();
+        }
+        bool care() {
+            bool answer = !skip;
+            skip = false;
+            return answer;
+        }
+        void checkedIn() { r.capture(); }
+    };
+
+    const CarePolicy& _policy;
+    const SimOptions& _opt;
+    VirtualClock _clock;
+    PetManager   _pet;
+    MiniGame     _game;
+    LifeState    _s;
+    CareSession  _session;
+    Timeline&    _tl;
+    LifeOutcome  _out;  // forms reached, as liveUntil() notes them
+
+    void capture() {
+        _s.ms = _clock.nowMs();
+        _s.pet = _pet.data();
+        _s.lastHour = _pet.lastHour();
+        _s.reached = _out.reached;
+        _s.finalForm = _out.finalForm;
+        _tl.append(_s);
+    }
+
+    void make(Change change) {
+        switch (change) {
+        case Change::FEED:   _session.feed(); break;
+        case Change::PLAY:   _session.cheerUp(true); break;
+        case Change::HEAL:   _session.heal(); break;
+        case Change::CLEAN:  _session.clean(); break;
+        case Change::SCOLD:  _session.scold(); break;
+        case Change::LIGHTS: _pet.toggleLight(); break;
+        default: break;
+        }
+    }
+};
+
+}  // namespace
+
+bool parseChange(const char* name, Change& out) {
+    for (uint8_t i = 0; i < sizeof(CHANGE_NAMES) / sizeof(CHANGE_NAMES[0]); i++) {
+        if (strcmp(name, CHANGE_NAMES[i]) == 0) {
+            out = static_cast<Change>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* changeName(Change c) { return CHANGE_NAMES[static_cast<uint8_t>(c)]; }
+
+LifeOutcome recordLife(const CarePolicy& policy, uint32_t seed, const SimOptions& opt, Timeline& tl) {
+    // The start runLifecycle() makes
+    LifeState s;
+    PetManager pet;
+    pet.setRules(opt.rules);
+    pet.initNewEgg(0, seed);
+    s.pet = pet.data();
+    s.player.seed(seed);
+    s.player.jump();
+    s.reached = 1UL << static_cast<uint8_t>(CharacterID::EGG);
+
+    tl.clear();
+    tl.append(s);
+    return LifeRunner(policy, opt, s, tl).run(0, Change::NONE);
+}
+
+LifeOutcome branchLife(const CarePolicy& policy, const SimOptions& opt, Timeline& tl,
+                       unsigned long atMs, Change change) {
+    LifeState s;
+    if (!tl.truncate(atMs, s)) return LifeOutcome();
+    return LifeRunner(policy, opt, s, tl).run(atMs, change);
+}
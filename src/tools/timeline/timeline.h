@@ -0,0 +1,90 @@
+#pragma once
+#include "lifecycle.h"
+#include "pet.h"
+#include "rng.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Everything needed to resume a simulated life at one instant
+struct LifeState {
+    unsigned long ms        = 0;     // game time since the egg was laid
+    PetData       pet;
+    uint8_t       lastHour  = 0xFF;  // PetManager::lastHour()
+    Rng           player;            // the care policy's stream
+    uint32_t      nextCheck = 0;     // wall second of the coming check-in (0: not drawn yet)
+    uint32_t      reached   = 0;     // LifeOutcome so far
+    CharacterID   finalForm = CharacterID::EGG;
+};
+
+// One life as a sequence of LifeStates, seekable by game time. Every
+// keyframeMinutes of game time starts a keyframe holding a whole state;
+// the states in between are stored as the fields that changed since the
+// one before. seek() binary-searches the keyframes and replays at most
+// one interval of deltas, so it costs O(log n) plus a bounded walk, and
+// memory grows with what happened rather than with how often the life
+// was sampled.
+//
+// Delta: varint ms delta, varint field count, then per field a byte index
+//        (LifeState field order) and varint zigzag(new - old)
+class Timeline {
+public:
+    explicit Timeline(uint32_t keyframeMinutes = 60);
+
+    void clear();
+    // ms must not go backwards; a state equal to the last one is dropped
+    void append(const LifeState& s);
+
+    size_t states() const { return _states; }
+    bool empty() const { return _keys.empty(); }
+    const LifeState& last() const { return _last; }
+
+    // Latest state at or before ms; false if the timeline starts later
+    bool seek(unsigned long ms, LifeState& out) const;
+    // Rollback: drops every state after ms and returns the one now last
+    bool truncate(unsigned long ms, LifeState& out);
+
+    struct Memory {
+        size_t states;
+        size_t keyframes;
+        size_t keyframeBytes;  // whole states
+        size_t deltaBytes;
+        size_t totalBytes;     // allocated, including spare capacity
+        size_t naiveBytes;     // one whole LifeState per state, for comparison
+    };
+    Memory memory() const;
+
+private:
+    struct Keyframe {
+        LifeState state;
+        size_t    deltaBegin;  // offset of its first delta
+        size_t    first;       // index of its state in the life
+    };
+
+    unsigned long         _keyMs;
+    std::vector<Keyframe> _keys;
+    std::vector<uint8_t>  _deltas;
+    LifeState             _last;
+    size_t                _states = 0;
+
+    // Keyframe holding ms, or -1 if ms is before the first
+    long keyFor(unsigned long ms) const;
+    // Applies keyframe k's deltas up to ms to s (which starts as the
+    // keyframe); returns the offset it stopped at and the states it passed
+    size_t replay(size_t k, unsigned long ms, LifeState& s, size_t& count) const;
+};
+
+// What a branch changes at the moment it starts
+enum class Change : uint8_t { NONE, SKIP, FEED, PLAY, HEAL, CLEAN, SCOLD, LIGHTS };
+bool parseChange(const char* name, Change& out);
+const char* changeName(Change c);
+
+// A whole life under a policy, recorded into tl (cleared first). The
+// outcome is the one runLifecycle() gives for the same seed.
+LifeOutcome recordLife(const CarePolicy& policy, uint32_t seed, const SimOptions& opt, Timeline& tl);
+
+// Rolls tl back to atMs, makes the change there and lives on, recording
+// the branch in place of the old future. States resume exactly, so
+// Change::NONE reproduces the original life.
+LifeOutcome branchLife(const CarePolicy& policy, const SimOptions& opt, Timeline& tl,
+                       unsigned long atMs, Change change);
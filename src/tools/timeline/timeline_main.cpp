@@ -0,0 +1,147 @@
+// =============================================
+//  Life timeline (timeline env)
+//  Records one simulated life as keyframes plus deltas, seeks into it by
+//  game time and re-lives it from any point with one thing done
+//  differently, then reports what changed and what the timeline costs.
+// =============================================
+
+#include "timeline.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--policy NAME] [--seed N] [--start-hour H] [--max-days D]\n"
+            "          [--keyframe-min M] [--at HOURS] [--branch HOURS:ACTION] [--bench N]\n"
+            "  ACTION: none skip feed play heal clean scold lights\n",
+            argv0);
+}
+
+static const char* formName(CharacterID id) { return getCharacterDef(id).nameEN; }
+
+static void printOutcome(const char* title, const LifeOutcome& o) {
+    static const char* const CAUSES[DEATH_CAUSES + 1] = {"hunger", "sickness", "old age", "alive at cutoff"};
+    printf("%-9s %-16s %-16s age %4u h  care mistakes %3u\n", title, formName(o.finalForm),
+           CAUSES[o.deathCause], o.ageHours, o.careMistakes);
+}
+
+static void printState(const LifeState& s) {
+    const PetData& p = s.pet;
+    printf("at %.2f h: %s, hunger %u happy %u discipline %u weight %u poop %u%s%s%s, care mistakes %u\n",
+           s.ms / 3600000.0, formName(p.characterId), p.hunger, p.happiness, p.discipline, p.weight,
+           p.poopCount, p.isSick ? ", sick" : "", p.isAsleep ? ", asleep" : "", p.isDead ? ", dead" : "",
+           p.totalCareMistakes);
+}
+
+static bool sameOutcome(const LifeOutcome& a, const LifeOutcome& b) {
+    return a.reached == b.reached && a.finalForm == b.finalForm && a.deathCause == b.deathCause &&
+           a.ageHours == b.ageHours && a.careMistakes == b.careMistakes;
+}
+
+int main(int argc, char** argv) {
+    std::string spec = "perfect";
+    uint32_t seed = 1;
+    uint32_t keyframeMin = 60;
+    SimOptions opt;
+    double atHours = -1, branchHours = -1;
+    Change change = Change::NONE;
+    long bench = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            spec = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--start-hour") == 0 && i + 1 < argc) {
+            opt.startHour = (uint8_t)(atoi(argv[++i]) % 24);
+        } else if (strcmp(argv[i], "--max-days") == 0 && i + 1 < argc) {
+            int d = atoi(argv[++i]);
+            opt.maxDays = (uint16_t)(d < 1 ? 1 : d > 45 ? 45 : d);  // millis() wraps at 49 days
+        } else if (strcmp(argv[i], "--keyframe-min") == 0 && i + 1 < argc) {
+            int m = atoi(argv[++i]);
+            keyframeMin = (uint32_t)(m < 1 ? 1 : m);
+        } else if (strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+            atHours = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--branch") == 0 && i + 1 < argc) {
+            const char* arg = argv[++i];
+            const char* colon = strchr(arg, ':');
+            branchHours = atof(arg);
+            if (!colon || !parseChange(colon + 1, change) || branchHours < 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            bench = atol(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::string error;
+    auto policy = makePolicy(spec, error);
+    if (!policy) {
+        fprintf(stderr, "stagotchi_timeline: %s\n", error.c_str());
+        return 2;
+    }
+
+    Timeline tl(keyframeMin);
+    auto t0 = std::chrono::steady_clock::now();
+    LifeOutcome life = recordLife(*policy, seed, opt, tl);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    // The recording must be the same life the sim lives
+    bool matches = sameOutcome(life, runLifecycle(*policy, seed, opt));
+    printf("policy %s, seed %u, %zu states recorded in %.1f ms%s\n", policy->name(), seed, tl.states(),
+           secs * 1e3, matches ? "" : "  ** differs from the sim **");
+    printOutcome("life", life);
+
+    Timeline::Memory m = tl.memory();
+    printf("\nmemory, keyframe every %u min\n", keyframeMin);
+    printf("  keyframes  %6zu x %zu B = %8zu B\n", m.keyframes,
+           m.keyframes ? m.keyframeBytes / m.keyframes : 0, m.keyframeBytes);
+    printf("  deltas     %6zu      %8zu B  (%.1f B each)\n", m.states - m.keyframes, m.deltaBytes,
+           m.states > m.keyframes ? (double)m.deltaBytes / (m.states - m.keyframes) : 0.0);
+    printf("  allocated              %8zu B\n", m.totalBytes);
+    printf("  every state whole      %8zu B  (%.1fx)\n", m.naiveBytes,
+           m.totalBytes ? (double)m.naiveBytes / m.totalBytes : 0.0);
+
+    if (atHours >= 0) {
+        LifeState s;
+        printf("\n");
+        if (tl.seek((unsigned long)(atHours * 3600000.0), s)) printState(s);
+    }
+
+    if (bench > 0) {
+        // Random seeks over the whole life
+        unsigned long span = tl.last().ms + 1;
+        Rng rng;
+        rng.seed(seed);
+        LifeState s;
+        uint64_t sink = 0;
+        auto b0 = std::chrono::steady_clock::now();
+        for (long i = 0; i < bench; i++) {
+            tl.seek((unsigned long)(((uint64_t)rng.next() << 32 | rng.next()) % span), s);
+            sink += s.pet.hunger;
+        }
+        double bs = std::chrono::duration<double>(std::chrono::steady_clock::now() - b0).count();
+        printf("\n%ld random seeks: %.0f ns each (%llu)\n", bench, bs * 1e9 / bench, (unsigned long long)(sink & 1));
+    }
+
+    if (branchHours >= 0) {
+        unsigned long atMs = (unsigned long)(branchHours * 3600000.0);
+        LifeState s;
+        if (!tl.seek(atMs, s)) return 1;
+        printf("\nbranch: %s at %.2f h\n", changeName(change), branchHours);
+        printState(s);
+        auto b0 = std::chrono::steady_clock::now();
+        LifeOutcome branch = branchLife(*policy, opt, tl, atMs, change);
+        double bs = std::chrono::duration<double>(std::chrono::steady_clock::now() - b0).count();
+        printOutcome("original", life);
+        printOutcome("branch", branch);
+        printf("%s; re-lived in %.1f ms, %zu states now\n",
+               sameOutcome(life, branch) ? "same outcome" : "outcome changed", bs * 1e3, tl.states());
+    }
+    return matches ? 0 : 1;
+}
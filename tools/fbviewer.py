@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""Host viewer for the `stream on` serial framebuffer stream.
+
+Decodes the XOR/RLE row deltas sent by FrameStreamer (include/frame_stream.h)
+and saves completed frames as PNG.
+
+    python tools/fbviewer.py COM4 --out frames/          # live from the device
+    python tools/fbviewer.py --file capture.bin --out frames/
+
+Live mode needs pyserial (pip install pyserial). Everything else is stdlib.
+"""
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"\xa5\x5a"
+FRAME_END = 0xFF
+
+
+def rgb332_palette():
+    pal = []
+    for v in range(256):
+        r = ((v >> 5) & 7) * 255 // 7
+        g = ((v >> 2) & 7) * 255 // 7
+        b = (v & 3) * 255 // 3
+        pal.append(bytes((r, g, b)))
+    return pal
+
+
+PALETTE = rgb332_palette()
+
+
+def write_png(path, w, h, pixels):
+    raw = bytearray()
+    for y in range(h):
+        raw.append(0)  # filter: none
+        raw += b"".join(PALETTE[p] for p in pixels[y * w:(y + 1) * w])
+
+    def chunk(tag, data):
+        c = struct.pack(">I", len(data)) + tag + data
+        return c + struct.pack(">I", zlib.crc32(tag + data) & 0xFFFFFFFF)
+
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", w, h, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(bytes(raw), 6)))
+        f.write(chunk(b"IEND", b""))
+
+
+class DecodeError(Exception):
+    pass
+
+
+class ByteReader:
+    """Pulls bytes from a callable returning chunks (b'' = no data yet)."""
+
+    def __init__(self, read_chunk):
+        self._read_chunk = read_chunk
+        self._buf = b""
+        self._pos = 0
+        self.eof = False
+
+    def byte(self):
+        while self._pos >= len(self._buf):
+            chunk = self._read_chunk()
+            if chunk is None:
+                self.eof = True
+                raise EOFError
+            self._buf, self._pos = chunk, 0
+        b = self._buf[self._pos]
+        self._pos += 1
+        return b
+
+    def bytes(self, n):
+        return bytes(self.byte() for _ in range(n))
+
+
+class StreamDecoder:
+    def __init__(self):
+        self.frame = None
+        self.w = self.h = 0
+
+    def sync(self, rd):
+        """Skip log text until a frame header. Returns (keyframe, seq)."""
+        state = 0
+        while True:
+            b = rd.byte()
+            if state == 0:
+                state = 1 if b == MAGIC[0] else 0
+            elif state == 1:
+                state = 2 if b == MAGIC[1] else (1 if b == MAGIC[0] else 0)
+            else:
+                if b in (ord("F"), ord("K")):
+                    seq = rd.byte()
+                    w, h = struct.unpack("<HH", rd.bytes(4))
+                    return b == ord("K"), seq, w, h
+                state = 1 if b == MAGIC[0] else 0
+
+    def read_frame(self, rd):
+        key, seq, w, h = self.sync(rd)
+        if key or self.frame is None or (w, h) != (self.w, self.h):
+            if not key:
+                raise DecodeError("delta frame without keyframe")
+            self.w, self.h = w, h
+            self.frame = bytearray(w * h)
+        last_row = -1
+        while True:
+            row = rd.byte()
+            if row == FRAME_END:
+                return seq
+            if row <= last_row or row >= h:
+                raise DecodeError("bad row %d after %d" % (row, last_row))
+            last_row = row
+            self.decode_row(rd, row * w)
+
+    def decode_row(self, rd, base):
+        x, w, fb = 0, self.w, self.frame
+        while x < w:
+            t = rd.byte()
+            if t < 0x80:
+                n = t + 1
+            elif t < 0xC0:
+                n = t - 0x7F
+                d = rd.byte()
+                if x + n > w:
+                    raise DecodeError("run overflows row")
+                for i in range(base + x, base + x + n):
+                    fb[i] ^= d
+            else:
+                n = t - 0xBF
+                if x + n > w:
+                    raise DecodeError("literal overflows row")
+                for i in range(base + x, base + x + n):
+                    fb[i] ^= rd.byte()
+            x += n
+        if x != w:
+            raise DecodeError("row length mismatch")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("port", nargs="?", help="serial port (e.g. COM4, /dev/ttyUSB0)")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--file", help="decode a raw capture instead of a port")
+    ap.add_argument("--out", default="frames", help="directory for PNG frames")
+    ap.add_argument("--every", type=int, default=1, help="save every Nth frame")
+    args = ap.parse_args()
+    if not args.port and not args.file:
+        ap.error("need a serial port or --file")
+
+    os.makedirs(args.out, exist_ok=True)
+    ser = None
+    if args.file:
+        f = open(args.file, "rb")
+        rd = ByteReader(lambda: f.read(65536) or None)
+    else:
+        import serial  # pyserial
+        ser = serial.Serial(args.port, args.baud, timeout=0.1)
+        ser.write(b"\nstream on\n")
+        rd = ByteReader(lambda: ser.read(4096))
+
+    dec = StreamDecoder()
+    count, t0 = 0, time.time()
+    try:
+        while True:
+            try:
+                seq = dec.read_frame(rd)
+            except DecodeError as e:
+                print("resync: %s" % e, file=sys.stderr)
+                dec.frame = None
+                if ser:
+                    ser.write(b"stream key\n")
+                continue
+            count += 1
+            if count % args.every == 0:
+                path = os.path.join(args.out, "frame_%06d.png" % count)
+                write_png(path, dec.w, dec.h, dec.frame)
+            rate = count / max(time.time() - t0, 1e-6)
+            print("\rframe %d (seq %d)  %.1f fps" % (count, seq, rate), end="", file=sys.stderr)
+    except (EOFError, KeyboardInterrupt):
+        pass
+    finally:
+        if ser:
+            ser.write(b"stream off\n")
+            ser.close()
+    print("\n%d frames saved to %s" % (count // args.every, args.out), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()